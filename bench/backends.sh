@@ -0,0 +1,43 @@
+#!/bin/sh
+# Backend benchmark: generates a large program of many small loops and
+# compares build time and run time of the C, assembly and ELF backends.
+# Usage: bench/backends.sh [loops] [taco flags]
+
+cd "$(dirname "$0")/.." || exit 1
+LOOPS=${1:-2000}
+[ $# -gt 0 ] && shift
+FLAGS="$*"
+TACO=./taco
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+PROGRAM="$WORK/program.taco"
+{
+    echo "total = 0;"
+    n=0
+    while [ $n -lt "$LOOPS" ]; do
+        echo "i = 0;"
+        echo "while (i < 1000) { total = total + i * $n - (i / 7); i = i + 1; }"
+        echo "if (total > $n) { total = total / 2; } else { total = total + 1; }"
+        n=$((n + 1))
+    done
+    echo "print(total);"
+} > "$PROGRAM"
+
+echo "Program: $LOOPS loops ($(wc -l < "$PROGRAM") lines)  Flags: $FLAGS"
+
+for backend in c asm elf; do
+    start=$(now)
+    $TACO $FLAGS --backend=$backend -o "$WORK/$backend" "$PROGRAM" > /dev/null || exit 1
+    built=$(now)
+    "$WORK/$backend" > "$WORK/$backend.out" || exit 1
+    end=$(now)
+    printf "%-4s backend: build %6d ms, run %6d ms\n" "$backend" "$(ms "$start" "$built")" "$(ms "$built" "$end")"
+done
+
+cmp -s "$WORK/c.out" "$WORK/asm.out" && cmp -s "$WORK/c.out" "$WORK/elf.out" || { echo "Error: outputs differ"; exit 1; }
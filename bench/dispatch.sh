@@ -0,0 +1,56 @@
+#!/bin/sh
+# Interpreter dispatch benchmark: runs a program with the TAC interpreter
+# (--run), the bytecode VM (--emit-tbc + --exec), the JIT (--jit), tiered
+# execution (--tiered), the built-in ELF writer and the gcc backend, and prints the time of each. Usage: bench/dispatch.sh [program.taco] [taco flags]
+
+cd "$(dirname "$0")/.." || exit 1
+PROGRAM=${1:-bench/dispatch.taco}
+[ $# -gt 0 ] && shift
+FLAGS="$* --fuel=0"
+TACO=./taco
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+echo "Program: $PROGRAM  Flags: $FLAGS"
+
+start=$(now)
+$TACO $FLAGS --run "$PROGRAM" > "$WORK/run.out" || exit 1
+end=$(now)
+echo "TAC interpreter (--run):      $(ms "$start" "$end") ms"
+
+$TACO $FLAGS --emit-tbc="$WORK/program.tbc" "$PROGRAM" > /dev/null || exit 1
+start=$(now)
+$TACO --exec "$WORK/program.tbc" > "$WORK/vm.out" || exit 1
+end=$(now)
+echo "Bytecode VM (--exec):         $(ms "$start" "$end") ms"
+
+start=$(now)
+$TACO $FLAGS --jit "$PROGRAM" > "$WORK/jit.out" || exit 1
+end=$(now)
+echo "JIT (--jit):                  $(ms "$start" "$end") ms"
+
+start=$(now)
+$TACO $FLAGS --tiered "$PROGRAM" > "$WORK/tiered.out" || exit 1
+end=$(now)
+echo "Tiered (--tiered):            $(ms "$start" "$end") ms"
+
+start=$(now)
+$TACO $FLAGS --backend=elf -o "$WORK/native" "$PROGRAM" > /dev/null || exit 1
+compiled=$(now)
+"$WORK/native" > "$WORK/elf.out" || exit 1
+end=$(now)
+echo "ELF writer (compile + run):   $(ms "$start" "$end") ms (run $(ms "$compiled" "$end") ms)"
+
+start=$(now)
+$TACO $FLAGS --backend=c -o "$WORK/program" "$PROGRAM" > /dev/null || exit 1
+compiled=$(now)
+"$WORK/program" > "$WORK/gcc.out" || exit 1
+end=$(now)
+echo "gcc backend (compile + run):  $(ms "$start" "$end") ms (run $(ms "$compiled" "$end") ms)"
+
+cmp -s "$WORK/run.out" "$WORK/gcc.out" && cmp -s "$WORK/vm.out" "$WORK/gcc.out" && cmp -s "$WORK/jit.out" "$WORK/gcc.out" && cmp -s "$WORK/tiered.out" "$WORK/gcc.out" && cmp -s "$WORK/elf.out" "$WORK/gcc.out" || { echo "Error: outputs differ"; exit 1; }
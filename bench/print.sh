@@ -0,0 +1,59 @@
+#!/bin/sh
+# Print benchmark: a program that prints many fractional values, run as
+# generated C (buffered print runtime), assembly (printf per value), ELF and
+# JIT. Prints the best of three run times with the output going to a file.
+# Usage: bench/print.sh [values / 4] [taco flags]
+
+cd "$(dirname "$0")/.." || exit 1
+COUNT=${1:-2500000}
+[ $# -gt 0 ] && shift
+FLAGS="$* -O"
+TACO=./taco
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+PROGRAM="$WORK/program.taco"
+cat > "$PROGRAM" <<TACO
+x = 1;
+i = 0;
+while (i < $COUNT) {
+    x = x * 1.0001;
+    print(x);
+    print(1 / x);
+    print(i / 7);
+    print(0 - i * 1234.5678);
+    i = i + 1;
+}
+TACO
+
+echo "Program: $((COUNT * 4)) printed values  Flags: $FLAGS"
+
+best_of_three() {
+    best=
+    for run in 1 2 3; do
+        start=$(now)
+        "$@" > "$WORK/$mode.out" || exit 1
+        end=$(now)
+        time=$(ms "$start" "$end")
+        [ -z "$best" ] || [ "$time" -lt "$best" ] && best=$time
+    done
+}
+
+for mode in c asm elf jit; do
+    if [ $mode = jit ]; then
+        best_of_three $TACO $FLAGS --jit "$PROGRAM"
+    else
+        $TACO $FLAGS --backend=$mode -o "$WORK/$mode" "$PROGRAM" > /dev/null || exit 1
+        best_of_three "$WORK/$mode"
+    fi
+    printf "%-4s run %6d ms\n" "$mode" "$best"
+done
+
+for mode in asm elf jit; do
+    cmp -s "$WORK/c.out" "$WORK/$mode.out" || { echo "Error: $mode output differs"; exit 1; }
+done
@@ -0,0 +1,50 @@
+#!/bin/sh
+# Sharded C benchmark: generates a large program of many small loops and
+# compares the wall-clock build time of one translation unit with builds
+# split into 1, 2, 4 and 8 translation units (--shards) compiled by parallel
+# gcc processes. Speedup from parallelism is bounded by the number of cores.
+# Usage: bench/shards.sh [loops] [taco flags]
+
+cd "$(dirname "$0")/.." || exit 1
+LOOPS=${1:-2000}
+[ $# -gt 0 ] && shift
+FLAGS="$*"
+TACO=./taco
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+PROGRAM="$WORK/program.taco"
+{
+    echo "total = 0;"
+    n=0
+    while [ $n -lt "$LOOPS" ]; do
+        echo "i = 0;"
+        echo "while (i < 1000) { total = total + i * $n - (i / 7); i = i + 1; }"
+        echo "if (total > $n) { total = total / 2; } else { total = total + 1; }"
+        n=$((n + 1))
+    done
+    echo "print(total);"
+} > "$PROGRAM"
+
+echo "Program: $LOOPS loops ($(wc -l < "$PROGRAM") lines)  Flags: $FLAGS  Cores: $(nproc 2>/dev/null || echo ?)"
+
+for shards in 0 1 2 4 8; do
+    SHARDFLAGS=
+    [ "$shards" -gt 0 ] && SHARDFLAGS=--shards=$shards
+    start=$(now)
+    $TACO $FLAGS --backend=c $SHARDFLAGS -o "$WORK/s$shards" "$PROGRAM" > /dev/null || exit 1
+    end=$(now)
+    "$WORK/s$shards" > "$WORK/s$shards.out" || exit 1
+    if [ "$shards" -eq 0 ]; then
+        label="unsharded"
+    else
+        label="$shards shards"
+    fi
+    printf "%-10s build %6d ms\n" "$label" "$(ms "$start" "$end")"
+    cmp -s "$WORK/s0.out" "$WORK/s$shards.out" || { echo "Error: outputs differ"; exit 1; }
+done
@@ -0,0 +1,39 @@
+#!/bin/sh
+# Structured C benchmark: generates C for a program once with if/while/for
+# statements and once with labels and goto (--goto-c), builds both with
+# gcc -O2 and prints the best of three run times of each.
+# Usage: bench/structured.sh [program.taco] [taco flags]
+
+cd "$(dirname "$0")/.." || exit 1
+PROGRAM=${1:-bench/dispatch.taco}
+[ $# -gt 0 ] && shift
+FLAGS="$* --fuel=0"
+TACO=./taco
+CC=${CC:-gcc}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+now() { date +%s%N; }
+ms() { echo $(( ($2 - $1) / 1000000 )); }
+
+echo "Program: $PROGRAM  Flags: $FLAGS  C compiler: $CC -O2"
+
+for mode in structured goto; do
+    MODEFLAGS=
+    [ $mode = goto ] && MODEFLAGS=--goto-c
+    $TACO $FLAGS $MODEFLAGS --c-only -o "$WORK/$mode" "$PROGRAM" > /dev/null || exit 1
+    $CC -O2 -o "$WORK/$mode" "$WORK/$mode.c" -lm || exit 1
+    best=
+    for run in 1 2 3; do
+        start=$(now)
+        "$WORK/$mode" > "$WORK/$mode.out" || exit 1
+        end=$(now)
+        time=$(ms "$start" "$end")
+        [ -z "$best" ] || [ "$time" -lt "$best" ] && best=$time
+    done
+    printf "%-10s C: %6d ms (%s gotos)\n" "$mode" "$best" "$(grep -c 'goto ' "$WORK/$mode.c")"
+done
+
+cmp -s "$WORK/structured.out" "$WORK/goto.out" || { echo "Error: outputs differ"; exit 1; }
@@ -0,0 +1,38 @@
+#ifndef ASMGEN_H
+#define ASMGEN_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "tac.h"
+
+// x86-64 assembly generator (GNU as, AT&T syntax) from TAC. Every name has
+// an 8-byte slot in .bss and every literal one in .rodata; the names used most
+// (weighted by loop depth) live in SSE registers instead. The output is a
+// complete program with a small print runtime, linked by gcc against libc.
+class AsmCodeGenerator
+{
+private:
+    std::unordered_map<std::string, std::string> registers;    // Allocated names
+    std::unordered_map<std::string, size_t> literals;          // Literal to .rodata index
+    std::vector<double> literalValues;
+    std::vector<std::string> names;                            // Names with a .bss slot
+
+    void collectNames(const std::vector<TACInstruction>& tac);
+    void allocateRegisters(const std::vector<TACInstruction>& tac);
+    std::string operand(const std::string& name);
+
+public:
+    // SSE registers available for names (xmm0 and xmm1 are scratch)
+    static const size_t registerCount = 14;
+
+    std::string generate(const std::vector<TACInstruction>& tac);
+    void writeToFile(const std::string& code, const std::string& filename);
+    bool assembleToExecutable(const std::string& asmFilename, const std::string& outputExecutable);
+
+    size_t getNameCount() const { return names.size() + registers.size(); }
+    size_t getRegisterNameCount() const { return registers.size(); }
+};
+
+#endif // ASMGEN_H
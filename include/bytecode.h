@@ -0,0 +1,129 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+// Kind of each operand field of a bytecode instruction
+enum class OperandKind : uint8_t
+{
+    NONE,
+    REGISTER,   // Index into the register file
+    CONSTANT,   // Index into the constant pool
+    TARGET      // Index of the instruction a jump continues at
+};
+
+// Bytecode operations with the kinds of their operands a, b and c. Names
+// ending in K take a constant as last value operand; KSUB and KDIV take it
+// first. J<rel> and JN<rel> are compare-and-branch superinstructions that
+// jump if the relation holds or does not hold.
+#define TACO_BYTECODE_OPERATIONS(X)                 \
+    X(HALT,   NONE,     NONE,     NONE)             \
+    X(MOV,    REGISTER, REGISTER, NONE)             \
+    X(LOADK,  REGISTER, CONSTANT, NONE)             \
+    X(ADD,    REGISTER, REGISTER, REGISTER)         \
+    X(ADDK,   REGISTER, REGISTER, CONSTANT)         \
+    X(SUB,    REGISTER, REGISTER, REGISTER)         \
+    X(SUBK,   REGISTER, REGISTER, CONSTANT)         \
+    X(KSUB,   REGISTER, REGISTER, CONSTANT)         \
+    X(MUL,    REGISTER, REGISTER, REGISTER)         \
+    X(MULK,   REGISTER, REGISTER, CONSTANT)         \
+    X(DIV,    REGISTER, REGISTER, REGISTER)         \
+    X(DIVK,   REGISTER, REGISTER, CONSTANT)         \
+    X(KDIV,   REGISTER, REGISTER, CONSTANT)         \
+    X(LT,     REGISTER, REGISTER, REGISTER)         \
+    X(LTK,    REGISTER, REGISTER, CONSTANT)         \
+    X(LE,     REGISTER, REGISTER, REGISTER)         \
+    X(LEK,    REGISTER, REGISTER, CONSTANT)         \
+    X(GT,     REGISTER, REGISTER, REGISTER)         \
+    X(GTK,    REGISTER, REGISTER, CONSTANT)         \
+    X(GE,     REGISTER, REGISTER, REGISTER)         \
+    X(GEK,    REGISTER, REGISTER, CONSTANT)         \
+    X(EQ,     REGISTER, REGISTER, REGISTER)         \
+    X(EQK,    REGISTER, REGISTER, CONSTANT)         \
+    X(NE,     REGISTER, REGISTER, REGISTER)         \
+    X(NEK,    REGISTER, REGISTER, CONSTANT)         \
+    X(AND,    REGISTER, REGISTER, REGISTER)         \
+    X(OR,     REGISTER, REGISTER, REGISTER)         \
+    X(NOT,    REGISTER, REGISTER, NONE)             \
+    X(JMP,    NONE,     NONE,     TARGET)           \
+    X(JT,     REGISTER, NONE,     TARGET)           \
+    X(JF,     REGISTER, NONE,     TARGET)           \
+    X(JLT,    REGISTER, REGISTER, TARGET)           \
+    X(JLTK,   REGISTER, CONSTANT, TARGET)           \
+    X(JLE,    REGISTER, REGISTER, TARGET)           \
+    X(JLEK,   REGISTER, CONSTANT, TARGET)           \
+    X(JGT,    REGISTER, REGISTER, TARGET)           \
+    X(JGTK,   REGISTER, CONSTANT, TARGET)           \
+    X(JGE,    REGISTER, REGISTER, TARGET)           \
+    X(JGEK,   REGISTER, CONSTANT, TARGET)           \
+    X(JEQ,    REGISTER, REGISTER, TARGET)           \
+    X(JEQK,   REGISTER, CONSTANT, TARGET)           \
+    X(JNE,    REGISTER, REGISTER, TARGET)           \
+    X(JNEK,   REGISTER, CONSTANT, TARGET)           \
+    X(JNLT,   REGISTER, REGISTER, TARGET)           \
+    X(JNLTK,  REGISTER, CONSTANT, TARGET)           \
+    X(JNLE,   REGISTER, REGISTER, TARGET)           \
+    X(JNLEK,  REGISTER, CONSTANT, TARGET)           \
+    X(JNGT,   REGISTER, REGISTER, TARGET)           \
+    X(JNGTK,  REGISTER, CONSTANT, TARGET)           \
+    X(JNGE,   REGISTER, REGISTER, TARGET)           \
+    X(JNGEK,  REGISTER, CONSTANT, TARGET)           \
+    X(PRINT,  REGISTER, NONE,     NONE)             \
+    X(PRINTK, CONSTANT, NONE,     NONE)
+
+enum class BytecodeOp : uint32_t
+{
+#define TACO_BYTECODE_ENUM(name, a, b, c) name,
+    TACO_BYTECODE_OPERATIONS(TACO_BYTECODE_ENUM)
+#undef TACO_BYTECODE_ENUM
+    COUNT
+};
+
+// Fixed-width register instruction: a = b op c, or a jump to c
+struct BytecodeInstruction
+{
+    BytecodeOp op;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+// Register bytecode for a whole program: every name has a register, every
+// literal an entry in the constant pool. Registers start at 0.
+class BytecodeProgram
+{
+private:
+    uint32_t registerCount;
+    std::vector<double> constants;
+    std::vector<BytecodeInstruction> code;
+    size_t superinstructions;   // Instructions that replace two TAC instructions
+
+    bool validate(std::string& error) const;
+
+public:
+    // Largest register file a .tbc file may ask for (128 MB of doubles)
+    static const uint32_t maxRegisters = 1u << 24;
+
+    BytecodeProgram();
+
+    // Translate TAC, fusing compare+branch and load-const+print pairs
+    static BytecodeProgram compile(const std::vector<TACInstruction>& tac);
+
+    // .tbc files: header, constant pool and code, in host byte order
+    bool save(const std::string& filename, std::string& error) const;
+    static bool load(const std::string& filename, BytecodeProgram& program, std::string& error);
+
+    // Run the program in the virtual machine, writing printed values to a stream
+    void run(FILE* out = stdout) const;
+
+    size_t getInstructionCount() const { return code.size(); }
+    size_t getSuperinstructionCount() const { return superinstructions; }
+    uint32_t getRegisterCount() const { return registerCount; }
+    size_t getConstantCount() const { return constants.size(); }
+};
+
+#endif // BYTECODE_H
@@ -0,0 +1,65 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Local on-disk cache of compiled executables. An entry is named by a 128-bit
+// FNV-1a hash of the generated C, the compiler command and the compiler's
+// version, so identical builds reuse the executable instead of running gcc.
+// Entries are used least recently first out when an added entry takes the
+// directory past its size cap (a hit updates the entry's modification time).
+// Hit, miss and eviction counts and the size of the cache are kept in a stats
+// file next to the entries, updated under a lock.
+class ExecutableCache
+{
+private:
+    std::string directory;
+    uint64_t capacity;          // Bytes
+    bool usable;                // Directory exists or was created
+    std::string compilerVersion;
+    uint64_t hits;              // Totals over all builds using the directory
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entryCount;          // As of the last entry added
+    uint64_t totalSize;
+
+    std::string entryPath(const std::string& key) const;
+    void loadStats();
+    void saveStats() const;
+    void updateStats(uint64_t newHits, uint64_t newMisses, bool added);
+    void evict();
+
+public:
+    static const uint64_t defaultCapacityMB = 256;
+
+    ExecutableCache(const std::string& directory, uint64_t capacity);
+
+    // $TACO_CACHE_DIR, else $XDG_CACHE_HOME/taco, else ~/.cache/taco
+    static std::string defaultDirectory();
+
+    // Key of a build from the contents of its sources and the compiler command
+    std::string key(const std::vector<std::string>& sources, const std::string& command);
+    std::string keyOfFiles(const std::vector<std::string>& filenames, const std::string& command);
+
+    // On a hit, place the cached executable at output (hard link, else copy)
+    bool fetch(const std::string& key, const std::string& output);
+    // Add a freshly built executable, then evict down to the size cap
+    void store(const std::string& key, const std::string& executable);
+
+    bool isUsable() const { return usable; }
+    const std::string& getDirectory() const { return directory; }
+    uint64_t getCapacity() const { return capacity; }
+    uint64_t getHits() const { return hits; }
+    uint64_t getMisses() const { return misses; }
+    uint64_t getEvictions() const { return evictions; }
+    size_t getEntryCount() const { return entryCount; }
+    uint64_t getTotalSize() const { return totalSize; }
+};
+
+// Helpers shared with the front-end cache
+std::string contentHash(const std::string& data);     // 128-bit FNV-1a as 32 hex digits
+bool makeDirectories(const std::string& path);
+
+#endif // CACHE_H
@@ -0,0 +1,108 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "tac.h"
+
+// Basic block: a label (optional), straight-line code and at most one jump at the end
+struct BasicBlock
+{
+    int id;
+    std::vector<TACInstruction> instructions;
+    std::vector<int> successors;
+    std::vector<int> predecessors;
+
+    // Leading label of the block, or empty if the block is only reached by fall-through
+    std::string label() const;
+    // Final jump of the block, or nullptr if it falls through
+    const TACInstruction* terminator() const;
+};
+
+// Natural loop: header plus every block that reaches a back edge without passing the header
+struct Loop
+{
+    int header;
+    std::vector<int> latches;   // Sources of back edges into the header
+    std::vector<int> blocks;    // All blocks of the loop (sorted, includes the header)
+};
+
+// Control Flow Graph over TAC
+class ControlFlowGraph
+{
+private:
+    std::vector<BasicBlock> blocks;
+    std::unordered_map<std::string, int> labelToBlock;
+    std::vector<int> idom;          // Immediate dominator of each block (-1 if unreachable)
+    std::vector<int> rpoNumber;     // Reverse postorder number of each block (-1 if unreachable)
+
+    void computeEdges();
+    void computeDominators();
+
+public:
+    ControlFlowGraph(const std::vector<TACInstruction>& tac);
+
+    std::vector<BasicBlock>& getBlocks() { return blocks; }
+    const std::vector<BasicBlock>& getBlocks() const { return blocks; }
+
+    // Block starting with the given label, or -1
+    int blockForLabel(const std::string& label) const;
+
+    bool isReachable(int block) const { return idom[block] != -1; }
+    int immediateDominator(int block) const { return idom[block]; }
+    bool dominates(int a, int b) const;
+    std::vector<Loop> findLoops() const;
+
+    // Blocks in reverse postorder (unreachable blocks are omitted)
+    std::vector<int> reversePostorder() const;
+
+    // Rebuild edges and dominators after the instructions of blocks changed
+    void update();
+
+    // Concatenate blocks back into a linear instruction sequence
+    std::vector<TACInstruction> flatten() const;
+};
+
+// Temporaries live at the start and end of every block, by backward dataflow
+// over the control flow graph. Only temporaries read in some block before
+// being written there can be live at a block boundary; they are numbered
+// first, and sets hold one bit for each of them.
+class TemporaryLiveness
+{
+public:
+    typedef std::vector<uint64_t> TempSet;
+
+private:
+    const ControlFlowGraph& cfg;
+    std::unordered_map<std::string, size_t> tempIndex;
+    std::vector<std::string> temps;
+    size_t globalCount;         // Temporaries live across block boundaries
+    std::vector<TempSet> liveIn;
+    std::vector<TempSet> liveOut;
+    std::vector<std::pair<int, size_t>> positions;  // Block and offset of every instruction
+
+public:
+    TemporaryLiveness(const ControlFlowGraph& cfg);
+
+    size_t getTemporaryCount() const { return temps.size(); }
+    size_t getGlobalCount() const { return globalCount; }
+    const std::string& temporary(size_t index) const { return temps[index]; }
+    // Number of a temporary of the program
+    size_t indexOf(const std::string& temp) const { return tempIndex.at(temp); }
+
+    const TempSet& liveInSet(int block) const { return liveIn[block]; }
+    const TempSet& liveOutSet(int block) const { return liveOut[block]; }
+    bool isLiveOut(int block, const std::string& temp) const;
+    // The value of a temporary is not read after the instruction at an index
+    // of the linear instruction sequence
+    bool isDeadAfter(size_t index, const std::string& temp) const;
+
+    static bool contains(const TempSet& set, size_t temp)
+    {
+        return temp / 64 < set.size() && ((set[temp / 64] >> (temp % 64)) & 1);
+    }
+};
+
+#endif // CFG_H
@@ -1,28 +1,143 @@
 #ifndef CODEGEN_H
 #define CODEGEN_H
 
+#include <csignal>
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <set>
+#include <unordered_map>
 #include "tac.h"
+#include "types.h"
+#include "cfg.h"
 
-// C Code Generator from TAC
+// Output of generated C. Text collects in a large buffer that is reused for
+// the whole program and written to a file descriptor (a file or gcc's stdin)
+// whenever it fills up, or appended to a string.
+class CodeWriter
+{
+private:
+    std::vector<char> buffer;
+    size_t used;
+    int fd;                 // -1 when writing to a string
+    std::string* target;
+    bool failed;
+
+public:
+    static const size_t bufferSize = 1 << 20;
+
+    explicit CodeWriter(int fd);
+    explicit CodeWriter(std::string& target);
+    ~CodeWriter();
+
+    CodeWriter& operator<<(const std::string& text) { return append(text.data(), text.size()); }
+    CodeWriter& operator<<(const char* text);
+    CodeWriter& operator<<(char c) { return append(&c, 1); }
+    CodeWriter& operator<<(size_t value) { return *this << std::to_string(value); }
+    CodeWriter& append(const char* data, size_t size);
+    bool flush();
+    bool good() const { return !failed; }
+};
+
+// C Code Generator from TAC. Control flow is recovered from the labels and
+// jumps as if/else, while, for and do-while statements; jumps that do not fit
+// a structured statement (for example into an irreducible region) stay gotos.
+// Single-use temporaries are written into the expression that reads them.
 class CCodeGenerator
 {
 private:
+    // Innermost loop around the code being emitted
+    struct LoopContext
+    {
+        std::string header;         // Label jumped to by continue, if allowed
+        std::string exit;           // Label jumped to by break
+    };
+
     std::set<std::string> variables;
     std::set<std::string> temporaries;
+    bool integerTyping;     // Declare names proven to hold integers as int64_t
+    bool structured;        // Emit if/while/for instead of labels and goto
+    bool foldExpressions;   // Write single-use temporaries as nested expressions
+    TypeInfo types;
+
+    // Structured emission
+    const std::vector<TACInstruction>* program;
+    const TemporaryLiveness* liveness;
+    std::unordered_map<std::string, size_t> labelPositions;
+    std::unordered_map<std::string, std::vector<size_t>> jumpsTo;  // Label to positions of jumps to it
+
+    // Expression folding: instructions written into the expression of their reader
+    std::vector<bool> foldable;
+    std::vector<std::vector<size_t>> foldedOperands;    // Instructions folded into each instruction
+    std::vector<std::vector<std::string>> foldedReads;  // Names read by each folded expression
+    std::set<std::string> declaredTemporaries;          // Temporaries left in the output
+    size_t foldedCount;
+    std::vector<bool> partStarts;   // First instructions of the functions of sharded output
+    FILE* compiler;                 // gcc reading the program from its stdin
+    sigset_t savedSignalMask;       // Signal mask of the thread before startCompiler blocked SIGPIPE
+    bool pipeSignalPending;         // SIGPIPE was already pending then, so it is not gcc's to discard
+    std::vector<std::string> lines;
+    std::vector<std::string> lineLabels;    // Label defined by each line, or empty
+    std::set<std::string> gotoTargets;      // Labels still reached by goto
+    size_t loopCount;
+    size_t ifCount;
+    size_t gotoCount;
+    size_t functionCount;
+    size_t sharedNameCount;
     
     void collectVariables(const std::vector<TACInstruction>& tac);
-    std::string generateVariableDeclarations();
-    std::string generateInstruction(const TACInstruction& instr);
+    void generateVariableDeclarations(CodeWriter& out);
+    std::string generateInstruction(const TACInstruction& instr, size_t index);
+    std::string expression(const TACInstruction& instr, size_t index);
+    std::string comparison(const TACInstruction& instr, size_t index);
+    std::string operand(const std::string& name, size_t index, bool parenthesize = true);
+    bool isIntegerExpression(const TACInstruction& instr, size_t index) const;
+
+    void findFoldableExpressions();
+    std::string condition(size_t branch, bool negate);
+    bool conditionReads(size_t branch, const std::string& name) const;
+    void prepare(const std::vector<TACInstruction>& tac, const TemporaryLiveness& temporaryLiveness);
+    void emitBodyLines(size_t begin, size_t end);
+    void writeBody(CodeWriter& out);
+    std::string emitBody(size_t begin, size_t end);
+    std::string declaration(const std::string& name) const;
+    void emitLine(int depth, const std::string& text, const std::string& label = "");
+    void emitRange(size_t begin, size_t end, int depth, const LoopContext* loop);
+    size_t emitLoop(size_t header, size_t latch, int depth);
+    void restoreSignalMask();
     
 public:
+    // Instructions per function in sharded output
+    static const size_t partSize = 1000;
+
     CCodeGenerator();
     
+    void setIntegerTyping(bool enabled) { integerTyping = enabled; }
+    void setStructured(bool enabled) { structured = enabled; }
+    void setExpressionFolding(bool enabled) { foldExpressions = enabled; }
+    size_t getIntegerNameCount() const { return types.integerNames.size(); }
+    size_t getNameCount() const { return variables.size() + temporaries.size(); }
+    size_t getFoldedCount() const { return foldedCount; }
+    size_t getTemporaryCount() const { return temporaries.size(); }
+    size_t getLoopCount() const { return loopCount; }
+    size_t getIfCount() const { return ifCount; }
+    size_t getGotoCount() const { return gotoCount; }
+    size_t getFunctionCount() const { return functionCount; }
+    size_t getSharedNameCount() const { return sharedNameCount; }
+    
     std::string generate(const std::vector<TACInstruction>& tac);
+    void generate(const std::vector<TACInstruction>& tac, CodeWriter& out);
+    bool generateToFile(const std::vector<TACInstruction>& tac, const std::string& filename);
+    // The program as translation units of functions called by main in shard 0
+    std::vector<std::string> generateShards(const std::vector<TACInstruction>& tac, size_t shardCount);
     void writeToFile(const std::string& code, const std::string& filename);
     bool compileToExecutable(const std::string& cFilename, const std::string& outputExecutable);
+    // Start gcc reading C from its stdin (-x c -); returns the descriptor to
+    // write the program to, or -1. finishCompiler closes it and waits for gcc.
+    int startCompiler(const std::string& outputExecutable);
+    bool finishCompiler();
+    // Compile translation units with parallel gcc processes and link them
+    bool compileShardsToExecutable(const std::vector<std::string>& cFilenames, const std::string& outputExecutable);
 };
 
 #endif // CODEGEN_H
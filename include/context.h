@@ -0,0 +1,19 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "logger.h"
+
+// State of one compilation. Every stage is given the context it runs in and
+// writes its log lines, stage timers and profiling samples there rather than
+// to process-wide state, so compilations with separate contexts can run on
+// separate threads at once. A context is used by one thread at a time.
+struct CompilationContext
+{
+    Logger logger;      // Log file, stage timings and resource profiling
+
+    CompilationContext() {}
+    CompilationContext(const CompilationContext&) = delete;
+    CompilationContext& operator=(const CompilationContext&) = delete;
+};
+
+#endif // CONTEXT_H
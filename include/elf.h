@@ -0,0 +1,42 @@
+#ifndef ELF_H
+#define ELF_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+// Executables written by taco itself run on x86-64 Linux
+#if defined(__x86_64__) && defined(__linux__)
+#define TACO_NATIVE_ELF 1
+#else
+#define TACO_NATIVE_ELF 0
+#endif
+
+// Writes a static ELF64 executable for x86-64 Linux without an external
+// toolchain. .text holds a start stub, the program as machine code from the
+// JIT's code generator and the embedded print runtime (write and exit system
+// calls only); .data holds the value slots and .bss the output buffer.
+class ELFWriter
+{
+private:
+    size_t programSize;     // Bytes of machine code for the program
+    size_t textSize;
+    size_t dataSize;
+    size_t bssSize;
+
+public:
+    ELFWriter();
+
+    // The executable's bytes in memory
+    bool build(const std::vector<TACInstruction>& tac, std::vector<uint8_t>& bytes, std::string& error);
+    bool write(const std::vector<TACInstruction>& tac, const std::string& filename, std::string& error);
+
+    size_t getProgramSize() const { return programSize; }
+    size_t getRuntimeSize() const;
+    size_t getTextSize() const { return textSize; }
+    size_t getDataSize() const { return dataSize; }
+    size_t getBssSize() const { return bssSize; }
+};
+
+#endif // ELF_H
@@ -0,0 +1,12 @@
+#ifndef FILES_H
+#define FILES_H
+
+#include <string>
+
+// Replace a file with new contents. They are written to a temporary file in
+// the same directory that is then renamed over the old one, so readers never
+// see a partial file and an existing file is never written through: it may be
+// a hard link to a cache entry.
+bool replaceFile(const std::string& filename, const std::string& contents, bool executable);
+
+#endif // FILES_H
@@ -0,0 +1,74 @@
+#ifndef FRONTEND_CACHE_H
+#define FRONTEND_CACHE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lexer.h"
+#include "parser.h"
+#include "tac.h"
+#include "context.h"
+
+// Incremental front end. The token stream is cut into top-level statements,
+// and each statement is keyed by a hash of its tokens. Statements seen in the
+// previous build of the same source reuse their TAC fragment; the others are
+// parsed and lowered on their own. Fragments number their temporaries and
+// labels from 0 and are renumbered when spliced, so the result is the TAC a
+// whole-program build would produce. The fragments of the current build are
+// saved in one file per source (named by a hash of its path) under the cache
+// directory, so statements that move around are reused as well.
+class FrontEndCache
+{
+private:
+    // TAC of one statement, serialized one instruction per line
+    struct Fragment
+    {
+        std::string text;
+        size_t instructionCount = 0;
+        int tempCount = 0;
+        int labelCount = 0;
+        double milliseconds = 0;    // Time it took to parse and lower
+        bool used = false;          // By a statement of this build
+    };
+
+    // A top-level statement of this build
+    struct Statement
+    {
+        std::string key;
+        bool reused;
+        size_t firstNode;           // AST nodes parsed for it, if it was not reused
+        size_t nodeCount;
+        double parseMilliseconds;
+    };
+
+    CompilationContext& context;
+    std::string filename;
+    std::unordered_map<std::string, Fragment> previous;     // From the file
+    std::unordered_map<std::string, Fragment> current;      // Lowered in this build
+    std::vector<Statement> statements;
+    size_t usedCount;               // Fragments of the file this build uses
+    size_t reusedCount;
+    double savedMilliseconds;
+
+    void load();
+
+public:
+    FrontEndCache(CompilationContext& context, const std::string& directory, const std::string& sourcePath);
+
+    // Split into statements and parse those not in the cache, appending their
+    // nodes to ast and their syntax errors to errors
+    void parse(const std::vector<Token>& tokens, std::vector<std::unique_ptr<ASTNode>>& ast,
+               std::vector<std::string>& errors);
+    // TAC of the whole program from cached and newly lowered fragments
+    std::vector<TACInstruction> generate(const std::vector<std::unique_ptr<ASTNode>>& ast);
+    bool save(std::string& error) const;
+
+    size_t getStatementCount() const { return statements.size(); }
+    size_t getReusedCount() const { return reusedCount; }
+    // Parse and TAC time of the reused statements, less what hashing and
+    // splicing took (none when the cache did not pay off)
+    double getSavedMilliseconds() const { return savedMilliseconds > 0 ? savedMilliseconds : 0; }
+};
+
+#endif // FRONTEND_CACHE_H
@@ -0,0 +1,131 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "tac.h"
+#include "../runtime/taco_format.h"
+
+// Computed goto (labels as values) is a GCC extension also supported by Clang
+#if defined(__GNUC__)
+#define TACO_THREADED_DISPATCH 1
+#else
+#define TACO_THREADED_DISPATCH 0
+#endif
+
+// Buffered output of printed values, formatted as printf("%g\n") by the
+// runtime's formatter without going through stdio for each value
+class PrintBuffer
+{
+private:
+    static const size_t capacity = 1 << 16;
+    static const size_t maxEntry = 32;      // Longest formatted value plus newline
+    FILE* out;
+    size_t length;
+    char buffer[capacity];
+
+public:
+    PrintBuffer(FILE* out);
+    ~PrintBuffer() { flush(); }
+
+    void print(double value)
+    {
+        if (length + maxEntry > capacity)
+            flush();
+        length += taco_format_g(value, buffer + length);
+        buffer[length++] = '\n';
+    }
+    void flush();
+};
+
+// Value slots of a program, shared by the interpreter and the JIT: names in
+// order of first appearance, one unused slot for missing operands, then
+// literals
+class SlotLayout
+{
+private:
+    std::unordered_map<std::string, uint32_t> slots;
+    std::vector<double> initialValues;      // Names start at 0, literal slots hold their value
+    size_t nameCount;
+
+public:
+    SlotLayout(const std::vector<TACInstruction>& tac);
+
+    // Slot of a name or literal of the program (the unused slot if empty)
+    uint32_t slotOf(const std::string& operand) const;
+
+    const std::vector<double>& getInitialValues() const { return initialValues; }
+    size_t getSlotCount() const { return initialValues.size(); }
+    size_t getNameCount() const { return nameCount; }
+};
+
+// Direct-threaded interpreter over TAC. Labels are resolved to instruction
+// indices and operands to slots of one value array (names first, then
+// literals); with GCC every instruction holds the address of its handler.
+// For tiered execution the back edges of natural loops can be counted: they
+// jump through a trampoline that stops the interpreter once its loop is hot.
+class TACInterpreter
+{
+public:
+    // Natural loop as a range of TAC indices, entered at its header label
+    struct LoopRegion
+    {
+        size_t begin;
+        size_t header;
+        size_t end;
+        uint64_t backEdges;     // Back edges taken in the interpreter
+    };
+
+private:
+    // Operations of the threaded code; labels are gone and HALT ends the program
+    enum class Operation : uint8_t
+    {
+        ADD, SUB, MUL, DIV, ASSIGN,
+        LT, GT, LE, GE, EQ, NE,
+        AND, OR, NOT,
+        GOTO, IF_FALSE, IF_TRUE,
+        PRINT, HALT,
+        BACK_EDGE               // Count a back edge of loop result, then jump
+    };
+
+    struct ThreadedInstruction
+    {
+        const void* handler;    // Handler address (threaded dispatch only)
+        Operation operation;
+        uint32_t result;
+        uint32_t arg1;
+        uint32_t arg2;
+        uint32_t target;        // Index of the instruction a jump continues at
+    };
+
+    SlotLayout layout;
+    std::vector<ThreadedInstruction> code;
+    size_t programSize;                     // Instructions up to HALT; trampolines follow
+    std::vector<uint32_t> threadedIndex;    // Threaded instruction of every TAC index
+    std::vector<LoopRegion> loops;
+    uint64_t hotThreshold;                  // Back edges after which a loop is hot (0: not counted)
+
+    void addBackEdgeTrampolines(const std::vector<TACInstruction>& tac);
+    uint32_t execute(std::vector<double>& values, PrintBuffer* output, uint32_t entry, bool resolveHandlers);
+
+public:
+    TACInterpreter(const std::vector<TACInstruction>& tac, uint64_t hotThreshold = 0);
+
+    // Run the program, writing printed values to a stream
+    void run(FILE* out = stdout);
+
+    // Run from a TAC index until the program ends (returns the TAC size) or
+    // a loop becomes hot (returns its header index and sets hotLoop)
+    size_t resume(std::vector<double>& values, PrintBuffer& output, size_t index, int& hotLoop);
+
+    const SlotLayout& getLayout() const { return layout; }
+    const std::vector<LoopRegion>& getLoops() const { return loops; }
+    size_t getInstructionCount() const { return programSize; }
+    size_t getSlotCount() const { return layout.getSlotCount(); }
+    size_t getNameCount() const { return layout.getNameCount(); }
+};
+
+#endif // INTERPRETER_H
@@ -0,0 +1,70 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+// Machine code generation needs x86-64 and mmap
+#if defined(__x86_64__) && defined(__unix__)
+#define TACO_JIT_SUPPORTED 1
+#else
+#define TACO_JIT_SUPPORTED 0
+#endif
+
+class PrintBuffer;
+class SlotLayout;
+
+// Compiles TAC to x86-64 machine code in an executable mmap'ed buffer. All
+// names and literals live in one array of doubles addressed from rbx (laid
+// out as in the interpreter); arithmetic uses SSE2 scalar instructions and
+// PRINT calls back into a PrintBuffer. A region of the program can be
+// compiled on its own: leaving it returns the TAC index to continue at.
+class JITCompiler
+{
+private:
+    // Entry point: values array, print buffer, print function; returns the
+    // TAC index execution continues at
+    typedef uint32_t (*EntryFunction)(double*, PrintBuffer*, void (*)(PrintBuffer*, double));
+
+    void* code;
+    size_t codeSize;        // Bytes of machine code
+    size_t mappedSize;      // Bytes mapped (whole pages)
+    std::vector<double> initialValues;      // Names start at 0, literal slots hold their value
+    size_t fusedBranches;
+
+    void release();
+
+public:
+    JITCompiler();
+    ~JITCompiler();
+    JITCompiler(const JITCompiler&) = delete;
+    JITCompiler& operator=(const JITCompiler&) = delete;
+
+    static bool isSupported() { return TACO_JIT_SUPPORTED != 0; }
+
+    // Machine code for the TAC indices [begin, end), entered at index entry:
+    // one position-independent function with the EntryFunction signature
+    static bool generateCode(const std::vector<TACInstruction>& tac, size_t begin, size_t entry, size_t end,
+                             const SlotLayout& layout, std::vector<uint8_t>& code, size_t& fusedBranches,
+                             std::string& error);
+
+    // Compile the whole program
+    bool compile(const std::vector<TACInstruction>& tac, std::string& error);
+    // Compile the TAC indices [begin, end), entered at index entry
+    bool compileRegion(const std::vector<TACInstruction>& tac, size_t begin, size_t entry, size_t end,
+                       const SlotLayout& layout, std::string& error);
+
+    // Run the compiled program, writing printed values to a stream
+    void run(FILE* out = stdout) const;
+    // Run compiled code on existing values; returns the TAC index to continue at
+    size_t execute(std::vector<double>& values, PrintBuffer& output) const;
+
+    size_t getCodeSize() const { return codeSize; }
+    size_t getSlotCount() const { return initialValues.size(); }
+    size_t getFusedBranchCount() const { return fusedBranches; }
+};
+
+#endif // JIT_H
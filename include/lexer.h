@@ -58,5 +58,7 @@ struct Token
 };
 
 std::vector<Token> lexing(const std::string &source_code);
+// Also collects a message for every character that starts no token
+std::vector<Token> lexing(const std::string &source_code, std::vector<std::string>& errors);
 
 #endif // LEXER_H
@@ -14,6 +14,8 @@ struct TimingInfo
 {
     std::string stageName;
     double durationMs;
+    int depth;      // Number of enclosing stages (nested timers)
+    int count;      // Number of timed runs merged into this entry
 };
 
 // Structure to store resource usage information
@@ -43,7 +45,9 @@ private:
     std::string filename;
     std::vector<TimingInfo> timings;
     std::vector<ResourceInfo> resourceTimings;
-    std::chrono::high_resolution_clock::time_point stageStartTime;
+    std::vector<std::string> timingNotes;     // Lines printed below the timing totals
+    // Running timers, innermost last, with the number of entries recorded when each started
+    std::vector<std::pair<std::chrono::high_resolution_clock::time_point, size_t>> stageStartTimes;
     bool profilingEnabled;
     ProcessStats startStats;
     std::chrono::high_resolution_clock::time_point profileStartTime;
@@ -96,13 +100,15 @@ public:
     bool isFileOpen() const { return isOpen; }
     std::string getFilename() const { return filename; }
     
-    // Timing methods
+    // Timing methods. Timers nest: a stage timed while another is running is
+    // reported below it, and repeated runs of a nested stage are merged.
     void startTimer();
     void endTimer(const std::string& stageName);
     void printTimingReport(); // Prints to both console and log
     void printTimingReportToConsole(); // Prints only to console
     void printTimingReportToLog(); // Prints only to log file
     double getTotalTime() const;
+    void addTimingNote(const std::string& note);
     void clearTimings();
     
     // Resource profiling methods
@@ -114,7 +120,19 @@ public:
     void printProfilingReportToLog(); // Prints only to log file
 };
 
-// Global logger instance
-extern Logger logger;
+// Times one stage of the compilation, and profiles it when profiling is
+// enabled, from construction to the end of the enclosing scope
+class StageTimer
+{
+private:
+    Logger& logger;
+    std::string stageName;
+
+public:
+    StageTimer(Logger& logger, const std::string& stageName);
+    ~StageTimer();
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+};
 
 #endif // LOGGER_H
@@ -0,0 +1,145 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "tac.h"
+#include "context.h"
+
+// Options shared by all optimization passes
+struct OptimizationOptions
+{
+    bool logReport;                 // Write per-pass reports to the log file
+    bool fastMath;                  // Allow rewrites that are not exact under IEEE double semantics
+    size_t maxRotatedCondition;     // Largest loop condition (in instructions) duplicated by rotation
+    int unrollFactor;               // Copies of the body per iteration for partial unrolling (1 = off)
+    long maxFullUnrollTrip;         // Largest known trip count that is unrolled completely
+    size_t maxUnrollBodySize;       // Largest loop body (in instructions) that is partially unrolled
+    size_t maxUnrolledLoopSize;     // Largest size of a single loop after unrolling
+    size_t minUnrollBudget;         // Instructions unrolling may always add to a program
+    double maxUnrollGrowth;         // Additional growth allowed as a fraction of program size
+    long tripReplayBudget;          // Induction steps unrolling may replay for trip counts, all loops together
+    long partialEvalFuel;           // Instructions partial evaluation may execute (0 = off)
+    size_t maxResidualPrints;       // Most precomputed values partial evaluation prints directly
+
+    OptimizationOptions()
+        : logReport(false), fastMath(false), maxRotatedCondition(32), unrollFactor(4), maxFullUnrollTrip(32),
+          maxUnrollBodySize(32), maxUnrolledLoopSize(256), minUnrollBudget(512), maxUnrollGrowth(0.5),
+          tripReplayBudget(1L << 26), partialEvalFuel(1000000), maxResidualPrints(10000) {}
+};
+
+// Allocates temporaries and labels that do not clash with existing TAC
+class TACNameAllocator
+{
+private:
+    int tempCounter;
+    int labelCounter;
+
+public:
+    TACNameAllocator(const std::vector<TACInstruction>& tac);
+
+    std::string newTemp();
+    std::string newLabel();
+};
+
+// Definitions visible at the current point of a basic block. A definition is
+// dropped as soon as its result or one of its operands is assigned again.
+class LocalDefinitions
+{
+private:
+    std::unordered_map<std::string, TACInstruction> definitions;
+    std::unordered_map<std::string, std::vector<std::string>> readers;
+
+public:
+    void clear();
+    void kill(const std::string& name);
+    void record(const TACInstruction& instr);
+    const TACInstruction* find(const std::string& name) const;
+};
+
+// Optimization passes (each returns the number of changes made)
+int rotateLoops(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context);
+int unrollLoops(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context);
+int simplifyCFG(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context);
+int simplifyAlgebraic(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context);
+int propagateCopies(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                    CompilationContext& context);
+int eliminateDeadCode(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context);
+int simplifyWithRanges(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                       CompilationContext& context);
+int partiallyEvaluate(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context);
+int allocateTemporaries(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                        CompilationContext& context);
+
+// Signature shared by all optimization passes; reports go to the context's log
+typedef int (*OptimizationPassFunction)(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                                        CompilationContext& context);
+
+// Optimization pass known to the pass manager
+struct OptimizationPass
+{
+    const char* name;
+    OptimizationPassFunction run;
+    const char* description;
+};
+
+// Step of a pipeline: a single pass, or a group of passes repeated until none
+// of them changes the code
+struct PipelineStep
+{
+    std::vector<const OptimizationPass*> passes;
+    bool fixpoint;
+};
+
+// Statistics of one pass over all of its runs
+struct PassStatistics
+{
+    std::string name;
+    int runs;
+    int changes;
+    long instructionDelta;      // Instructions added (positive) or removed (negative)
+    double durationMs;
+};
+
+// TAC Optimizer - pass manager running a pipeline of registered passes over the TAC
+class TACOptimizer
+{
+private:
+    CompilationContext& context;
+    OptimizationOptions options;
+    std::vector<PipelineStep> pipeline;
+    std::vector<PassStatistics> statistics;
+
+    void runPass(const OptimizationPass& pass, std::vector<TACInstruction>& tac, int& changes);
+    PassStatistics& statisticsFor(const std::string& name);
+    void printStatistics();
+
+public:
+    static const int maxFixpointIterations = 16;
+
+    explicit TACOptimizer(CompilationContext& context);
+    TACOptimizer(CompilationContext& context, const OptimizationOptions& opts);
+
+    // All passes that can appear in a pipeline
+    static const std::vector<OptimizationPass>& registeredPasses();
+    static const OptimizationPass* findPass(const std::string& name);
+
+    // Use the preset pipeline of an optimization level (0-3)
+    void setLevel(int level);
+    // Use a custom pipeline: comma-separated pass names, "fixpoint(a,b,...)" repeats a group
+    bool setPipeline(const std::string& spec, std::string& error);
+
+    void optimize(std::vector<TACInstruction>& tac);
+
+    OptimizationOptions& getOptions() { return options; }
+    const std::vector<PassStatistics>& getStatistics() const { return statistics; }
+};
+
+#endif // OPTIMIZER_H
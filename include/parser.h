@@ -5,6 +5,7 @@
 #include <vector>
 #include <memory>
 #include "lexer.h"
+#include "context.h"
 
 // AST Node Types
 enum class ASTNodeType
@@ -191,7 +192,10 @@ class Parser
 private:
     std::vector<Token> tokens;
     size_t current;
+    Logger& logger;             // The compilation's log: syntax errors and printAST
+    std::vector<std::string> errors;
 
+    void error(const std::string& message, int line);
     Token peek();
     Token advance();
     bool check(TokenType type);
@@ -213,8 +217,10 @@ private:
     std::unique_ptr<ASTNode> parseStatement();
 
 public:
-    Parser(const std::vector<Token> &tokens);
+    Parser(const std::vector<Token> &tokens, CompilationContext& context);
     std::vector<std::unique_ptr<ASTNode>> parse();
+    // Syntax errors of parse(); statements with errors are left out of the AST
+    const std::vector<std::string>& getErrors() const { return errors; }
     void printAST(const ASTNode* node, int indent = 0, bool toConsole = false);
 };
 
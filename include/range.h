@@ -0,0 +1,101 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "tac.h"
+#include "cfg.h"
+#include "context.h"
+
+// Set of double values a name may hold: an interval plus the special values
+// the interval cannot describe
+struct ValueRange
+{
+    double lo;
+    double hi;
+    bool integral;          // Every non-NaN value is a finite integer
+    bool mayBeNaN;
+    bool mayBeNegZero;      // A zero value may be -0
+
+    ValueRange();
+    ValueRange(double lo, double hi, bool integral);
+
+    static ValueRange constant(double value);
+    static ValueRange unknown();
+    static ValueRange boolean(bool canBeTrue, bool canBeFalse);
+
+    bool isConstant() const { return lo == hi && !mayBeNaN; }
+    bool mayBeZero() const { return lo <= 0.0 && hi >= 0.0; }
+    bool mayBeNonZero() const { return lo != 0.0 || hi != 0.0 || mayBeNaN; }
+    // Integer exactly representable in both double and int64_t arithmetic
+    bool isExactInteger() const;
+
+    ValueRange join(const ValueRange& other) const;
+    bool operator==(const ValueRange& other) const;
+    bool operator!=(const ValueRange& other) const { return !(*this == other); }
+
+    std::string toString() const;
+};
+
+// Ranges of the operands and the result of one instruction
+struct InstructionRanges
+{
+    ValueRange arg1;
+    ValueRange arg2;
+    ValueRange result;
+};
+
+// Interval analysis over the control flow graph. Bounds come from literals
+// and assignments and are narrowed along branch edges by the comparison that
+// decides the branch; loops are widened to the constants of the program.
+class RangeAnalysis
+{
+public:
+    typedef std::unordered_map<std::string, ValueRange> State;
+
+private:
+    // How a loop header state that keeps growing is widened
+    enum class Widening
+    {
+        NONE,           // Plain join
+        CONSTANTS,      // Bounds jump to the next constant of the program
+        LIMITS          // Bounds jump to 2^53 or infinity
+    };
+
+    ControlFlowGraph cfg;
+    std::vector<size_t> blockStart;             // Index of the first instruction of each block
+    std::vector<char> blockReached;
+    std::vector<State> entryStates;
+    std::vector<InstructionRanges> ranges;
+    std::vector<char> reached;
+    std::vector<char> takenFeasible;            // Per block: the branch at its end can be taken
+    std::vector<char> fallThroughFeasible;      // Per block: the branch at its end can fall through
+    std::vector<double> thresholds;             // Widening points, sorted
+    std::unordered_set<std::string> crossBlockNames;   // Names read before written in some block
+
+    ValueRange lookup(const State& state, const std::string& operand) const;
+    ValueRange evaluate(const TACInstruction& instr, const ValueRange& a, const ValueRange& b) const;
+    bool refine(const BasicBlock& block, const State& exitState, bool taken, State& edgeState) const;
+    void transfer(int block, State& state, bool record);
+    bool mergeInto(State& target, const State& incoming, Widening widening) const;
+    ValueRange widen(const ValueRange& previous, const ValueRange& next, Widening widening) const;
+    int blockOf(size_t index) const;
+
+public:
+    RangeAnalysis(const std::vector<TACInstruction>& tac);
+
+    // Ranges before (operands) and after (result) the instruction at an index
+    const InstructionRanges& at(size_t index) const { return ranges[index]; }
+    bool isReachable(size_t index) const { return reached[index] != 0; }
+
+    // Feasibility of the two edges of a conditional jump at an index
+    bool canBranch(size_t index) const;
+    bool canFallThrough(size_t index) const;
+
+    // Write the range facts of every instruction to the compilation's log
+    void print(const std::vector<TACInstruction>& tac, CompilationContext& context) const;
+};
+
+#endif // RANGE_H
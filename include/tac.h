@@ -35,6 +35,7 @@ enum class TACOpcode
     LABEL,      // label:
     GOTO,       // goto label
     IF_FALSE,   // if !a goto label
+    IF_TRUE,    // if a goto label
     
     // I/O
     PRINT       // print a
@@ -55,10 +56,18 @@ struct TACInstruction
     std::string toString() const;
 };
 
+// Operand helpers
+bool isNumericLiteral(const std::string& operand);
+bool isTemporary(const std::string& operand);
+bool isControlFlow(TACOpcode opcode);
+bool writesResult(TACOpcode opcode);
+std::string formatNumericLiteral(double value);
+
 // TAC Generator
 class TACGenerator
 {
 private:
+    CompilationContext& context;
     std::vector<TACInstruction> instructions;
     int tempCounter;
     int labelCounter;
@@ -70,12 +79,22 @@ private:
     void generateStatement(const ASTNode* node);
     
 public:
-    TACGenerator();
+    // Raised whenever generate() lowers some statement differently, so TAC
+    // an older taco saved (the front-end cache) is not mixed with this one's
+    static const int version = 1;
+
+    explicit TACGenerator(CompilationContext& context);
     
     std::vector<TACInstruction> generate(const std::vector<std::unique_ptr<ASTNode>>& ast);
-    void printTAC(const std::vector<TACInstruction>& tac, bool toConsole = false);
+    std::vector<TACInstruction> generate(const std::vector<std::unique_ptr<ASTNode>>& ast,
+                                         size_t first, size_t count);
+    void printTAC(const std::vector<TACInstruction>& tac, bool toConsole = false,
+                  const std::string& title = "THREE-ADDRESS CODE");
     
     const std::vector<TACInstruction>& getInstructions() const { return instructions; }
+    // Temporaries and labels the last generate() numbered (t0.., L0..)
+    int getTempCount() const { return tempCounter; }
+    int getLabelCount() const { return labelCounter; }
 };
 
 #endif // TAC_H
@@ -0,0 +1,89 @@
+#ifndef TAC_FILE_H
+#define TAC_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tac.h"
+
+// .tacb files: the TAC of a program, laid out to be used in place once
+// mapped into memory. Host byte order, like .tbc files. After the header come,
+// each 8-byte aligned:
+//   constants     TACFileConstant[constantCount]     numeric literals
+//   symbols       TACFileSymbol[symbolCount]         variables, temporaries, labels
+//   instructions  TACFileInstruction[instructionCount]
+//   strings       stringBytes of NUL-terminated names and literal spellings
+struct TACFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t instructionCount;
+    uint32_t symbolCount;
+    uint32_t constantCount;
+    uint32_t stringBytes;
+};
+
+struct TACFileConstant
+{
+    double value;
+    uint32_t text;              // Spelling as in the TAC, an offset into the strings
+    uint32_t length;
+};
+
+struct TACFileSymbol
+{
+    uint32_t text;
+    uint32_t length;
+};
+
+// An operand is a symbol index, a constant index with constantOperand set, or
+// noOperand
+struct TACFileInstruction
+{
+    uint32_t opcode;            // TACOpcode
+    uint32_t result;
+    uint32_t arg1;
+    uint32_t arg2;
+};
+
+class TACFile
+{
+private:
+    void* mapping;
+    size_t mappingSize;
+    const TACFileHeader* header;
+    const TACFileConstant* constants;
+    const TACFileSymbol* symbols;
+    const TACFileInstruction* instructions;
+    const char* strings;
+
+    bool validate(std::string& error) const;
+
+public:
+    static const uint32_t noOperand = 0xFFFFFFFF;
+    static const uint32_t constantOperand = 0x80000000;
+
+    TACFile();
+    ~TACFile();
+    TACFile(const TACFile&) = delete;
+    TACFile& operator=(const TACFile&) = delete;
+
+    static bool save(const std::vector<TACInstruction>& tac, const std::string& filename, std::string& error);
+
+    // Map a file read-only and check its header and every index in it
+    bool open(const std::string& filename, std::string& error);
+    void close();
+
+    size_t getInstructionCount() const { return header ? header->instructionCount : 0; }
+    size_t getSymbolCount() const { return header ? header->symbolCount : 0; }
+    size_t getConstantCount() const { return header ? header->constantCount : 0; }
+    const TACFileInstruction& getInstruction(size_t index) const { return instructions[index]; }
+    double getConstantValue(uint32_t index) const { return constants[index].value; }
+    // Text of an operand reference: a symbol name, a literal or ""
+    const char* operandText(uint32_t operand) const;
+
+    // The program as TAC for the rest of the pipeline
+    std::vector<TACInstruction> toTAC() const;
+};
+
+#endif // TAC_FILE_H
@@ -0,0 +1,98 @@
+#ifndef TACO_H
+#define TACO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parser.h"
+#include "tac.h"
+#include "optimizer.h"
+#include "codegen.h"
+#include "bytecode.h"
+#include "jit.h"
+#include "context.h"
+
+// libtaco: the compiler as a library (libtaco.a, libtaco.so). Every stage
+// takes its input and returns its result in memory, so a long-running process
+// can compile many programs without starting taco or touching the filesystem;
+// the taco driver adds files, caches, gcc and reporting around these calls.
+// A compiler logs and times its stages in the CompilationContext it is given:
+// threads that each use their own context can compile at the same time.
+struct CompileOptions
+{
+    int optimizationLevel;          // Preset pass pipeline, 0-3
+    std::string passList;           // Custom pipeline instead of the preset (--passes syntax)
+    OptimizationOptions optimization;
+    bool structuredC;               // if/while/for instead of goto in generated C
+    bool foldC;                     // Nested C expressions instead of one statement per instruction
+
+    CompileOptions() : optimizationLevel(0), structuredC(true), foldC(true) {}
+};
+
+class TacoCompiler
+{
+private:
+    CompilationContext& context;
+    CompileOptions options;
+
+    void configure(CCodeGenerator& codeGen) const;
+    void reportC(const CCodeGenerator& codeGen) const;
+
+public:
+    explicit TacoCompiler(CompilationContext& context, const CompileOptions& options = CompileOptions());
+
+    // Check the options (the pass list) before compiling anything
+    bool validate(std::string& error) const;
+    const CompileOptions& getOptions() const { return options; }
+    CompilationContext& getContext() const { return context; }
+    // Whether optimize() changes anything, and whether generated C types integers
+    bool optimizes() const { return options.optimizationLevel > 0 || !options.passList.empty(); }
+    bool typesIntegers() const { return options.optimizationLevel >= 2 || !options.passList.empty(); }
+
+    // Every stage below is timed (and profiled) in the context's logger under
+    // the name taco reports it by, and logs what it produced.
+
+    // Front end. A bad program is reported through errors (one message per
+    // problem, also written to the context's log); the stages go on past an
+    // error, leaving out what they could not read.
+    std::vector<Token> tokenize(const std::string& source, std::vector<std::string>& errors) const;
+    std::vector<std::unique_ptr<ASTNode>> parse(const std::vector<Token>& tokens, std::vector<std::string>& errors) const;
+    std::vector<TACInstruction> generateTAC(const std::vector<std::unique_ptr<ASTNode>>& ast) const;
+    // False when the pass list is invalid (validate() reports the same error)
+    bool optimize(std::vector<TACInstruction>& tac, std::string& error) const;
+    // Source text to optimized TAC in one call; false with the errors of a bad
+    // program or pass list
+    bool compile(const std::string& source, std::vector<TACInstruction>& tac, std::vector<std::string>& errors) const;
+
+    // Back ends
+    std::string generateC(const std::vector<TACInstruction>& tac) const;
+    // Stream the C program into a writer; false when writing failed
+    bool generateC(const std::vector<TACInstruction>& tac, CodeWriter& out) const;
+    // The program as functions spread over count translation units (--shards)
+    std::vector<std::string> generateCShards(const std::vector<TACInstruction>& tac, size_t count) const;
+    std::string generateAssembly(const std::vector<TACInstruction>& tac) const;
+    // Static x86-64 Linux executable, as the bytes of the file
+    bool generateExecutable(const std::vector<TACInstruction>& tac, std::vector<uint8_t>& image,
+                            std::string& error) const;
+    BytecodeProgram generateBytecode(const std::vector<TACInstruction>& tac) const;
+    // Machine code in memory, ready for runMachineCode()
+    bool generateMachineCode(const std::vector<TACInstruction>& tac, JITCompiler& jit, std::string& error) const;
+
+    // Execution, writing printed values to a stream
+    void run(const std::vector<TACInstruction>& tac, FILE* out = stdout) const;
+    void runMachineCode(JITCompiler& jit, FILE* out = stdout) const;
+    // Interpret, compiling loops that run more than threshold times (--tiered)
+    bool runTiered(const std::vector<TACInstruction>& tac, uint64_t threshold, FILE* out, std::string& error) const;
+
+    // Executables built by the system toolchain (gcc), which these run
+    bool compileC(const std::vector<TACInstruction>& tac, const std::string& executable) const;
+    bool compileC(const std::string& cCode, const std::string& executable) const;
+    bool compileCFile(const std::string& cFile, const std::string& executable) const;
+    bool compileCFiles(const std::vector<std::string>& cFiles, const std::string& executable) const;
+    bool assemble(const std::string& asmFile, const std::string& executable) const;
+};
+
+#endif // TACO_H
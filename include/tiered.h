@@ -0,0 +1,43 @@
+#ifndef TIERED_H
+#define TIERED_H
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tac.h"
+#include "interpreter.h"
+#include "jit.h"
+
+// Tiered execution: the program starts in the interpreter, which counts the
+// back edges of every natural loop. A loop that reaches the threshold is
+// compiled by the JIT, and execution continues in machine code at the loop
+// header on the same values (on-stack replacement at loop entry) until the
+// loop exits back to the interpreter.
+class TieredExecutor
+{
+private:
+    std::vector<TACInstruction> tac;
+    TACInterpreter interpreter;
+    std::vector<std::unique_ptr<JITCompiler>> compiledLoops;   // Per loop, null until hot
+    size_t codeSize;                // Bytes of machine code over all compiled loops
+    size_t transfers;               // Entries into compiled loops
+    double compileMilliseconds;
+
+public:
+    static const uint64_t defaultThreshold = 1000;
+
+    TieredExecutor(const std::vector<TACInstruction>& tac, uint64_t hotThreshold = defaultThreshold);
+
+    // Run the program, writing printed values to a stream
+    bool run(FILE* out, std::string& error);
+
+    size_t getLoopCount() const { return compiledLoops.size(); }
+    size_t getCompiledLoopCount() const;
+    size_t getCodeSize() const { return codeSize; }
+    size_t getTransferCount() const { return transfers; }
+    double getCompileMilliseconds() const { return compileMilliseconds; }
+};
+
+#endif // TIERED_H
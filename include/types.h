@@ -0,0 +1,24 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "tac.h"
+
+// C types the code generator may use instead of double. A name is an integer
+// if every value it is ever assigned is an integer within 2^53 that is not -0:
+// such values behave identically in int64_t and double arithmetic.
+struct TypeInfo
+{
+    std::unordered_set<std::string> integerNames;
+    std::vector<char> integerResults;       // Per instruction: the value computed is such an integer
+
+    // Integer name or integer literal
+    bool isInteger(const std::string& operand) const;
+};
+
+// Infer integer names from a range analysis of the TAC
+TypeInfo inferTypes(const std::vector<TACInstruction>& tac);
+
+#endif // TYPES_H
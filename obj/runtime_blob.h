@@ -0,0 +1,222 @@
+// Generated from runtime/taco_rt.c
+static const unsigned char runtimeBlob[] = {
+0xe9,0x4b,0x0b,0x00,0x00,0xe9,0xb6,0x0b,0x00,0x00,0x66,0x0f,0x1f,0x44,0x00,0x00,
+0x41,0x57,0x66,0x48,0x0f,0x7e,0xc0,0x49,0x89,0xf9,0x48,0xba,0xff,0xff,0xff,0xff,
+0xff,0xff,0x0f,0x00,0x41,0x56,0x48,0x89,0xc6,0x48,0x21,0xc2,0x41,0x55,0x48,0xc1,
+0xee,0x34,0x49,0x89,0xd7,0x41,0x54,0x81,0xe6,0xff,0x07,0x00,0x00,0x55,0x53,0x48,
+0x81,0xec,0xd0,0x05,0x00,0x00,0x48,0x85,0xc0,0x79,0x08,0x41,0xc6,0x01,0x2d,0x48,
+0x8d,0x7f,0x01,0x81,0xfe,0xff,0x07,0x00,0x00,0x0f,0x84,0x01,0x07,0x00,0x00,0x85,
+0xf6,0x0f,0x85,0x91,0x06,0x00,0x00,0x4d,0x85,0xff,0x75,0x24,0xc6,0x07,0x30,0x48,
+0x8d,0x47,0x01,0x44,0x29,0xc8,0x48,0x81,0xc4,0xd0,0x05,0x00,0x00,0x5b,0x5d,0x41,
+0x5c,0x41,0x5d,0x41,0x5e,0x41,0x5f,0xc3,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x85,0xf6,0x0f,0x85,0x60,0x06,0x00,0x00,0x49,0x0f,0xbd,0xc7,0xc7,0x44,0x24,0x8c,
+0xce,0xfb,0xff,0xff,0xbe,0x0d,0xfc,0xff,0xff,0x48,0x83,0xf0,0x3f,0x89,0xc5,0x29,
+0xc6,0x69,0xf6,0xbf,0xcb,0xfe,0xff,0x81,0xc6,0xff,0xff,0x03,0x00,0xc1,0xfe,0x12,
+0xf7,0xde,0x48,0x89,0x7c,0x24,0x90,0x8b,0x7c,0x24,0x8c,0x41,0xba,0x03,0x00,0x00,
+0x00,0x41,0xbb,0x05,0x00,0x00,0x00,0x48,0x8d,0x1d,0x22,0x0c,0x00,0x00,0x4d,0x89,
+0xce,0x44,0x89,0xd8,0x29,0xf0,0x0f,0x88,0x1c,0x05,0x00,0x00,0x83,0xf8,0x13,0x7f,
+0x4a,0x48,0x63,0xc8,0x4c,0x89,0xf8,0x48,0xf7,0x24,0xcb,0x49,0x89,0xc4,0x49,0x89,
+0xd5,0x85,0xff,0x0f,0x88,0x57,0x05,0x00,0x00,0x83,0xff,0x14,0x0f,0x8f,0xd3,0x08,
+0x00,0x00,0x89,0xf9,0x45,0x31,0xc0,0x48,0xd3,0xe0,0x83,0xe1,0x40,0xb9,0xff,0xff,
+0xff,0xff,0x49,0x0f,0x45,0xc0,0x48,0x3d,0x3f,0x42,0x0f,0x00,0x0f,0x86,0xbe,0x04,
+0x00,0x00,0x83,0xc6,0x01,0x41,0x83,0xea,0x01,0x75,0xa6,0x44,0x8b,0x54,0x24,0x8c,
+0x48,0x8b,0x7c,0x24,0x90,0x4d,0x89,0xf1,0x41,0x29,0xea,0x44,0x89,0xd6,0x83,0xc6,
+0x3f,0x0f,0x88,0x79,0x06,0x00,0x00,0x69,0xf6,0x41,0x34,0x01,0x00,0xc1,0xfe,0x12,
+0x4c,0x89,0xf8,0x89,0xe9,0x41,0xbb,0x03,0x00,0x00,0x00,0x4c,0x89,0xcb,0x49,0xbe,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x48,0xd3,0xe0,0x48,0x89,0x44,0x24,0x90,
+0x41,0xb9,0x05,0x00,0x00,0x00,0x44,0x8d,0x66,0xfb,0x41,0x29,0xf1,0x78,0x0d,0x45,
+0x89,0xcc,0x4d,0x89,0xf0,0xb9,0xc1,0xff,0xff,0xff,0x74,0x68,0x4d,0x63,0xc9,0x48,
+0x8d,0x05,0xba,0x0a,0x00,0x00,0x45,0x31,0xc0,0xb9,0xc1,0xff,0xff,0xff,0x4c,0x89,
+0xcd,0x49,0xc1,0xf9,0x3f,0x48,0xc1,0xfd,0x3f,0x41,0x83,0xe1,0x12,0x83,0xe5,0x48,
+0x48,0x01,0xc5,0x48,0x8d,0x05,0x56,0x0a,0x00,0x00,0x49,0x01,0xc1,0x4c,0x89,0xf0,
+0x48,0x89,0xc2,0x41,0xf6,0xc4,0x01,0x74,0x1f,0x4a,0xf7,0x64,0xc5,0x00,0x47,0x0f,
+0xbf,0x2c,0x41,0x42,0x8d,0x4c,0x29,0x40,0x48,0x85,0xd2,0x78,0x08,0x48,0x0f,0xa4,
+0xc2,0x01,0x83,0xe9,0x01,0x48,0x89,0xd0,0x49,0x83,0xc0,0x01,0x41,0xd1,0xec,0x75,
+0xcf,0x49,0x89,0xd0,0x4c,0x89,0xc0,0x41,0x8d,0x2c,0x0a,0x41,0xb8,0xbf,0xff,0xff,
+0xff,0x89,0xe9,0x48,0xf7,0x64,0x24,0x90,0x41,0x29,0xe8,0xf7,0xd9,0x41,0x83,0xf8,
+0x3e,0x77,0x7f,0x49,0x89,0xc0,0x49,0x89,0xd1,0x49,0x0f,0xad,0xd0,0x49,0xd3,0xe9,
+0xf6,0xc1,0x40,0x8d,0x8d,0x80,0x00,0x00,0x00,0x4d,0x0f,0x45,0xc1,0x48,0x0f,0xa5,
+0xc2,0x48,0xd3,0xe0,0xf6,0xc1,0x40,0x48,0xb9,0x00,0x00,0x00,0x00,0xff,0xff,0xff,
+0xff,0x48,0x0f,0x45,0xd0,0x48,0x89,0xd0,0x48,0x8d,0x14,0x0a,0x48,0xb9,0xff,0xff,
+0xff,0xff,0xfd,0xff,0xff,0xff,0x48,0x39,0xd1,0x72,0x37,0x48,0xb9,0xff,0xff,0xff,
+0xff,0x00,0x00,0x00,0x80,0x48,0x8d,0x14,0x08,0x48,0xb9,0xfe,0xff,0xff,0xff,0x01,
+0x00,0x00,0x00,0x48,0x39,0xd1,0x73,0x1a,0x49,0x81,0xf8,0x3f,0x42,0x0f,0x00,0x0f,
+0x86,0x0b,0x05,0x00,0x00,0x83,0xc6,0x01,0x41,0x83,0xeb,0x01,0x0f,0x85,0xde,0xfe,
+0xff,0xff,0x8b,0x44,0x24,0x8c,0x4c,0x89,0x7c,0x24,0xa8,0x49,0x89,0xd9,0x85,0xc0,
+0x0f,0x88,0x9a,0x06,0x00,0x00,0x41,0x89,0xc0,0x48,0x8d,0x6c,0x24,0xa8,0x83,0xe0,
+0x1f,0x41,0xc1,0xf8,0x05,0x89,0xc6,0x48,0x89,0xe8,0x49,0x63,0xc8,0x48,0x8d,0x14,
+0x8d,0x00,0x00,0x00,0x00,0x4c,0x89,0x7c,0x14,0xa8,0x48,0x01,0xea,0x45,0x85,0xc0,
+0x74,0x15,0x66,0x0f,0x1f,0x44,0x00,0x00,0xc7,0x00,0x00,0x00,0x00,0x00,0x48,0x83,
+0xc0,0x04,0x48,0x39,0xc2,0x75,0xf1,0x41,0x8d,0x58,0x02,0x4c,0x63,0xd3,0x85,0xf6,
+0x74,0x50,0x41,0xbc,0x20,0x00,0x00,0x00,0x48,0x89,0xea,0x4c,0x8d,0x6c,0x8c,0xb0,
+0x45,0x31,0xdb,0x41,0x29,0xf4,0x66,0x2e,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x8b,0x02,0x45,0x89,0xda,0x44,0x89,0xe1,0x48,0x83,0xc2,0x04,0x41,0x89,0xc3,0x41,
+0xd3,0xeb,0x89,0xf1,0xd3,0xe0,0x44,0x09,0xd0,0x89,0x42,0xfc,0x49,0x39,0xd5,0x75,
+0xdf,0x48,0x63,0xdb,0x41,0x8d,0x40,0x03,0x31,0xf6,0x44,0x89,0x5c,0x9c,0xa8,0x4c,
+0x63,0xd0,0x4c,0x89,0xd0,0x31,0xc9,0xeb,0x18,0x0f,0x1f,0x80,0x00,0x00,0x00,0x00,
+0x44,0x8b,0x44,0x85,0xfc,0x48,0x8d,0x50,0xff,0x45,0x85,0xc0,0x75,0x08,0x48,0x89,
+0xd0,0x48,0x39,0xc1,0x75,0xea,0x89,0xc2,0x45,0x31,0xed,0x4c,0x8d,0x7c,0x24,0xa4,
+0x45,0x31,0xe4,0x48,0x8d,0x8c,0x24,0x18,0x01,0x00,0x00,0x49,0xbe,0x53,0x5a,0x9b,
+0xa0,0x2f,0xb8,0x44,0x00,0x85,0xc0,0x0f,0x8e,0x34,0x07,0x00,0x00,0x0f,0x1f,0x00,
+0x4c,0x63,0xda,0x8d,0x42,0xff,0x45,0x31,0xc0,0x4a,0x8d,0x1c,0x9d,0x00,0x00,0x00,
+0x00,0x48,0xc1,0xe0,0x02,0x4c,0x8d,0x54,0x1d,0x00,0x4c,0x01,0xfb,0x48,0x29,0xc3,
+0x41,0x8b,0x42,0xfc,0x49,0xc1,0xe0,0x20,0x49,0x83,0xea,0x04,0x49,0x09,0xc0,0x4c,
+0x89,0xc2,0x48,0xc1,0xea,0x09,0x48,0x89,0xd0,0x49,0xf7,0xe6,0x48,0xc1,0xea,0x0b,
+0x41,0x89,0x12,0x48,0x69,0xd2,0x00,0xca,0x9a,0x3b,0x49,0x29,0xd0,0x4c,0x39,0xd3,
+0x75,0xce,0x46,0x89,0x04,0xa9,0xeb,0x1c,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x42,0x8b,0x54,0x9d,0xfc,0x49,0x8d,0x43,0xff,0x85,0xd2,0x0f,0x85,0xef,0x03,0x00,
+0x00,0x49,0x89,0xc3,0x4d,0x39,0xdc,0x75,0xe7,0x44,0x89,0xed,0x45,0x31,0xc0,0x4d,
+0x63,0xed,0xbb,0xcd,0xcc,0xcc,0xcc,0x4c,0x8d,0x94,0x24,0xa8,0x02,0x00,0x00,0x4c,
+0x8d,0x5c,0x24,0x9f,0x4c,0x8d,0x64,0x24,0xa7,0x42,0x8b,0x14,0xa9,0x4d,0x89,0xe6,
+0x89,0xd0,0x48,0x0f,0xaf,0xc3,0x48,0xc1,0xe8,0x23,0x44,0x8d,0x3c,0x80,0x45,0x01,
+0xff,0x44,0x29,0xfa,0x83,0xc2,0x30,0x41,0x88,0x16,0x89,0xc2,0x4c,0x89,0xf0,0x49,
+0x83,0xee,0x01,0x4c,0x39,0xd8,0x75,0xd8,0x44,0x39,0xed,0x0f,0x84,0xab,0x04,0x00,
+0x00,0x45,0x31,0xf6,0x49,0x63,0xc6,0x4d,0x63,0xf8,0x49,0x29,0xc7,0x4d,0x01,0xd7,
+0x41,0x0f,0xb6,0x14,0x03,0x41,0x88,0x14,0x07,0x48,0x83,0xc0,0x01,0x83,0xf8,0x09,
+0x75,0xee,0x44,0x89,0xc0,0x49,0x83,0xed,0x01,0x45,0x8d,0x40,0x09,0x45,0x29,0xf0,
+0x41,0x83,0xfd,0xff,0x75,0x93,0x44,0x89,0xc1,0x29,0xf1,0x8d,0x71,0xff,0x41,0x83,
+0xf8,0x06,0x7e,0x48,0x80,0xbc,0x24,0xae,0x02,0x00,0x00,0x35,0x0f,0x84,0xbc,0x05,
+0x00,0x00,0x0f,0x8e,0x28,0x03,0x00,0x00,0xb8,0x05,0x00,0x00,0x00,0x41,0x80,0x7a,
+0x05,0x39,0x0f,0x85,0x0e,0x03,0x00,0x00,0x83,0xe8,0x01,0x41,0xc6,0x42,0x05,0x30,
+0x49,0x83,0xea,0x01,0x83,0xf8,0xff,0x75,0xe4,0xc6,0x84,0x24,0xa8,0x02,0x00,0x00,
+0x31,0x89,0xce,0x41,0xb8,0x01,0x00,0x00,0x00,0x83,0xc1,0x01,0x49,0x63,0xd0,0xeb,
+0x18,0x0f,0x1f,0x80,0x00,0x00,0x00,0x00,0x80,0xbc,0x14,0xa7,0x02,0x00,0x00,0x30,
+0x48,0x8d,0x42,0xff,0x75,0x08,0x48,0x89,0xc2,0x83,0xfa,0x01,0x7f,0xea,0x8d,0x41,
+0x03,0x41,0x89,0xd3,0x4c,0x63,0xc2,0x83,0xf8,0x09,0x0f,0x86,0xf0,0x02,0x00,0x00,
+0x0f,0xb6,0x84,0x24,0xa8,0x02,0x00,0x00,0x4c,0x8d,0x57,0x01,0x88,0x07,0x83,0xfa,
+0x01,0x7e,0x30,0xc6,0x47,0x01,0x2e,0xb8,0x01,0x00,0x00,0x00,0x4c,0x8d,0x94,0x24,
+0xa8,0x02,0x00,0x00,0x0f,0x1f,0x40,0x00,0x41,0x0f,0xb6,0x14,0x02,0x88,0x54,0x07,
+0x01,0x48,0x83,0xc0,0x01,0x41,0x39,0xc0,0x7f,0xee,0x41,0x8d,0x43,0xff,0x4c,0x8d,
+0x54,0x07,0x02,0x89,0xf0,0x89,0xf2,0x41,0xc6,0x02,0x65,0xc1,0xf8,0x1f,0x83,0xe0,
+0x02,0x83,0xc0,0x2b,0xf7,0xda,0x0f,0x48,0xd6,0x41,0x88,0x42,0x01,0x49,0x8d,0x72,
+0x02,0x89,0xd1,0x83,0xfa,0x63,0x7e,0x18,0x89,0xd1,0x49,0x8d,0x72,0x03,0x48,0x69,
+0xc1,0x1f,0x85,0xeb,0x51,0x48,0xc1,0xe8,0x25,0x83,0xc0,0x30,0x41,0x88,0x42,0x02,
+0xbf,0xcd,0xcc,0xcc,0xcc,0x48,0x0f,0xaf,0xcf,0x48,0xc1,0xe9,0x23,0x89,0xc8,0x48,
+0x0f,0xaf,0xc7,0x48,0xc1,0xe8,0x23,0x8d,0x3c,0x80,0x89,0xc8,0x8d,0x0c,0x89,0x01,
+0xc9,0x01,0xff,0x29,0xca,0x29,0xf8,0x83,0xc2,0x30,0x83,0xc0,0x30,0x88,0x56,0x01,
+0x88,0x06,0x48,0x8d,0x46,0x02,0x44,0x29,0xc8,0xe9,0x88,0xfa,0xff,0xff,0x66,0x90,
+0x48,0x3d,0x9f,0x86,0x01,0x00,0x0f,0x87,0x02,0x04,0x00,0x00,0x83,0xee,0x01,0xe9,
+0x31,0xfb,0xff,0xff,0x0f,0x1f,0x40,0x00,0x83,0xf8,0xed,0x0f,0x8c,0x2a,0xfb,0xff,
+0xff,0x8d,0x46,0xfb,0x48,0x98,0x4c,0x8b,0x0c,0xc3,0x85,0xff,0x0f,0x88,0x0e,0x01,
+0x00,0x00,0x39,0xef,0x0f,0x8d,0xbb,0x03,0x00,0x00,0x4c,0x89,0xf8,0x89,0xf9,0x48,
+0xd3,0xe0,0x31,0xd2,0xb9,0x01,0x00,0x00,0x00,0x49,0xf7,0xf1,0x49,0x29,0xd1,0x49,
+0x39,0xd1,0x0f,0x82,0xde,0xfa,0xff,0xff,0x31,0xc9,0x4c,0x39,0xca,0x0f,0x95,0xc1,
+0xf7,0xd9,0xe9,0xcf,0xfa,0xff,0xff,0x66,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x89,0xf9,0xf7,0xd9,0x83,0xff,0x82,0x0f,0x8c,0x48,0x01,0x00,0x00,0x48,0x0f,0xad,
+0xd0,0x49,0xc7,0xc0,0xff,0xff,0xff,0xff,0x48,0xd3,0xea,0xf6,0xc1,0x40,0x48,0x0f,
+0x45,0xc2,0x49,0xc7,0xc1,0xff,0xff,0xff,0xff,0x49,0xd3,0xe0,0x31,0xd2,0xf6,0xc1,
+0x40,0x4d,0x0f,0x45,0xc8,0x4c,0x0f,0x45,0xc2,0x4c,0x89,0xc9,0x4c,0x89,0xc2,0x45,
+0x31,0xc9,0x45,0x31,0xc0,0x48,0xf7,0xd1,0x48,0xf7,0xd2,0x4c,0x21,0xe9,0x4c,0x21,
+0xe2,0x49,0x89,0xcc,0x89,0xf9,0xf7,0xd1,0xf6,0xc1,0x40,0x41,0x0f,0x94,0xc0,0x41,
+0x0f,0x95,0xc1,0x49,0xd3,0xe1,0x49,0xd3,0xe0,0x49,0x39,0xd0,0x4c,0x89,0xc9,0x4c,
+0x19,0xe1,0xb9,0x01,0x00,0x00,0x00,0x0f,0x82,0x49,0xfa,0xff,0xff,0x4c,0x31,0xc2,
+0x4d,0x31,0xcc,0x31,0xc9,0x4c,0x09,0xe2,0x0f,0x95,0xc1,0xf7,0xd9,0xe9,0x34,0xfa,
+0xff,0xff,0x66,0x0f,0x1f,0x44,0x00,0x00,0x8d,0x86,0xcd,0xfb,0xff,0xff,0x49,0x0f,
+0xba,0xef,0x34,0x89,0x44,0x24,0x8c,0x81,0xee,0xff,0x03,0x00,0x00,0x0f,0x88,0x2d,
+0x02,0x00,0x00,0x69,0xf6,0x41,0x34,0x01,0x00,0xbd,0x0b,0x00,0x00,0x00,0xc1,0xfe,
+0x12,0xe9,0x9c,0xf9,0xff,0xff,0x66,0x2e,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x83,0xff,0xc1,0x0f,0x8c,0x7c,0x00,0x00,0x00,0x89,0xf9,0x48,0xc7,0xc0,0xff,0xff,
+0xff,0xff,0xf7,0xd9,0x48,0xd3,0xe8,0x4c,0x39,0xc8,0x0f,0x82,0xeb,0xf9,0xff,0xff,
+0x49,0xd3,0xe1,0x4c,0x89,0xf8,0xe9,0xd7,0xfe,0xff,0xff,0x0f,0x1f,0x44,0x00,0x00,
+0x49,0x83,0xff,0x01,0x19,0xc9,0x83,0xe1,0x0d,0x83,0xc1,0x61,0x49,0x83,0xff,0x01,
+0x19,0xd2,0x88,0x4f,0x01,0x83,0xe2,0xfb,0x83,0xc2,0x6e,0x49,0x83,0xff,0x01,0x19,
+0xc0,0x88,0x17,0x83,0xe0,0xf8,0x83,0xc0,0x6e,0x88,0x47,0x02,0x48,0x8d,0x47,0x03,
+0x44,0x29,0xc8,0xe9,0xde,0xf8,0xff,0xff,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x49,0x81,0xf8,0x9f,0x86,0x01,0x00,0x0f,0x87,0x32,0x03,0x00,0x00,0x83,0xee,0x01,
+0xe9,0xe3,0xfa,0xff,0xff,0x44,0x8b,0x54,0x24,0x8c,0x48,0x8b,0x7c,0x24,0x90,0x4d,
+0x89,0xf1,0x41,0x29,0xea,0x41,0x8d,0x72,0x3f,0x0f,0x1f,0x80,0x00,0x00,0x00,0x00,
+0x69,0xf6,0xbf,0xcb,0xfe,0xff,0x81,0xc6,0xff,0xff,0x03,0x00,0xc1,0xfe,0x12,0xf7,
+0xde,0xe9,0x7a,0xf9,0xff,0xff,0x48,0x98,0x80,0x84,0x04,0xa8,0x02,0x00,0x00,0x01,
+0x8d,0x71,0xff,0x41,0xb8,0x06,0x00,0x00,0x00,0xe9,0xfe,0xfc,0xff,0xff,0x66,0x90,
+0x44,0x89,0xda,0x49,0x8d,0x45,0x01,0x45,0x85,0xdb,0x0f,0x84,0x09,0xfc,0xff,0xff,
+0x49,0x89,0xc5,0xe9,0x88,0xfb,0xff,0xff,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x85,0xf6,0x0f,0x88,0x80,0x00,0x00,0x00,0x48,0x63,0xf6,0x31,0xd2,0x48,0x8d,0x46,
+0x01,0xeb,0x08,0x0f,0x1f,0x44,0x00,0x00,0x4c,0x89,0xd2,0x41,0xba,0x30,0x00,0x00,
+0x00,0x41,0x39,0xd0,0x7e,0x09,0x44,0x0f,0xb6,0x94,0x14,0xa8,0x02,0x00,0x00,0x44,
+0x88,0x14,0x17,0x4c,0x8d,0x52,0x01,0x48,0x39,0xf2,0x75,0xdc,0x48,0x01,0xf8,0x41,
+0x39,0xc8,0x0f,0x8e,0x7e,0xfd,0xff,0xff,0x48,0x01,0xfa,0xc6,0x00,0x2e,0x48,0x63,
+0xc1,0x4c,0x8d,0x94,0x24,0xa8,0x02,0x00,0x00,0x48,0x89,0xd7,0x48,0x29,0xc7,0x90,
+0x41,0x0f,0xb6,0x34,0x02,0x40,0x88,0x74,0x07,0x02,0x48,0x83,0xc0,0x01,0x41,0x39,
+0xc0,0x7f,0xed,0x41,0x29,0xcb,0x41,0x8d,0x43,0xff,0x48,0x8d,0x44,0x02,0x03,0xe9,
+0x42,0xfd,0xff,0xff,0x0f,0x1f,0x40,0x00,0x0f,0xb7,0x35,0xf1,0x04,0x00,0x00,0x41,
+0x89,0xca,0x48,0x8d,0x47,0x02,0x41,0xf7,0xda,0x66,0x89,0x37,0x85,0xc9,0x79,0x26,
+0x31,0xf6,0xc6,0x44,0x37,0x02,0x30,0x48,0x83,0xc6,0x01,0x41,0x39,0xf2,0x7f,0xf2,
+0x89,0xce,0xf7,0xd6,0x48,0x83,0xc6,0x01,0x85,0xc9,0xb9,0x01,0x00,0x00,0x00,0x48,
+0x0f,0x49,0xf1,0x48,0x01,0xf0,0x45,0x85,0xc0,0x0f,0x84,0xf7,0xfc,0xff,0xff,0x31,
+0xc9,0x4c,0x8d,0x94,0x24,0xa8,0x02,0x00,0x00,0x0f,0x1f,0x80,0x00,0x00,0x00,0x00,
+0x41,0x0f,0xb6,0x34,0x0a,0x40,0x88,0x34,0x08,0x48,0x83,0xc1,0x01,0x4c,0x39,0xc1,
+0x75,0xee,0x89,0xd2,0x48,0x01,0xd0,0xe9,0xca,0xfc,0xff,0xff,0x45,0x31,0xf6,0x90,
+0x43,0x80,0x3c,0x33,0x30,0x0f,0x85,0x49,0xfb,0xff,0xff,0x49,0x83,0xc6,0x01,0x49,
+0x83,0xfe,0x08,0x75,0xeb,0x41,0xbe,0x08,0x00,0x00,0x00,0xe9,0x34,0xfb,0xff,0xff,
+0xbd,0x0b,0x00,0x00,0x00,0xe9,0x67,0xf7,0xff,0xff,0x66,0x0f,0x1f,0x44,0x00,0x00,
+0x8b,0x74,0x24,0x8c,0xb9,0x0d,0x00,0x00,0x00,0xbb,0x02,0x00,0x00,0x00,0x48,0x8d,
+0x6c,0x24,0xa8,0x41,0xba,0x02,0x00,0x00,0x00,0xf7,0xde,0x39,0xce,0x41,0x89,0xf3,
+0x0f,0x4e,0xce,0x0f,0x1f,0x44,0x00,0x00,0x31,0xd2,0xb8,0x01,0x00,0x00,0x00,0x90,
+0x83,0xc2,0x01,0x8d,0x04,0x80,0x39,0xca,0x75,0xf6,0x89,0xc1,0x48,0x89,0xea,0x4e,
+0x8d,0x64,0x95,0x00,0x31,0xc0,0x66,0x2e,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x44,0x8b,0x02,0x48,0x83,0xc2,0x04,0x4c,0x0f,0xaf,0xc1,0x4c,0x01,0xc0,0x89,0x42,
+0xfc,0x48,0xc1,0xe8,0x20,0x49,0x39,0xd4,0x75,0xe6,0x48,0x85,0xc0,0x74,0x0b,0x83,
+0xc3,0x01,0x42,0x89,0x44,0x94,0xa8,0x4c,0x63,0xd3,0x41,0x83,0xeb,0x0d,0x45,0x85,
+0xdb,0x0f,0x8e,0x7b,0xf9,0xff,0xff,0xb9,0x0d,0x00,0x00,0x00,0x41,0x39,0xcb,0x41,
+0x0f,0x4e,0xcb,0xeb,0x93,0x44,0x8b,0x54,0x24,0x8c,0x48,0x8b,0x7c,0x24,0x90,0x4d,
+0x89,0xf1,0x41,0x29,0xea,0x41,0x8d,0x72,0x3f,0xe9,0x59,0xf7,0xff,0xff,0x48,0x8b,
+0x7c,0x24,0x90,0x4d,0x89,0xf1,0x83,0xf9,0x01,0x74,0x08,0x85,0xc9,0x75,0x18,0xa8,
+0x01,0x74,0x14,0x48,0x83,0xc0,0x01,0x48,0x3d,0x40,0x42,0x0f,0x00,0x75,0x08,0x83,
+0xc6,0x01,0xb8,0xa0,0x86,0x01,0x00,0x48,0x8d,0x8c,0x24,0xa8,0x02,0x00,0x00,0x4c,
+0x8d,0x9c,0x24,0xa2,0x02,0x00,0x00,0x49,0x89,0xc0,0x49,0xba,0xcd,0xcc,0xcc,0xcc,
+0xcc,0xcc,0xcc,0xcc,0x0f,0x1f,0x40,0x00,0x4c,0x89,0xc0,0x48,0x83,0xe9,0x01,0x49,
+0xf7,0xe2,0x48,0xc1,0xea,0x03,0x48,0x8d,0x04,0x92,0x48,0x01,0xc0,0x49,0x29,0xc0,
+0x41,0x83,0xc0,0x30,0x44,0x88,0x41,0x06,0x49,0x89,0xd0,0x49,0x39,0xcb,0x75,0xd8,
+0x8d,0x4e,0x01,0x41,0xb8,0x06,0x00,0x00,0x00,0xe9,0x7e,0xfa,0xff,0xff,0x0f,0xb6,
+0xb4,0x24,0xad,0x02,0x00,0x00,0x83,0xe6,0x01,0x41,0x83,0xf8,0x07,0x74,0x35,0x83,
+0xc0,0x08,0x41,0xbb,0x06,0x00,0x00,0x00,0x4c,0x89,0xd2,0xbb,0x01,0x00,0x00,0x00,
+0x44,0x29,0xf0,0x45,0x29,0xd3,0x66,0x2e,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,
+0x80,0x7a,0x07,0x30,0x0f,0x45,0xf3,0x48,0x83,0xc2,0x01,0x45,0x8d,0x04,0x13,0x41,
+0x39,0xc0,0x7c,0xec,0x85,0xf6,0x0f,0x84,0x24,0xfd,0xff,0xff,0xe9,0xf7,0xf9,0xff,
+0xff,0x89,0xf1,0x45,0x31,0xc0,0xf7,0xd6,0xf7,0xd9,0xe9,0x1d,0xfa,0xff,0xff,0x48,
+0xba,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x49,0x89,0xd9,0x48,0x39,0xc2,0x49,
+0x83,0xd0,0x00,0x49,0x81,0xf8,0x40,0x42,0x0f,0x00,0x75,0x09,0x83,0xc6,0x01,0x41,
+0xb8,0xa0,0x86,0x01,0x00,0x48,0x8d,0x8c,0x24,0xa8,0x02,0x00,0x00,0x4c,0x8d,0x9c,
+0x24,0xa2,0x02,0x00,0x00,0x49,0xba,0xcd,0xcc,0xcc,0xcc,0xcc,0xcc,0xcc,0xcc,0x4c,
+0x89,0xc0,0x48,0x83,0xe9,0x01,0x49,0xf7,0xe2,0x48,0xc1,0xea,0x03,0x48,0x8d,0x04,
+0x92,0x48,0x01,0xc0,0x49,0x29,0xc0,0x41,0x8d,0x40,0x30,0x49,0x89,0xd0,0x88,0x41,
+0x06,0x49,0x39,0xcb,0x75,0xd9,0xe9,0x25,0xff,0xff,0xff,0x0f,0x1f,0x44,0x00,0x00,
+0x53,0x48,0x8b,0x17,0x48,0x89,0xfb,0x4c,0x8d,0x4f,0x08,0x48,0x8d,0x42,0x20,0x48,
+0x3d,0x00,0x00,0x01,0x00,0x77,0x21,0x49,0x01,0xd1,0x4c,0x89,0xcf,0xe8,0x9e,0xf4,
+0xff,0xff,0x89,0xc0,0x48,0x03,0x03,0x48,0x8d,0x50,0x01,0x48,0x89,0x13,0xc6,0x44,
+0x03,0x08,0x0a,0x5b,0xc3,0x0f,0x1f,0x00,0x45,0x31,0xc0,0xbf,0x01,0x00,0x00,0x00,
+0x4b,0x8d,0x34,0x01,0x4c,0x29,0xc2,0x89,0xf8,0x0f,0x05,0x48,0x83,0xf8,0xfc,0x74,
+0x08,0x48,0x85,0xc0,0x7e,0x0b,0x49,0x01,0xc0,0x48,0x8b,0x13,0x49,0x39,0xd0,0x72,
+0xdf,0x48,0xc7,0x03,0x00,0x00,0x00,0x00,0xeb,0xb0,0x66,0x0f,0x1f,0x44,0x00,0x00,
+0x48,0x8b,0x17,0x4c,0x8d,0x57,0x08,0x49,0x89,0xf9,0x45,0x31,0xc0,0x4c,0x89,0xd6,
+0xbf,0x01,0x00,0x00,0x00,0x48,0x85,0xd2,0x74,0x27,0x66,0x0f,0x1f,0x44,0x00,0x00,
+0x4c,0x29,0xc2,0x89,0xf8,0x0f,0x05,0x48,0x83,0xf8,0xfc,0x74,0x0c,0x48,0x85,0xc0,
+0x7e,0x0f,0x49,0x01,0xc0,0x4b,0x8d,0x34,0x02,0x49,0x8b,0x11,0x49,0x39,0xd0,0x72,
+0xdf,0x49,0xc7,0x01,0x00,0x00,0x00,0x00,0xb8,0x3c,0x00,0x00,0x00,0x31,0xff,0x90,
+0x0f,0x05,0xeb,0xfc,0x66,0x2e,0x0f,0x1f,0x84,0x00,0x00,0x00,0x00,0x00,0x66,0x90,
+0xc4,0xff,0xc7,0xff,0xce,0xff,0xdb,0xff,0xf6,0xff,0x2b,0x00,0x95,0x00,0x6a,0x01,
+0x13,0x03,0xbd,0xff,0xba,0xff,0xb3,0xff,0xa6,0xff,0x8b,0xff,0x56,0xff,0xec,0xfe,
+0x17,0xfe,0x6e,0xfc,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xa0,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xc8,
+0x00,0x00,0x00,0x00,0x00,0x00,0x40,0x9c,0x00,0x00,0x00,0x00,0x00,0x20,0xbc,0xbe,
+0x00,0x00,0x00,0x04,0xbf,0xc9,0x1b,0x8e,0x9e,0xb5,0x70,0x2b,0xa8,0xad,0xc5,0x9d,
+0xd5,0xa6,0xcf,0xff,0x49,0x1f,0x78,0xc2,0xe0,0x8c,0xe9,0x80,0xc9,0x47,0xba,0x93,
+0x8e,0xde,0xf9,0x9d,0xfb,0xeb,0x7e,0xaa,0xcd,0xcc,0xcc,0xcc,0xcc,0xcc,0xcc,0xcc,
+0x0a,0xd7,0xa3,0x70,0x3d,0x0a,0xd7,0xa3,0x2c,0x65,0x19,0xe2,0x58,0x17,0xb7,0xd1,
+0xfd,0xce,0x61,0x84,0x11,0x77,0xcc,0xab,0x5b,0xe1,0x4d,0xc4,0xbe,0x94,0x95,0xe6,
+0xba,0x94,0x39,0x45,0xad,0x1e,0xb1,0xcf,0xa5,0xe9,0x39,0xa5,0x27,0xea,0x7f,0xa8,
+0xa1,0xe4,0xbc,0x64,0x7c,0x46,0xd0,0xdd,0x3a,0x19,0x7a,0x63,0x25,0x43,0x31,0xc0,
+0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x0a,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xe8,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
+0x10,0x27,0x00,0x00,0x00,0x00,0x00,0x00,0xa0,0x86,0x01,0x00,0x00,0x00,0x00,0x00,
+0x40,0x42,0x0f,0x00,0x00,0x00,0x00,0x00,0x80,0x96,0x98,0x00,0x00,0x00,0x00,0x00,
+0x00,0xe1,0xf5,0x05,0x00,0x00,0x00,0x00,0x00,0xca,0x9a,0x3b,0x00,0x00,0x00,0x00,
+0x00,0xe4,0x0b,0x54,0x02,0x00,0x00,0x00,0x00,0xe8,0x76,0x48,0x17,0x00,0x00,0x00,
+0x00,0x10,0xa5,0xd4,0xe8,0x00,0x00,0x00,0x00,0xa0,0x72,0x4e,0x18,0x09,0x00,0x00,
+0x00,0x40,0x7a,0x10,0xf3,0x5a,0x00,0x00,0x00,0x80,0xc6,0xa4,0x7e,0x8d,0x03,0x00,
+0x00,0x00,0xc1,0x6f,0xf2,0x86,0x23,0x00,0x00,0x00,0x8a,0x5d,0x78,0x45,0x63,0x01,
+0x00,0x00,0x64,0xa7,0xb3,0xb6,0xe0,0x0d,0x00,0x00,0xe8,0x89,0x04,0x23,0xc7,0x8a,
+0x30,0x2e,
+};
@@ -0,0 +1,414 @@
+// Formatting of printed values exactly as printf("%g"), shared by the ELF
+// runtime (compiled freestanding), the in-process backends (PrintBuffer) and
+// generated C, which embeds this file. It must stay valid C99 and C++ and may
+// only use compiler built-ins.
+
+#ifndef TACO_FORMAT_H
+#define TACO_FORMAT_H
+
+typedef unsigned long long taco_u64;
+typedef unsigned int taco_u32;
+typedef unsigned __int128 taco_u128;
+
+// Exact decimal digits of mantissa * 2^exponent (mantissa != 0): the value
+// is 0.d1d2...dn * 10^point. Big integers are little-endian 32-bit limbs.
+static inline int taco_exact_digits(taco_u64 mantissa, int exponent, char* digits, int* point)
+{
+    taco_u32 big[90];
+    int limbs = 2;
+    int scale = 0;      // Decimal places of the big integer
+    big[0] = (taco_u32)mantissa;
+    big[1] = (taco_u32)(mantissa >> 32);
+
+    if (exponent >= 0)
+    {
+        // mantissa << exponent
+        int words = exponent / 32;
+        int bits = exponent % 32;
+        for (int i = limbs - 1; i >= 0; i--)
+            big[i + words] = big[i];
+        for (int i = 0; i < words; i++)
+            big[i] = 0;
+        limbs += words;
+        if (bits)
+        {
+            taco_u32 carry = 0;
+            for (int i = 0; i < limbs; i++)
+            {
+                taco_u32 next = big[i] >> (32 - bits);
+                big[i] = (big[i] << bits) | carry;
+                carry = next;
+            }
+            big[limbs++] = carry;
+        }
+    }
+    else
+    {
+        // mantissa * 5^-exponent, with -exponent decimal places
+        scale = -exponent;
+        for (int remaining = scale; remaining > 0; remaining -= 13)
+        {
+            taco_u32 factor = 1;
+            for (int i = 0; i < (remaining < 13 ? remaining : 13); i++)
+                factor *= 5;
+            taco_u64 carry = 0;
+            for (int i = 0; i < limbs; i++)
+            {
+                taco_u64 product = (taco_u64)big[i] * factor + carry;
+                big[i] = (taco_u32)product;
+                carry = product >> 32;
+            }
+            if (carry)
+                big[limbs++] = (taco_u32)carry;
+        }
+    }
+    while (limbs > 0 && big[limbs - 1] == 0)
+        limbs--;
+
+    // Base 10^9 chunks, least significant first
+    taco_u32 chunks[100];
+    int chunkCount = 0;
+    while (limbs > 0)
+    {
+        taco_u64 remainder = 0;
+        for (int i = limbs - 1; i >= 0; i--)
+        {
+            taco_u64 current = (remainder << 32) | big[i];
+            big[i] = (taco_u32)(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        chunks[chunkCount++] = (taco_u32)remainder;
+        while (limbs > 0 && big[limbs - 1] == 0)
+            limbs--;
+    }
+
+    int count = 0;
+    for (int c = chunkCount - 1; c >= 0; c--)
+    {
+        char text[9];
+        taco_u32 chunk = chunks[c];
+        for (int i = 8; i >= 0; i--)
+        {
+            text[i] = (char)('0' + chunk % 10);
+            chunk /= 10;
+        }
+        int start = 0;
+        if (c == chunkCount - 1)
+        {
+            while (start < 8 && text[start] == '0')
+                start++;
+        }
+        for (int i = start; i < 9; i++)
+            digits[count++] = text[i];
+    }
+    *point = count - scale;
+    return count;
+}
+
+// Six significant digits of mantissa * 2^exponent (mantissa != 0), rounded
+// half to even, with 64- and 128-bit integers only: the value is scaled by a
+// power of ten so that its integer part has six digits, and the remainder
+// decides the rounding exactly. Returns 0 when the scaled value does not fit
+// (values below about 1e-14 or with many digits before the point).
+static inline int taco_fast_digits(taco_u64 mantissa, int exponent, char* digits, int* point)
+{
+    static const taco_u64 powers[20] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+        1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+        100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+        1000000000000000000ULL, 10000000000000000000ULL};
+
+    // Decimal exponent of the first digit, possibly one too small
+    int top = 63 - __builtin_clzll(mantissa) + exponent;
+    int x = top >= 0 ? top * 78913 >> 18 : -((-top * 78913 + (1 << 18) - 1) >> 18);
+
+    taco_u64 q = 0;
+    int up = 0;
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        int s = 5 - x;      // q = floor(value * 10^s)
+        int half;           // Remainder compared with one half: -1, 0 or 1
+        if (s >= 0)
+        {
+            if (s > 19)
+                return 0;
+            taco_u128 scaled = (taco_u128)mantissa * powers[s];
+            if (exponent >= 0)
+            {
+                if (exponent > 20)
+                    return 0;
+                q = (taco_u64)(scaled << exponent);
+                half = -1;
+            }
+            else
+            {
+                int k = -exponent;
+                if (k > 126)
+                    return 0;
+                q = (taco_u64)(scaled >> k);
+                taco_u128 remainder = scaled & (((taco_u128)1 << k) - 1);
+                taco_u128 midpoint = (taco_u128)1 << (k - 1);
+                half = remainder > midpoint ? 1 : remainder == midpoint ? 0 : -1;
+            }
+        }
+        else
+        {
+            if (-s > 19)
+                return 0;
+            taco_u64 divisor = powers[-s];
+            taco_u64 value = mantissa;
+            if (exponent >= 0)
+            {
+                if (exponent > 63 - (64 - __builtin_clzll(mantissa)))
+                    return 0;
+                value <<= exponent;
+            }
+            else
+            {
+                if (-exponent > 63 || divisor > (~0ULL >> -exponent))
+                    return 0;
+                divisor <<= -exponent;
+            }
+            q = value / divisor;
+            taco_u64 remainder = value % divisor;
+            half = remainder > divisor - remainder ? 1 : remainder == divisor - remainder ? 0 : -1;
+        }
+        if (q >= 1000000)
+            x++;
+        else if (q < 100000)
+            x--;
+        else
+        {
+            up = half > 0 || (half == 0 && (q & 1));
+            break;
+        }
+        if (attempt == 2)
+            return 0;
+    }
+
+    q += up;
+    if (q == 1000000)
+    {
+        q = 100000;
+        x++;
+    }
+    for (int i = 5; i >= 0; i--)
+    {
+        digits[i] = (char)('0' + q % 10);
+        q /= 10;
+    }
+    *point = x + 1;
+    return 6;
+}
+
+// 10^power for |power| < 512 as mantissa * 2^exponent with the top mantissa
+// bit set, from 10^(2^i) and 10^-(2^i) rounded to 64 bits. The result is
+// within 2^-59 of the exact value, relative.
+static inline taco_u64 taco_power_of_ten(int power, int* exponent)
+{
+    static const taco_u64 mantissas[2][9] = {
+        {0xa000000000000000ULL, 0xc800000000000000ULL, 0x9c40000000000000ULL, 0xbebc200000000000ULL,
+         0x8e1bc9bf04000000ULL, 0x9dc5ada82b70b59eULL, 0xc2781f49ffcfa6d5ULL, 0x93ba47c980e98ce0ULL,
+         0xaa7eebfb9df9de8eULL},
+        {0xcccccccccccccccdULL, 0xa3d70a3d70a3d70aULL, 0xd1b71758e219652cULL, 0xabcc77118461cefdULL,
+         0xe69594bec44de15bULL, 0xcfb11ead453994baULL, 0xa87fea27a539e9a5ULL, 0xddd0467c64bce4a1ULL,
+         0xc0314325637a193aULL}};
+    static const short exponents[2][9] = {
+        {-60, -57, -50, -37, -10, 43, 149, 362, 787},
+        {-67, -70, -77, -90, -117, -170, -276, -489, -914}};
+
+    int negative = power < 0;
+    unsigned remaining = (unsigned)(negative ? -power : power);
+    taco_u64 result = 1ULL << 63;
+    int e = -63;
+    for (int i = 0; remaining; i++, remaining >>= 1)
+    {
+        if (!(remaining & 1))
+            continue;
+        taco_u128 product = (taco_u128)result * mantissas[negative][i];
+        e += exponents[negative][i] + 64;
+        if (!(product >> 127))
+        {
+            product <<= 1;
+            e--;
+        }
+        result = (taco_u64)(product >> 64);
+    }
+    *exponent = e;
+    return result;
+}
+
+// Six significant digits of mantissa * 2^exponent (mantissa != 0) for any
+// magnitude, from the value times an approximate power of ten. The error is
+// below 2^-35 of the last digit, so the digits and the rounding are exact
+// unless the scaled value is that close to an integer or to one half; then
+// 0 is returned and taco_exact_digits decides.
+static inline int taco_approx_digits(taco_u64 mantissa, int exponent, char* digits, int* point)
+{
+    int normalize = __builtin_clzll(mantissa);
+    mantissa <<= normalize;
+    exponent -= normalize;
+
+    int top = 63 + exponent;
+    int x = top >= 0 ? top * 78913 >> 18 : -((-top * 78913 + (1 << 18) - 1) >> 18);
+
+    const taco_u64 margin = 1ULL << 32;
+    taco_u64 q = 0;
+    int up = 0;
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        int powerExponent;
+        taco_u64 power = taco_power_of_ten(5 - x, &powerExponent);
+        taco_u128 product = (taco_u128)mantissa * power;
+        int shift = -(exponent + powerExponent);
+        if (shift < 65 || shift > 127)
+            return 0;
+        q = (taco_u64)(product >> shift);
+        taco_u64 fraction = (taco_u64)((product << (128 - shift)) >> 64);
+        if (fraction < margin || fraction > ~0ULL - margin ||
+            (fraction > (1ULL << 63) - margin && fraction < (1ULL << 63) + margin))
+            return 0;
+        if (q >= 1000000)
+            x++;
+        else if (q < 100000)
+            x--;
+        else
+        {
+            up = fraction > (1ULL << 63);
+            break;
+        }
+        if (attempt == 2)
+            return 0;
+    }
+
+    q += up;
+    if (q == 1000000)
+    {
+        q = 100000;
+        x++;
+    }
+    for (int i = 5; i >= 0; i--)
+    {
+        digits[i] = (char)('0' + q % 10);
+        q /= 10;
+    }
+    *point = x + 1;
+    return 6;
+}
+
+// Format like printf("%g"): 6 significant digits rounded half to even on the
+// exact binary value, trailing zeros removed, exponent form outside [1e-4, 1e6)
+static inline unsigned taco_format_g(double value, char* out)
+{
+    taco_u64 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    char* p = out;
+    taco_u32 biased = (taco_u32)(bits >> 52) & 0x7ff;
+    taco_u64 mantissa = bits & ((1ULL << 52) - 1);
+
+    if (bits >> 63)
+        *p++ = '-';
+    if (biased == 0x7ff)
+    {
+        *p++ = mantissa ? 'n' : 'i';
+        *p++ = mantissa ? 'a' : 'n';
+        *p++ = mantissa ? 'n' : 'f';
+        return (unsigned)(p - out);
+    }
+    if (biased == 0 && mantissa == 0)
+    {
+        *p++ = '0';
+        return (unsigned)(p - out);
+    }
+
+    int exponent = -1074;
+    if (biased != 0)
+    {
+        mantissa |= 1ULL << 52;
+        exponent = (int)biased - 1075;
+    }
+
+    char digits[800];
+    int point;
+    int count = taco_fast_digits(mantissa, exponent, digits, &point);
+    if (count == 0)
+        count = taco_approx_digits(mantissa, exponent, digits, &point);
+    if (count == 0)
+    {
+        count = taco_exact_digits(mantissa, exponent, digits, &point);
+        if (count > 6)
+        {
+            int up = digits[6] > '5';
+            if (digits[6] == '5')
+            {
+                up = (digits[5] - '0') & 1;
+                for (int i = 7; i < count; i++)
+                {
+                    if (digits[i] != '0')
+                        up = 1;
+                }
+            }
+            count = 6;
+            if (up)
+            {
+                int i = 5;
+                while (i >= 0 && digits[i] == '9')
+                    digits[i--] = '0';
+                if (i < 0)
+                {
+                    digits[0] = '1';
+                    count = 1;
+                    point++;
+                }
+                else
+                {
+                    digits[i]++;
+                }
+            }
+        }
+    }
+    while (count > 1 && digits[count - 1] == '0')
+        count--;
+
+    int x = point - 1;      // Exponent of the first digit
+    if (x < -4 || x >= 6)
+    {
+        *p++ = digits[0];
+        if (count > 1)
+        {
+            *p++ = '.';
+            for (int i = 1; i < count; i++)
+                *p++ = digits[i];
+        }
+        *p++ = 'e';
+        *p++ = x < 0 ? '-' : '+';
+        int magnitude = x < 0 ? -x : x;
+        if (magnitude >= 100)
+            *p++ = (char)('0' + magnitude / 100);
+        *p++ = (char)('0' + magnitude / 10 % 10);
+        *p++ = (char)('0' + magnitude % 10);
+    }
+    else if (x >= 0)
+    {
+        for (int i = 0; i <= x; i++)
+            *p++ = i < count ? digits[i] : '0';
+        if (count > x + 1)
+        {
+            *p++ = '.';
+            for (int i = x + 1; i < count; i++)
+                *p++ = digits[i];
+        }
+    }
+    else
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = 0; i < -x - 1; i++)
+            *p++ = '0';
+        for (int i = 0; i < count; i++)
+            *p++ = digits[i];
+    }
+    return (unsigned)(p - out);
+}
+
+#endif // TACO_FORMAT_H
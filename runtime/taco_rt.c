@@ -0,0 +1,71 @@
+// Print runtime linked into executables written by the ELF backend. It is
+// compiled freestanding (no libc) into a flat blob that taco embeds; the
+// blob starts with jumps to the entry points and only uses the write and
+// exit system calls. Values are formatted by taco_format.h.
+
+#include "taco_format.h"
+
+typedef unsigned long u64;
+
+#define TACO_RT_CAPACITY (1 << 16)
+
+// Output buffer in the executable's .bss
+struct taco_output
+{
+    u64 length;
+    char data[TACO_RT_CAPACITY];
+};
+
+void taco_rt_print(struct taco_output* out, double value);
+void taco_rt_exit(struct taco_output* out);
+
+// Entry points at fixed offsets: print at 0, exit at 5
+__asm__(
+    "    .section .text.entry,\"ax\",@progbits\n"
+    "    .byte 0xe9\n"
+    "    .long taco_rt_print - . - 4\n"
+    "    .byte 0xe9\n"
+    "    .long taco_rt_exit - . - 4\n"
+    "    .text\n");
+
+static long sys_write(int fd, const char* buffer, u64 length)
+{
+    long result;
+    __asm__ volatile("syscall" : "=a"(result) : "a"(1), "D"(fd), "S"(buffer), "d"(length) : "rcx", "r11", "memory");
+    return result;
+}
+
+static void __attribute__((noreturn)) sys_exit(int status)
+{
+    for (;;)
+        __asm__ volatile("syscall" : : "a"(60), "D"(status) : "rcx", "r11", "memory");
+}
+
+static void flush(struct taco_output* out)
+{
+    u64 done = 0;
+    while (done < out->length)
+    {
+        long written = sys_write(1, out->data + done, out->length - done);
+        if (written == -4)      // EINTR
+            continue;
+        if (written <= 0)
+            break;
+        done += (u64)written;
+    }
+    out->length = 0;
+}
+
+void taco_rt_print(struct taco_output* out, double value)
+{
+    if (out->length + 32 > TACO_RT_CAPACITY)
+        flush(out);
+    out->length += taco_format_g(value, out->data + out->length);
+    out->data[out->length++] = '\n';
+}
+
+void taco_rt_exit(struct taco_output* out)
+{
+    flush(out);
+    sys_exit(0);
+}
@@ -0,0 +1,400 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include "../include/optimizer.h"
+#include "../include/context.h"
+
+// Operand patterns of the rule table
+enum class OperandPattern
+{
+    ANY,            // Any operand (binds x)
+    ZERO,           // Literal 0
+    ONE,            // Literal 1
+    NONZERO,        // Any non-zero literal
+    SAME,           // Same operand as the left one
+    POWER_OF_TWO    // Literal 2^k whose reciprocal is exact
+};
+
+// Replacements of the rule table
+enum class Rewrite
+{
+    LEFT,           // t = x (left operand)
+    RIGHT,          // t = x (right operand)
+    ZERO,           // t = 0
+    ONE,            // t = 1
+    LEFT_TRUTH,     // t = x != 0 (left operand)
+    RIGHT_TRUTH,    // t = x != 0 (right operand)
+    RECIPROCAL      // t = x * (1 / c)
+};
+
+// Algebraic identity: "opcode left right => rewrite"
+struct AlgebraicRule
+{
+    const char* text;
+    TACOpcode opcode;
+    OperandPattern left;
+    OperandPattern right;
+    Rewrite rewrite;
+    bool fastMathOnly;      // Not exact for NaN, infinities or signed zeros
+};
+
+static const AlgebraicRule algebraicRules[] =
+{
+    // Exact under IEEE double semantics
+    {"x * 1 => x",          TACOpcode::MUL, OperandPattern::ANY,     OperandPattern::ONE,          Rewrite::LEFT,        false},
+    {"1 * x => x",          TACOpcode::MUL, OperandPattern::ONE,     OperandPattern::ANY,          Rewrite::RIGHT,       false},
+    {"x / 1 => x",          TACOpcode::DIV, OperandPattern::ANY,     OperandPattern::ONE,          Rewrite::LEFT,        false},
+    {"x - 0 => x",          TACOpcode::SUB, OperandPattern::ANY,     OperandPattern::ZERO,         Rewrite::LEFT,        false},
+    {"x / 2^k => x * 2^-k", TACOpcode::DIV, OperandPattern::ANY,     OperandPattern::POWER_OF_TWO, Rewrite::RECIPROCAL,  false},
+    {"x < x => 0",          TACOpcode::LT,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ZERO,        false},
+    {"x > x => 0",          TACOpcode::GT,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ZERO,        false},
+    {"x && 0 => 0",         TACOpcode::AND, OperandPattern::ANY,     OperandPattern::ZERO,         Rewrite::ZERO,        false},
+    {"0 && x => 0",         TACOpcode::AND, OperandPattern::ZERO,    OperandPattern::ANY,          Rewrite::ZERO,        false},
+    {"x && c => x != 0",    TACOpcode::AND, OperandPattern::ANY,     OperandPattern::NONZERO,      Rewrite::LEFT_TRUTH,  false},
+    {"c && x => x != 0",    TACOpcode::AND, OperandPattern::NONZERO, OperandPattern::ANY,          Rewrite::RIGHT_TRUTH, false},
+    {"x || c => 1",         TACOpcode::OR,  OperandPattern::ANY,     OperandPattern::NONZERO,      Rewrite::ONE,         false},
+    {"c || x => 1",         TACOpcode::OR,  OperandPattern::NONZERO, OperandPattern::ANY,          Rewrite::ONE,         false},
+    {"x || 0 => x != 0",    TACOpcode::OR,  OperandPattern::ANY,     OperandPattern::ZERO,         Rewrite::LEFT_TRUTH,  false},
+    {"0 || x => x != 0",    TACOpcode::OR,  OperandPattern::ZERO,    OperandPattern::ANY,          Rewrite::RIGHT_TRUTH, false},
+
+    // Only with --fast-math
+    {"x + 0 => x",          TACOpcode::ADD, OperandPattern::ANY,     OperandPattern::ZERO,         Rewrite::LEFT,        true},
+    {"0 + x => x",          TACOpcode::ADD, OperandPattern::ZERO,    OperandPattern::ANY,          Rewrite::RIGHT,       true},
+    {"x - x => 0",          TACOpcode::SUB, OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ZERO,        true},
+    {"x * 0 => 0",          TACOpcode::MUL, OperandPattern::ANY,     OperandPattern::ZERO,         Rewrite::ZERO,        true},
+    {"0 * x => 0",          TACOpcode::MUL, OperandPattern::ZERO,    OperandPattern::ANY,          Rewrite::ZERO,        true},
+    {"0 / x => 0",          TACOpcode::DIV, OperandPattern::ZERO,    OperandPattern::ANY,          Rewrite::ZERO,        true},
+    {"x / x => 1",          TACOpcode::DIV, OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ONE,         true},
+    {"x == x => 1",         TACOpcode::EQ,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ONE,         true},
+    {"x <= x => 1",         TACOpcode::LE,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ONE,         true},
+    {"x >= x => 1",         TACOpcode::GE,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ONE,         true},
+    {"x != x => 0",         TACOpcode::NE,  OperandPattern::ANY,     OperandPattern::SAME,         Rewrite::ZERO,        true},
+};
+
+// Value of a numeric literal
+static bool literalValue(const std::string& operand, double& value)
+{
+    if (!isNumericLiteral(operand))
+        return false;
+    value = std::strtod(operand.c_str(), nullptr);
+    return true;
+}
+
+// Check if an operand matches a pattern
+static bool matchOperand(OperandPattern pattern, const std::string& operand, const std::string& left)
+{
+    double value = 0.0;
+    switch (pattern)
+    {
+        case OperandPattern::ANY:
+            return true;
+        case OperandPattern::ZERO:
+            return literalValue(operand, value) && value == 0.0;
+        case OperandPattern::ONE:
+            return literalValue(operand, value) && value == 1.0;
+        case OperandPattern::NONZERO:
+            return literalValue(operand, value) && value != 0.0;
+        case OperandPattern::SAME:
+            return operand == left;
+        case OperandPattern::POWER_OF_TWO:
+        {
+            if (!literalValue(operand, value) || value == 0.0)
+                return false;
+            int exponent = 0;
+            double mantissa = std::frexp(value, &exponent);
+            // 2^k with 1/2^k a normal double
+            return std::fabs(mantissa) == 0.5 && exponent > -1021 && exponent < 1022;
+        }
+    }
+    return false;
+}
+
+// Evaluate an operation on two constants the way the generated C code would
+static bool foldConstants(TACOpcode opcode, double a, double b, double& result)
+{
+    switch (opcode)
+    {
+        case TACOpcode::ADD: result = a + b; break;
+        case TACOpcode::SUB: result = a - b; break;
+        case TACOpcode::MUL: result = a * b; break;
+        case TACOpcode::DIV: result = a / b; break;
+        case TACOpcode::LT:  result = a < b; break;
+        case TACOpcode::GT:  result = a > b; break;
+        case TACOpcode::LE:  result = a <= b; break;
+        case TACOpcode::GE:  result = a >= b; break;
+        case TACOpcode::EQ:  result = a == b; break;
+        case TACOpcode::NE:  result = a != b; break;
+        case TACOpcode::AND: result = a && b; break;
+        case TACOpcode::OR:  result = a || b; break;
+        case TACOpcode::NOT: result = !a; break;
+        default: return false;
+    }
+    // Infinities and NaN have no literal form
+    return std::isfinite(result);
+}
+
+// Check if an opcode always produces 0 or 1
+static bool isBoolean(TACOpcode opcode)
+{
+    switch (opcode)
+    {
+        case TACOpcode::LT: case TACOpcode::GT: case TACOpcode::LE: case TACOpcode::GE:
+        case TACOpcode::EQ: case TACOpcode::NE: case TACOpcode::AND: case TACOpcode::OR:
+        case TACOpcode::NOT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Split "x + c", "c + x" or "x - c" into x and the signed constant
+static bool splitAdditive(const TACInstruction& instr, std::string& var, double& constant)
+{
+    double value = 0.0;
+    if (instr.opcode == TACOpcode::ADD && literalValue(instr.arg2, value) && !isNumericLiteral(instr.arg1))
+    {
+        var = instr.arg1;
+        constant = value;
+        return true;
+    }
+    if (instr.opcode == TACOpcode::ADD && literalValue(instr.arg1, value) && !isNumericLiteral(instr.arg2))
+    {
+        var = instr.arg2;
+        constant = value;
+        return true;
+    }
+    if (instr.opcode == TACOpcode::SUB && literalValue(instr.arg2, value) && !isNumericLiteral(instr.arg1))
+    {
+        var = instr.arg1;
+        constant = -value;
+        return true;
+    }
+    return false;
+}
+
+// Split "x * c" or "c * x" into x and the constant
+static bool splitMultiplicative(const TACInstruction& instr, std::string& var, double& constant)
+{
+    if (instr.opcode != TACOpcode::MUL)
+        return false;
+    double value = 0.0;
+    if (literalValue(instr.arg2, value) && !isNumericLiteral(instr.arg1))
+    {
+        var = instr.arg1;
+        constant = value;
+        return true;
+    }
+    if (literalValue(instr.arg1, value) && !isNumericLiteral(instr.arg2))
+    {
+        var = instr.arg2;
+        constant = value;
+        return true;
+    }
+    return false;
+}
+
+// Rewrite an instruction with the rule table; returns the applied rule or nullptr
+static const char* applyRules(TACInstruction& instr, const OptimizationOptions& options)
+{
+    for (const auto& rule : algebraicRules)
+    {
+        if (rule.opcode != instr.opcode || (rule.fastMathOnly && !options.fastMath))
+            continue;
+        if (!matchOperand(rule.left, instr.arg1, instr.arg1) || !matchOperand(rule.right, instr.arg2, instr.arg1))
+            continue;
+
+        switch (rule.rewrite)
+        {
+            case Rewrite::LEFT:
+                instr = TACInstruction(TACOpcode::ASSIGN, instr.result, instr.arg1);
+                break;
+            case Rewrite::RIGHT:
+                instr = TACInstruction(TACOpcode::ASSIGN, instr.result, instr.arg2);
+                break;
+            case Rewrite::ZERO:
+                instr = TACInstruction(TACOpcode::ASSIGN, instr.result, "0");
+                break;
+            case Rewrite::ONE:
+                instr = TACInstruction(TACOpcode::ASSIGN, instr.result, "1");
+                break;
+            case Rewrite::LEFT_TRUTH:
+                instr = TACInstruction(TACOpcode::NE, instr.result, instr.arg1, "0");
+                break;
+            case Rewrite::RIGHT_TRUTH:
+                instr = TACInstruction(TACOpcode::NE, instr.result, instr.arg2, "0");
+                break;
+            case Rewrite::RECIPROCAL:
+            {
+                double divisor = std::strtod(instr.arg2.c_str(), nullptr);
+                instr = TACInstruction(TACOpcode::MUL, instr.result, instr.arg1, formatNumericLiteral(1.0 / divisor));
+                break;
+            }
+        }
+        return rule.text;
+    }
+    return nullptr;
+}
+
+// Rewrites that look at the definition of an operand within the block
+static const char* applyDefinitionRules(TACInstruction& instr, const LocalDefinitions& defs,
+                                        const OptimizationOptions& options)
+{
+    // !!x => x != 0
+    if (instr.opcode == TACOpcode::NOT)
+    {
+        const TACInstruction* inner = defs.find(instr.arg1);
+        if (inner && inner->opcode == TACOpcode::NOT)
+        {
+            instr = TACInstruction(TACOpcode::NE, instr.result, inner->arg1, "0");
+            return "!!x => x != 0";
+        }
+    }
+
+    // b != 0 => b when b is already 0 or 1
+    double value = 0.0;
+    if (instr.opcode == TACOpcode::NE && literalValue(instr.arg2, value) && value == 0.0)
+    {
+        const TACInstruction* inner = defs.find(instr.arg1);
+        if (inner && isBoolean(inner->opcode))
+        {
+            instr = TACInstruction(TACOpcode::ASSIGN, instr.result, instr.arg1);
+            return "b != 0 => b";
+        }
+    }
+
+    if (!options.fastMath)
+        return nullptr;
+
+    // (x + c1) + c2 => x + (c1 + c2), also with subtraction
+    std::string outerVar;
+    double outerConstant = 0.0;
+    if (splitAdditive(instr, outerVar, outerConstant))
+    {
+        const TACInstruction* inner = defs.find(outerVar);
+        std::string innerVar;
+        double innerConstant = 0.0;
+        if (inner && splitAdditive(*inner, innerVar, innerConstant))
+        {
+            double combined = innerConstant + outerConstant;
+            if (!std::isfinite(combined))
+                return nullptr;
+            if (combined < 0.0)
+                instr = TACInstruction(TACOpcode::SUB, instr.result, innerVar, formatNumericLiteral(-combined));
+            else
+                instr = TACInstruction(TACOpcode::ADD, instr.result, innerVar, formatNumericLiteral(combined));
+            return "(x + c1) + c2 => x + (c1 + c2)";
+        }
+    }
+
+    // (x * c1) * c2 => x * (c1 * c2)
+    if (splitMultiplicative(instr, outerVar, outerConstant))
+    {
+        const TACInstruction* inner = defs.find(outerVar);
+        std::string innerVar;
+        double innerConstant = 0.0;
+        if (inner && splitMultiplicative(*inner, innerVar, innerConstant))
+        {
+            double combined = innerConstant * outerConstant;
+            if (!std::isfinite(combined))
+                return nullptr;
+            instr = TACInstruction(TACOpcode::MUL, instr.result, innerVar, formatNumericLiteral(combined));
+            return "(x * c1) * c2 => x * (c1 * c2)";
+        }
+    }
+
+    return nullptr;
+}
+
+// Rule-based algebraic simplification: constant folding, identities from the
+// rule table (IEEE-exact ones always, the rest with --fast-math), !!x, and
+// reassociation of constant chains with --fast-math. Branches on constants
+// become gotos or disappear.
+int simplifyAlgebraic(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context)
+{
+    std::map<std::string, int> applied;
+    LocalDefinitions defs;
+    std::vector<TACInstruction> result;
+    result.reserve(tac.size());
+
+    for (auto instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL)
+        {
+            defs.clear();
+            result.push_back(instr);
+            continue;
+        }
+
+        // Constants assigned earlier in the block feed straight into folding
+        for (std::string* operand : {&instr.arg1, &instr.arg2})
+        {
+            const TACInstruction* def = operand->empty() ? nullptr : defs.find(*operand);
+            if (def && def->opcode == TACOpcode::ASSIGN && isNumericLiteral(def->arg1))
+                *operand = def->arg1;
+        }
+
+        // Branches on constants
+        double value = 0.0;
+        if ((instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE) &&
+            literalValue(instr.arg1, value))
+        {
+            bool taken = (instr.opcode == TACOpcode::IF_TRUE) == (value != 0.0);
+            if (taken)
+                result.push_back(TACInstruction(TACOpcode::GOTO, instr.result));
+            applied["constant branch"]++;
+            defs.clear();
+            continue;
+        }
+
+        if (isControlFlow(instr.opcode))
+        {
+            defs.clear();
+            result.push_back(instr);
+            continue;
+        }
+
+        if (instr.opcode != TACOpcode::PRINT && instr.opcode != TACOpcode::ASSIGN)
+        {
+            // Constant folding
+            double a = 0.0;
+            double b = 0.0;
+            double folded = 0.0;
+            bool unary = instr.opcode == TACOpcode::NOT;
+            if (literalValue(instr.arg1, a) && (unary || literalValue(instr.arg2, b)) &&
+                foldConstants(instr.opcode, a, b, folded))
+            {
+                instr = TACInstruction(TACOpcode::ASSIGN, instr.result, formatNumericLiteral(folded));
+                applied["constant folding"]++;
+            }
+            else if (const char* rule = applyRules(instr, options))
+            {
+                applied[rule]++;
+            }
+            else if (const char* rule = applyDefinitionRules(instr, defs, options))
+            {
+                applied[rule]++;
+            }
+        }
+
+        defs.record(instr);
+        result.push_back(instr);
+    }
+
+    tac.swap(result);
+
+    int changes = 0;
+    for (const auto& entry : applied)
+        changes += entry.second;
+
+    if (options.logReport && changes > 0)
+    {
+        context.logger << "Algebraic simplification:";
+        for (const auto& entry : applied)
+            context.logger << " [" << entry.first << "] x" << entry.second;
+        context.logger << std::endl;
+    }
+
+    return changes;
+}
@@ -0,0 +1,432 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include "../include/asmgen.h"
+#include "../include/cfg.h"
+
+// Flags test after ucomisd: SIMPLE is one condition code; equality needs a
+// second test, since an unordered compare (NaN) sets ZF as well as PF
+struct AsmCondition
+{
+    enum Kind { SIMPLE, EQUAL, NOT_EQUAL } kind;
+    std::string code;       // Condition code suffix of a SIMPLE test
+
+    AsmCondition negated() const
+    {
+        static const std::unordered_map<std::string, std::string> opposite = {
+            {"a", "be"}, {"be", "a"}, {"ae", "b"}, {"b", "ae"}, {"p", "np"}, {"np", "p"}
+        };
+        if (kind == EQUAL)
+            return AsmCondition{NOT_EQUAL, ""};
+        if (kind == NOT_EQUAL)
+            return AsmCondition{EQUAL, ""};
+        return AsmCondition{SIMPLE, opposite.at(code)};
+    }
+};
+
+// Names in order of first appearance and literals of the program
+void AsmCodeGenerator::collectNames(const std::vector<TACInstruction>& tac)
+{
+    std::unordered_set<std::string> seen;
+    names.clear();
+    literals.clear();
+    literalValues.clear();
+
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+        {
+            if (operand->empty() || (operand == &instr.result && !writesResult(instr.opcode)))
+                continue;
+            if (isNumericLiteral(*operand))
+            {
+                if (literals.emplace(*operand, literalValues.size()).second)
+                    literalValues.push_back(std::strtod(operand->c_str(), nullptr));
+            }
+            else if (seen.insert(*operand).second)
+            {
+                names.push_back(*operand);
+            }
+        }
+    }
+}
+
+// Give the most used names a register: every use or definition counts 8^depth,
+// where depth is the number of loops around the instruction
+void AsmCodeGenerator::allocateRegisters(const std::vector<TACInstruction>& tac)
+{
+    registers.clear();
+
+    ControlFlowGraph cfg(tac);
+    const std::vector<BasicBlock>& blocks = cfg.getBlocks();
+    std::vector<int> depth(blocks.size(), 0);
+    for (const auto& loop : cfg.findLoops())
+    {
+        for (int block : loop.blocks)
+            depth[block]++;
+    }
+
+    std::unordered_map<std::string, double> weight;
+    for (const auto& block : blocks)
+    {
+        double blockWeight = 1;
+        for (int i = 0; i < std::min(depth[block.id], 6); i++)
+            blockWeight *= 8;
+        for (const auto& instr : block.instructions)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+            {
+                if (operand->empty() || isNumericLiteral(*operand) ||
+                    (operand == &instr.result && !writesResult(instr.opcode)))
+                    continue;
+                weight[*operand] += blockWeight;
+            }
+        }
+    }
+
+    // Heaviest names first, ties in order of first appearance
+    std::vector<std::string> ranked = names;
+    std::stable_sort(ranked.begin(), ranked.end(), [&](const std::string& a, const std::string& b) {
+        return weight[a] > weight[b];
+    });
+    for (size_t i = 0; i < ranked.size() && i < registerCount; i++)
+        registers[ranked[i]] = "%xmm" + std::to_string(i + 2);
+
+    names.erase(std::remove_if(names.begin(), names.end(), [&](const std::string& name) {
+        return registers.count(name) > 0;
+    }), names.end());
+}
+
+// Register or rip-relative memory operand of a name or literal
+std::string AsmCodeGenerator::operand(const std::string& name)
+{
+    auto reg = registers.find(name);
+    if (reg != registers.end())
+        return reg->second;
+    auto literal = literals.find(name);
+    if (literal != literals.end())
+        return ".Lk" + std::to_string(literal->second) + "(%rip)";
+    return ".Lv_" + name + "(%rip)";
+}
+
+std::string AsmCodeGenerator::generate(const std::vector<TACInstruction>& tac)
+{
+    collectNames(tac);
+    allocateRegisters(tac);
+
+    ControlFlowGraph cfg(tac);
+    TemporaryLiveness liveness(cfg);
+    std::unordered_set<std::string> labels;
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL)
+            labels.insert(instr.result);
+    }
+
+    std::ostringstream oss;
+    auto isRegister = [&](const std::string& name) { return registers.count(name) > 0; };
+    auto label = [&](const std::string& name) { return labels.count(name) ? ".Ll_" + name : std::string(".Lexit"); };
+
+    auto load = [&](const std::string& reg, const std::string& name) {
+        std::string source = operand(name);
+        if (!isRegister(name))
+            oss << "    movsd " << source << ", " << reg << "\n";
+        else if (source != reg)
+            oss << "    movapd " << source << ", " << reg << "\n";
+    };
+    auto store = [&](const std::string& name, const std::string& reg) {
+        std::string target = operand(name);
+        if (!isRegister(name))
+            oss << "    movsd " << reg << ", " << target << "\n";
+        else if (target != reg)
+            oss << "    movapd " << reg << ", " << target << "\n";
+    };
+
+    // Flags of x compared with y; x must be in a register for ucomisd
+    auto compareFlags = [&](const std::string& x, const std::string& y) {
+        std::string reg = isRegister(x) ? operand(x) : "%xmm0";
+        load(reg, x);
+        oss << "    ucomisd " << operand(y) << ", " << reg << "\n";
+    };
+
+    // Operands and condition code are arranged so that NaN fails the relation
+    auto comparison = [&](TACOpcode opcode, const std::string& a, const std::string& b) -> AsmCondition {
+        switch (opcode)
+        {
+            case TACOpcode::LT: compareFlags(b, a); return AsmCondition{AsmCondition::SIMPLE, "a"};
+            case TACOpcode::LE: compareFlags(b, a); return AsmCondition{AsmCondition::SIMPLE, "ae"};
+            case TACOpcode::GT: compareFlags(a, b); return AsmCondition{AsmCondition::SIMPLE, "a"};
+            case TACOpcode::GE: compareFlags(a, b); return AsmCondition{AsmCondition::SIMPLE, "ae"};
+            case TACOpcode::EQ: compareFlags(a, b); return AsmCondition{AsmCondition::EQUAL, ""};
+            default: compareFlags(a, b); return AsmCondition{AsmCondition::NOT_EQUAL, ""};
+        }
+    };
+
+    // Flags for "value is true" (non-zero or NaN)
+    auto truth = [&](const std::string& name) -> AsmCondition {
+        std::string reg = isRegister(name) ? operand(name) : "%xmm0";
+        load(reg, name);
+        oss << "    xorpd %xmm1, %xmm1\n";
+        oss << "    ucomisd %xmm1, " << reg << "\n";
+        return AsmCondition{AsmCondition::NOT_EQUAL, ""};
+    };
+
+    // al = condition ? 1 : 0
+    auto setFlag = [&](const AsmCondition& condition) {
+        if (condition.kind == AsmCondition::SIMPLE)
+        {
+            oss << "    set" << condition.code << " %al\n";
+            return;
+        }
+        bool equal = condition.kind == AsmCondition::EQUAL;
+        oss << "    set" << (equal ? "e" : "ne") << " %al\n";
+        oss << "    set" << (equal ? "np" : "p") << " %cl\n";
+        oss << "    " << (equal ? "andb" : "orb") << " %cl, %al\n";
+    };
+
+    // result = (double)al
+    auto storeFlag = [&](const std::string& result) {
+        std::string reg = isRegister(result) ? operand(result) : "%xmm0";
+        oss << "    movzbl %al, %eax\n";
+        oss << "    cvtsi2sdl %eax, " << reg << "\n";
+        store(result, reg);
+    };
+
+    auto jumpIf = [&](const AsmCondition& condition, const std::string& target) {
+        if (condition.kind == AsmCondition::SIMPLE)
+        {
+            oss << "    j" << condition.code << " " << label(target) << "\n";
+        }
+        else if (condition.kind == AsmCondition::EQUAL)
+        {
+            oss << "    jp 1f\n";
+            oss << "    je " << label(target) << "\n";
+            oss << "1:\n";
+        }
+        else
+        {
+            oss << "    jp " << label(target) << "\n";
+            oss << "    jne " << label(target) << "\n";
+        }
+    };
+
+    oss << "# Generated x86-64 assembly from TACO compiler\n";
+    oss << "    .text\n";
+    oss << "    .globl main\n";
+    oss << "    .type main, @function\n";
+    oss << "main:\n";
+    oss << "    subq $8, %rsp\n";
+    for (size_t i = 0; i < registers.size(); i++)
+        oss << "    xorpd %xmm" << i + 2 << ", %xmm" << i + 2 << "\n";
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+        switch (instr.opcode)
+        {
+            case TACOpcode::ADD:
+            case TACOpcode::SUB:
+            case TACOpcode::MUL:
+            case TACOpcode::DIV:
+            {
+                const char* mnemonic = instr.opcode == TACOpcode::ADD ? "addsd" : instr.opcode == TACOpcode::SUB ? "subsd" :
+                                       instr.opcode == TACOpcode::MUL ? "mulsd" : "divsd";
+                // Compute in the result's register unless that would overwrite arg2 first
+                std::string reg = "%xmm0";
+                if (isRegister(instr.result) && operand(instr.result) != operand(instr.arg2))
+                    reg = operand(instr.result);
+                load(reg, instr.arg1);
+                oss << "    " << mnemonic << " " << operand(instr.arg2) << ", " << reg << "\n";
+                store(instr.result, reg);
+                break;
+            }
+
+            case TACOpcode::ASSIGN:
+                if (isRegister(instr.result))
+                {
+                    load(operand(instr.result), instr.arg1);
+                }
+                else
+                {
+                    std::string reg = isRegister(instr.arg1) ? operand(instr.arg1) : "%xmm0";
+                    load(reg, instr.arg1);
+                    store(instr.result, reg);
+                }
+                break;
+
+            case TACOpcode::LT:
+            case TACOpcode::GT:
+            case TACOpcode::LE:
+            case TACOpcode::GE:
+            case TACOpcode::EQ:
+            case TACOpcode::NE:
+            {
+                AsmCondition condition = comparison(instr.opcode, instr.arg1, instr.arg2);
+
+                // Compare and branch on the flags if only the branch reads the result
+                if (isTemporary(instr.result) && i + 1 < tac.size() &&
+                    (tac[i + 1].opcode == TACOpcode::IF_TRUE || tac[i + 1].opcode == TACOpcode::IF_FALSE) &&
+                    tac[i + 1].arg1 == instr.result && liveness.isDeadAfter(i + 1, instr.result))
+                {
+                    jumpIf(tac[i + 1].opcode == TACOpcode::IF_TRUE ? condition : condition.negated(), tac[i + 1].result);
+                    i++;
+                    break;
+                }
+                setFlag(condition);
+                storeFlag(instr.result);
+                break;
+            }
+
+            case TACOpcode::AND:
+            case TACOpcode::OR:
+                setFlag(truth(instr.arg1));
+                oss << "    movb %al, %dl\n";
+                setFlag(truth(instr.arg2));
+                oss << "    " << (instr.opcode == TACOpcode::AND ? "andb" : "orb") << " %dl, %al\n";
+                storeFlag(instr.result);
+                break;
+
+            case TACOpcode::NOT:
+                setFlag(truth(instr.arg1).negated());
+                storeFlag(instr.result);
+                break;
+
+            case TACOpcode::LABEL:
+                oss << label(instr.result) << ":\n";
+                break;
+
+            case TACOpcode::GOTO:
+                oss << "    jmp " << label(instr.result) << "\n";
+                break;
+
+            case TACOpcode::IF_FALSE:
+                jumpIf(truth(instr.arg1).negated(), instr.result);
+                break;
+
+            case TACOpcode::IF_TRUE:
+                jumpIf(truth(instr.arg1), instr.result);
+                break;
+
+            case TACOpcode::PRINT:
+                load("%xmm0", instr.arg1);
+                oss << "    call taco_print\n";
+                break;
+        }
+    }
+
+    oss << ".Lexit:\n";
+    oss << "    xorl %eax, %eax\n";
+    oss << "    addq $8, %rsp\n";
+    oss << "    ret\n";
+    oss << "    .size main, .-main\n\n";
+
+    // Print runtime: printf("%g\n", xmm0), keeping the registers of names
+    // (all SSE registers are caller-saved)
+    size_t frame = registers.size() * 8 + (registers.size() % 2 == 0 ? 8 : 0);
+    oss << "# Runtime: print xmm0 as printf(\"%g\\n\")\n";
+    oss << "taco_print:\n";
+    oss << "    subq $" << frame << ", %rsp\n";
+    for (size_t i = 0; i < registers.size(); i++)
+        oss << "    movsd %xmm" << i + 2 << ", " << i * 8 << "(%rsp)\n";
+    oss << "    leaq .Lformat(%rip), %rdi\n";
+    oss << "    movl $1, %eax\n";
+    oss << "    call printf@PLT\n";
+    for (size_t i = 0; i < registers.size(); i++)
+        oss << "    movsd " << i * 8 << "(%rsp), %xmm" << i + 2 << "\n";
+    oss << "    addq $" << frame << ", %rsp\n";
+    oss << "    ret\n\n";
+
+    // Literals as exact bit patterns
+    oss << "    .section .rodata\n";
+    oss << "    .p2align 3\n";
+    std::vector<std::string> literalText(literalValues.size());
+    for (const auto& literal : literals)
+        literalText[literal.second] = literal.first;
+    for (size_t i = 0; i < literalValues.size(); i++)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &literalValues[i], sizeof(bits));
+        oss << ".Lk" << i << ": .quad 0x" << std::hex << std::setw(16) << std::setfill('0') << bits
+            << std::dec << "    # " << literalText[i] << "\n";
+    }
+    oss << ".Lformat: .string \"%g\\n\"\n";
+
+    // Names start at 0
+    if (!names.empty())
+    {
+        oss << "    .bss\n";
+        oss << "    .p2align 3\n";
+        for (const auto& name : names)
+            oss << ".Lv_" << name << ": .zero 8\n";
+    }
+    oss << "    .section .note.GNU-stack,\"\",@progbits\n";
+
+    return oss.str();
+}
+
+// Write generated assembly to file
+void AsmCodeGenerator::writeToFile(const std::string& code, const std::string& filename)
+{
+    std::ofstream outFile(filename);
+
+    if (outFile.is_open())
+    {
+        outFile << code;
+        outFile.close();
+        std::cout << "Assembly written to: " << filename << std::endl;
+    }
+    else
+    {
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+    }
+}
+
+// Assemble and link with the GCC driver (as + ld against libc)
+bool AsmCodeGenerator::assembleToExecutable(const std::string& asmFilename, const std::string& outputExecutable)
+{
+    std::string command = "gcc -o " + outputExecutable + " " + asmFilename + " 2>&1";
+
+    std::cout << "Assembling and linking..." << std::endl;
+    std::cout << "Command: " << command << std::endl;
+
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe)
+    {
+        std::cerr << "Error: Could not execute GCC" << std::endl;
+        return false;
+    }
+
+    char buffer[256];
+    std::string result = "";
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+    {
+        result += buffer;
+    }
+
+    int returnCode = pclose(pipe);
+
+    if (returnCode != 0)
+    {
+        std::cerr << "Assembly failed:" << std::endl;
+        std::cerr << result << std::endl;
+        return false;
+    }
+
+    if (!result.empty())
+    {
+        std::cout << "Assembler/linker notes:" << std::endl;
+        std::cout << result << std::endl;
+    }
+
+    std::cout << "Executable created: " << outputExecutable << std::endl;
+    return true;
+}
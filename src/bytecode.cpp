@@ -0,0 +1,454 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include "../include/bytecode.h"
+#include "../include/cfg.h"
+#include "../include/files.h"
+
+// .tbc header; the constant pool (doubles) and the code follow it
+struct BytecodeHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t registerCount;
+    uint32_t constantCount;
+    uint32_t instructionCount;
+};
+
+static const char bytecodeMagic[4] = {'T', 'B', 'C', '\0'};
+static const uint32_t bytecodeVersion = 1;
+
+// Operand kinds of every operation, indexed by BytecodeOp
+struct OperandKinds
+{
+    OperandKind a;
+    OperandKind b;
+    OperandKind c;
+};
+
+static const OperandKinds operandKinds[] = {
+#define TACO_BYTECODE_KINDS(name, a, b, c) {OperandKind::a, OperandKind::b, OperandKind::c},
+    TACO_BYTECODE_OPERATIONS(TACO_BYTECODE_KINDS)
+#undef TACO_BYTECODE_KINDS
+};
+
+BytecodeProgram::BytecodeProgram() : registerCount(0), superinstructions(0) {}
+
+// Register forms of a comparison, its constant form and the mirrored
+// relation used when the constant is on the left
+struct ComparisonForms
+{
+    BytecodeOp registers;
+    BytecodeOp constant;
+    TACOpcode mirrored;
+    BytecodeOp jumpIfTrue;
+    BytecodeOp jumpIfTrueConstant;
+    BytecodeOp jumpIfFalse;
+    BytecodeOp jumpIfFalseConstant;
+};
+
+static bool comparisonForms(TACOpcode opcode, ComparisonForms& forms)
+{
+    switch (opcode)
+    {
+        case TACOpcode::LT:
+            forms = {BytecodeOp::LT, BytecodeOp::LTK, TACOpcode::GT,
+                     BytecodeOp::JLT, BytecodeOp::JLTK, BytecodeOp::JNLT, BytecodeOp::JNLTK};
+            return true;
+        case TACOpcode::LE:
+            forms = {BytecodeOp::LE, BytecodeOp::LEK, TACOpcode::GE,
+                     BytecodeOp::JLE, BytecodeOp::JLEK, BytecodeOp::JNLE, BytecodeOp::JNLEK};
+            return true;
+        case TACOpcode::GT:
+            forms = {BytecodeOp::GT, BytecodeOp::GTK, TACOpcode::LT,
+                     BytecodeOp::JGT, BytecodeOp::JGTK, BytecodeOp::JNGT, BytecodeOp::JNGTK};
+            return true;
+        case TACOpcode::GE:
+            forms = {BytecodeOp::GE, BytecodeOp::GEK, TACOpcode::LE,
+                     BytecodeOp::JGE, BytecodeOp::JGEK, BytecodeOp::JNGE, BytecodeOp::JNGEK};
+            return true;
+        case TACOpcode::EQ:
+            forms = {BytecodeOp::EQ, BytecodeOp::EQK, TACOpcode::EQ,
+                     BytecodeOp::JEQ, BytecodeOp::JEQK, BytecodeOp::JNE, BytecodeOp::JNEK};
+            return true;
+        case TACOpcode::NE:
+            forms = {BytecodeOp::NE, BytecodeOp::NEK, TACOpcode::NE,
+                     BytecodeOp::JNE, BytecodeOp::JNEK, BytecodeOp::JEQ, BytecodeOp::JEQK};
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Value of a TAC instruction whose operands are both literals, computed as
+// the generated C computes it
+static double foldConstant(TACOpcode opcode, double a, double b)
+{
+    switch (opcode)
+    {
+        case TACOpcode::ADD: return a + b;
+        case TACOpcode::SUB: return a - b;
+        case TACOpcode::MUL: return a * b;
+        case TACOpcode::DIV: return a / b;
+        case TACOpcode::ASSIGN: return a;
+        case TACOpcode::LT: return a < b;
+        case TACOpcode::GT: return a > b;
+        case TACOpcode::LE: return a <= b;
+        case TACOpcode::GE: return a >= b;
+        case TACOpcode::EQ: return a == b;
+        case TACOpcode::NE: return a != b;
+        case TACOpcode::AND: return a && b;
+        case TACOpcode::OR: return a || b;
+        case TACOpcode::NOT: return !a;
+        default: return 0.0;
+    }
+}
+
+BytecodeProgram BytecodeProgram::compile(const std::vector<TACInstruction>& tac)
+{
+    BytecodeProgram program;
+    std::unordered_map<std::string, uint32_t> registers;
+    std::unordered_map<uint64_t, uint32_t> constantIndex;
+
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+        {
+            if (operand == &instr.result && !writesResult(instr.opcode))
+                continue;
+            if (!operand->empty() && !isNumericLiteral(*operand))
+                registers.emplace(*operand, static_cast<uint32_t>(registers.size()));
+        }
+    }
+    program.registerCount = static_cast<uint32_t>(registers.size());
+
+    // A temporary whose value is not read after an instruction need not be
+    // written by it, which lets its definition fuse with the reader
+    ControlFlowGraph cfg(tac);
+    TemporaryLiveness liveness(cfg);
+
+    // Constants are shared by bit pattern, so 0 and -0 stay apart
+    auto constant = [&](double value) -> uint32_t {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        auto it = constantIndex.find(bits);
+        if (it != constantIndex.end())
+            return it->second;
+        uint32_t index = static_cast<uint32_t>(program.constants.size());
+        program.constants.push_back(value);
+        constantIndex[bits] = index;
+        return index;
+    };
+    auto literal = [](const std::string& operand) {
+        return std::strtod(operand.c_str(), nullptr);
+    };
+
+    auto& code = program.code;
+    auto emit = [&](BytecodeOp op, uint32_t a, uint32_t b, uint32_t c) {
+        code.push_back(BytecodeInstruction{op, a, b, c});
+    };
+
+    // Jumps are emitted with a label index and patched once all labels are placed
+    std::unordered_map<std::string, uint32_t> labelTargets;
+    std::vector<std::pair<size_t, std::string>> fixups;
+    auto emitJump = [&](BytecodeOp op, uint32_t a, uint32_t b, const std::string& label) {
+        fixups.push_back({code.size(), label});
+        emit(op, a, b, 0);
+    };
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+        bool literal1 = isNumericLiteral(instr.arg1);
+        bool literal2 = isNumericLiteral(instr.arg2);
+        uint32_t result = writesResult(instr.opcode) ? registers[instr.result] : 0;
+        ComparisonForms forms;
+
+        switch (instr.opcode)
+        {
+            case TACOpcode::LABEL:
+                labelTargets[instr.result] = static_cast<uint32_t>(code.size());
+                break;
+
+            case TACOpcode::GOTO:
+                emitJump(BytecodeOp::JMP, 0, 0, instr.result);
+                break;
+
+            case TACOpcode::IF_FALSE:
+            case TACOpcode::IF_TRUE:
+            {
+                bool jumpIfTrue = instr.opcode == TACOpcode::IF_TRUE;
+                if (literal1)
+                {
+                    if ((literal(instr.arg1) != 0.0) == jumpIfTrue)
+                        emitJump(BytecodeOp::JMP, 0, 0, instr.result);
+                }
+                else
+                {
+                    emitJump(jumpIfTrue ? BytecodeOp::JT : BytecodeOp::JF, registers[instr.arg1], 0, instr.result);
+                }
+                break;
+            }
+
+            case TACOpcode::PRINT:
+                if (literal1)
+                    emit(BytecodeOp::PRINTK, constant(literal(instr.arg1)), 0, 0);
+                else
+                    emit(BytecodeOp::PRINT, registers[instr.arg1], 0, 0);
+                break;
+
+            case TACOpcode::ASSIGN:
+                // load-const + print of a temporary that is dead after the print
+                if (literal1 && isTemporary(instr.result) && i + 1 < tac.size() &&
+                    tac[i + 1].opcode == TACOpcode::PRINT && tac[i + 1].arg1 == instr.result &&
+                    liveness.isDeadAfter(i + 1, instr.result))
+                {
+                    emit(BytecodeOp::PRINTK, constant(literal(instr.arg1)), 0, 0);
+                    program.superinstructions++;
+                    i++;
+                }
+                else if (literal1)
+                {
+                    emit(BytecodeOp::LOADK, result, constant(literal(instr.arg1)), 0);
+                }
+                else
+                {
+                    emit(BytecodeOp::MOV, result, registers[instr.arg1], 0);
+                }
+                break;
+
+            case TACOpcode::NOT:
+                if (literal1)
+                    emit(BytecodeOp::LOADK, result, constant(!literal(instr.arg1)), 0);
+                else
+                    emit(BytecodeOp::NOT, result, registers[instr.arg1], 0);
+                break;
+
+            case TACOpcode::AND:
+            case TACOpcode::OR:
+            {
+                if (literal1 && literal2)
+                {
+                    emit(BytecodeOp::LOADK, result, constant(foldConstant(instr.opcode, literal(instr.arg1), literal(instr.arg2))), 0);
+                    break;
+                }
+                if (!literal1 && !literal2)
+                {
+                    emit(instr.opcode == TACOpcode::AND ? BytecodeOp::AND : BytecodeOp::OR,
+                         result, registers[instr.arg1], registers[instr.arg2]);
+                    break;
+                }
+                // One literal decides the result or reduces it to a test of the other operand
+                bool known = literal(literal1 ? instr.arg1 : instr.arg2) != 0.0;
+                uint32_t other = registers[literal1 ? instr.arg2 : instr.arg1];
+                if (known == (instr.opcode == TACOpcode::OR))
+                    emit(BytecodeOp::LOADK, result, constant(known ? 1.0 : 0.0), 0);
+                else
+                    emit(BytecodeOp::NEK, result, other, constant(0.0));
+                break;
+            }
+
+            case TACOpcode::ADD:
+            case TACOpcode::SUB:
+            case TACOpcode::MUL:
+            case TACOpcode::DIV:
+            {
+                if (literal1 && literal2)
+                {
+                    emit(BytecodeOp::LOADK, result, constant(foldConstant(instr.opcode, literal(instr.arg1), literal(instr.arg2))), 0);
+                    break;
+                }
+                BytecodeOp registerForm, constantForm, leftConstantForm;
+                if (instr.opcode == TACOpcode::ADD)
+                    registerForm = BytecodeOp::ADD, constantForm = BytecodeOp::ADDK, leftConstantForm = BytecodeOp::ADDK;
+                else if (instr.opcode == TACOpcode::SUB)
+                    registerForm = BytecodeOp::SUB, constantForm = BytecodeOp::SUBK, leftConstantForm = BytecodeOp::KSUB;
+                else if (instr.opcode == TACOpcode::MUL)
+                    registerForm = BytecodeOp::MUL, constantForm = BytecodeOp::MULK, leftConstantForm = BytecodeOp::MULK;
+                else
+                    registerForm = BytecodeOp::DIV, constantForm = BytecodeOp::DIVK, leftConstantForm = BytecodeOp::KDIV;
+
+                if (literal2)
+                    emit(constantForm, result, registers[instr.arg1], constant(literal(instr.arg2)));
+                else if (literal1)
+                    emit(leftConstantForm, result, registers[instr.arg2], constant(literal(instr.arg1)));
+                else
+                    emit(registerForm, result, registers[instr.arg1], registers[instr.arg2]);
+                break;
+            }
+
+            case TACOpcode::LT:
+            case TACOpcode::GT:
+            case TACOpcode::LE:
+            case TACOpcode::GE:
+            case TACOpcode::EQ:
+            case TACOpcode::NE:
+            {
+                if (literal1 && literal2)
+                {
+                    emit(BytecodeOp::LOADK, result, constant(foldConstant(instr.opcode, literal(instr.arg1), literal(instr.arg2))), 0);
+                    break;
+                }
+
+                // A constant on the left is moved right by mirroring the relation
+                std::string left = instr.arg1;
+                std::string right = instr.arg2;
+                comparisonForms(instr.opcode, forms);
+                if (literal1)
+                {
+                    std::swap(left, right);
+                    comparisonForms(forms.mirrored, forms);
+                }
+                bool constantRight = isNumericLiteral(right);
+                uint32_t b = constantRight ? constant(literal(right)) : registers[right];
+
+                // compare + branch on a temporary that is dead after the branch
+                if (isTemporary(instr.result) && i + 1 < tac.size() &&
+                    (tac[i + 1].opcode == TACOpcode::IF_TRUE || tac[i + 1].opcode == TACOpcode::IF_FALSE) &&
+                    tac[i + 1].arg1 == instr.result && liveness.isDeadAfter(i + 1, instr.result))
+                {
+                    BytecodeOp op;
+                    if (tac[i + 1].opcode == TACOpcode::IF_TRUE)
+                        op = constantRight ? forms.jumpIfTrueConstant : forms.jumpIfTrue;
+                    else
+                        op = constantRight ? forms.jumpIfFalseConstant : forms.jumpIfFalse;
+                    emitJump(op, registers[left], b, tac[i + 1].result);
+                    program.superinstructions++;
+                    i++;
+                    break;
+                }
+
+                emit(constantRight ? forms.constant : forms.registers, result, registers[left], b);
+                break;
+            }
+        }
+    }
+    emit(BytecodeOp::HALT, 0, 0, 0);
+
+    // Jumps to unknown labels end the program
+    uint32_t halt = static_cast<uint32_t>(code.size() - 1);
+    for (const auto& fixup : fixups)
+    {
+        auto it = labelTargets.find(fixup.second);
+        code[fixup.first].c = it != labelTargets.end() ? it->second : halt;
+    }
+
+    return program;
+}
+
+// Check every operand against the register file, constant pool and code
+bool BytecodeProgram::validate(std::string& error) const
+{
+    if (code.empty() || code.back().op != BytecodeOp::HALT)
+    {
+        error = "code does not end with HALT";
+        return false;
+    }
+    for (size_t i = 0; i < code.size(); i++)
+    {
+        const BytecodeInstruction& instr = code[i];
+        if (static_cast<uint32_t>(instr.op) >= static_cast<uint32_t>(BytecodeOp::COUNT))
+        {
+            error = "invalid operation at instruction " + std::to_string(i);
+            return false;
+        }
+        const OperandKinds& kinds = operandKinds[static_cast<uint32_t>(instr.op)];
+        for (auto operand : {std::make_pair(kinds.a, instr.a), std::make_pair(kinds.b, instr.b),
+                             std::make_pair(kinds.c, instr.c)})
+        {
+            bool valid = operand.first == OperandKind::NONE ||
+                         (operand.first == OperandKind::REGISTER && operand.second < registerCount) ||
+                         (operand.first == OperandKind::CONSTANT && operand.second < constants.size()) ||
+                         (operand.first == OperandKind::TARGET && operand.second < code.size());
+            if (!valid)
+            {
+                error = "operand out of range at instruction " + std::to_string(i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool BytecodeProgram::save(const std::string& filename, std::string& error) const
+{
+    if (registerCount > maxRegisters)
+    {
+        error = "program has too many names for a bytecode file";
+        return false;
+    }
+
+    BytecodeHeader header;
+    std::memcpy(header.magic, bytecodeMagic, sizeof(header.magic));
+    header.version = bytecodeVersion;
+    header.registerCount = registerCount;
+    header.constantCount = static_cast<uint32_t>(constants.size());
+    header.instructionCount = static_cast<uint32_t>(code.size());
+
+    std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char*>(constants.data()), constants.size() * sizeof(double));
+    data.append(reinterpret_cast<const char*>(code.data()), code.size() * sizeof(BytecodeInstruction));
+    if (!replaceFile(filename, data, false))
+    {
+        error = "could not write " + filename;
+        return false;
+    }
+    return true;
+}
+
+bool BytecodeProgram::load(const std::string& filename, BytecodeProgram& program, std::string& error)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        error = "could not open " + filename;
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    BytecodeHeader header;
+    if (data.size() < sizeof(header))
+    {
+        error = filename + " is not a bytecode file";
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, bytecodeMagic, sizeof(header.magic)) != 0)
+    {
+        error = filename + " is not a bytecode file";
+        return false;
+    }
+    if (header.version != bytecodeVersion)
+    {
+        error = "unsupported bytecode version " + std::to_string(header.version);
+        return false;
+    }
+
+    size_t constantBytes = size_t(header.constantCount) * sizeof(double);
+    size_t codeBytes = size_t(header.instructionCount) * sizeof(BytecodeInstruction);
+    if (data.size() != sizeof(header) + constantBytes + codeBytes)
+    {
+        error = filename + " is truncated or has trailing data";
+        return false;
+    }
+
+    if (header.registerCount > maxRegisters)
+    {
+        error = filename + " asks for " + std::to_string(header.registerCount) + " registers (at most " +
+                std::to_string(maxRegisters) + ")";
+        return false;
+    }
+
+    program = BytecodeProgram();
+    program.registerCount = header.registerCount;
+    program.constants.resize(header.constantCount);
+    program.code.resize(header.instructionCount);
+    std::memcpy(program.constants.data(), data.data() + sizeof(header), constantBytes);
+    std::memcpy(program.code.data(), data.data() + sizeof(header) + constantBytes, codeBytes);
+
+    return program.validate(error);
+}
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "../include/cache.h"
+#include "../include/files.h"
+
+static const char statsName[] = "stats";
+static const char lockName[] = "stats.lock";
+
+// 128-bit FNV-1a, continued from a previous hash value
+static unsigned __int128 fnv1a(unsigned __int128 hash, const std::string& data)
+{
+    const unsigned __int128 prime = ((unsigned __int128)0x0000000001000000ULL << 64) | 0x000000000000013BULL;
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= prime;
+    }
+    return hash;
+}
+
+static std::string toHex(unsigned __int128 hash)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (int i = 31; i >= 0; i--)
+    {
+        text[i] = hex[static_cast<unsigned>(hash & 15)];
+        hash >>= 4;
+    }
+    return text;
+}
+
+static const unsigned __int128 fnvOffset = ((unsigned __int128)0x6c62272e07bb0142ULL << 64) | 0x62b821756295c58dULL;
+
+std::string contentHash(const std::string& data)
+{
+    return toHex(fnv1a(fnvOffset, data));
+}
+
+static bool readFile(const std::string& filename, std::string& contents)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return false;
+    std::ostringstream data;
+    data << in.rdbuf();
+    contents = data.str();
+    return true;
+}
+
+// Copy a file with execute permission; readers never see a partial file
+static bool copyFile(const std::string& from, const std::string& to)
+{
+    std::string contents;
+    return readFile(from, contents) && replaceFile(to, contents, true);
+}
+
+// Create a directory and its missing parents
+bool makeDirectories(const std::string& path)
+{
+    if (path.empty())
+        return false;
+    for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+    {
+        std::string prefix = path.substr(0, slash);
+        if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+            return false;
+        if (slash == std::string::npos)
+            break;
+    }
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+ExecutableCache::ExecutableCache(const std::string& directory, uint64_t capacity)
+    : directory(directory), capacity(capacity), usable(false), hits(0), misses(0), evictions(0),
+      entryCount(0), totalSize(0)
+{
+    usable = makeDirectories(directory);
+    if (!usable)
+    {
+        std::cerr << "Warning: Could not create cache directory " << directory << ", building without cache\n";
+        return;
+    }
+    loadStats();
+}
+
+std::string ExecutableCache::defaultDirectory()
+{
+    if (const char* dir = std::getenv("TACO_CACHE_DIR"))
+    {
+        if (*dir)
+            return dir;
+    }
+    if (const char* dir = std::getenv("XDG_CACHE_HOME"))
+    {
+        if (*dir)
+            return std::string(dir) + "/taco";
+    }
+    if (const char* home = std::getenv("HOME"))
+    {
+        if (*home)
+            return std::string(home) + "/.cache/taco";
+    }
+    return ".taco-cache";
+}
+
+std::string ExecutableCache::entryPath(const std::string& key) const
+{
+    return directory + "/" + key;
+}
+
+void ExecutableCache::loadStats()
+{
+    std::ifstream in(directory + "/" + statsName);
+    if (!(in >> hits >> misses >> evictions))
+        hits = misses = evictions = 0;
+    // Entries and their size as the last store() left them
+    if (!(in >> entryCount >> totalSize))
+        entryCount = totalSize = 0;
+}
+
+void ExecutableCache::saveStats() const
+{
+    std::string path = directory + "/" + statsName;
+    std::ostringstream data;
+    data << hits << " " << misses << " " << evictions << " " << entryCount << " " << totalSize << "\n";
+    replaceFile(path, data.str(), false);
+}
+
+// Add this build's hits and misses (and evict, when an entry was added) to the
+// totals in the stats file. Builds sharing the directory take turns through
+// an flock on the lock file, so no build's counts are lost; the totals are
+// read again once the lock is held.
+void ExecutableCache::updateStats(uint64_t newHits, uint64_t newMisses, bool added)
+{
+    std::string lockPath = directory + "/" + lockName;
+    int lock = open(lockPath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (lock >= 0)
+    {
+        while (flock(lock, LOCK_EX) != 0 && errno == EINTR)
+            ;
+    }
+    loadStats();
+    hits += newHits;
+    misses += newMisses;
+    if (added)
+        evict();
+    saveStats();
+    if (lock >= 0)
+        close(lock);
+}
+
+std::string ExecutableCache::key(const std::vector<std::string>& sources, const std::string& command)
+{
+    // The compiler version is asked once per cache object
+    if (compilerVersion.empty())
+    {
+        FILE* pipe = popen("gcc --version 2>&1", "r");
+        if (pipe)
+        {
+            char buffer[256];
+            while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+                compilerVersion += buffer;
+            pclose(pipe);
+        }
+        if (compilerVersion.empty())
+            compilerVersion = "unknown";
+    }
+
+    unsigned __int128 hash = fnv1a(fnvOffset, compilerVersion);
+    hash = fnv1a(hash, std::string(1, '\0') + command);
+    for (const auto& source : sources)
+    {
+        // Lengths separate the sources, so splitting them differently changes the key
+        hash = fnv1a(hash, std::string(1, '\0') + std::to_string(source.size()) + ":");
+        hash = fnv1a(hash, source);
+    }
+    return toHex(hash);
+}
+
+std::string ExecutableCache::keyOfFiles(const std::vector<std::string>& filenames, const std::string& command)
+{
+    std::vector<std::string> sources;
+    for (const auto& filename : filenames)
+    {
+        std::string contents;
+        if (!readFile(filename, contents))
+            return "";
+        sources.push_back(contents);
+    }
+    return key(sources, command);
+}
+
+bool ExecutableCache::fetch(const std::string& key, const std::string& output)
+{
+    if (!usable || key.empty())
+        return false;
+    std::string path = entryPath(key);
+    struct stat info;
+    bool found = stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode);
+    if (found)
+    {
+        // Replace the output rather than writing through an existing link
+        std::remove(output.c_str());
+        found = link(path.c_str(), output.c_str()) == 0 || copyFile(path, output);
+    }
+    if (found)
+        utimes(path.c_str(), nullptr);
+    updateStats(found ? 1 : 0, found ? 0 : 1, false);
+    return found;
+}
+
+void ExecutableCache::store(const std::string& key, const std::string& executable)
+{
+    if (!usable || key.empty())
+        return;
+    if (!copyFile(executable, entryPath(key)))
+        std::cerr << "Warning: Could not add " << executable << " to the cache\n";
+    updateStats(0, 0, true);
+}
+
+// Remove the least recently used entries until the cache fits its cap, and
+// count what remains. Only a build that added an entry scans the directory.
+void ExecutableCache::evict()
+{
+    struct Entry
+    {
+        std::string path;
+        uint64_t size;
+        time_t used;
+        long usedNanoseconds;
+    };
+    std::vector<Entry> entries;
+    totalSize = 0;
+
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    while (struct dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        // Entries are 32 hex digits; skip the stats file and temporaries
+        if (name.size() != 32 || name.find_first_not_of("0123456789abcdef") != std::string::npos)
+            continue;
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+            continue;
+        entries.push_back({path, static_cast<uint64_t>(info.st_size), info.st_mtim.tv_sec, info.st_mtim.tv_nsec});
+        totalSize += info.st_size;
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.used != b.used ? a.used < b.used : a.usedNanoseconds < b.usedNanoseconds;
+    });
+    size_t oldest = 0;
+    while (totalSize > capacity && oldest < entries.size())
+    {
+        if (std::remove(entries[oldest].path.c_str()) == 0)
+        {
+            totalSize -= entries[oldest].size;
+            evictions++;
+        }
+        oldest++;
+    }
+    entryCount = entries.size() - oldest;
+}
@@ -0,0 +1,426 @@
+#include <iostream>
+#include <algorithm>
+#include "../include/cfg.h"
+
+// Leading label of the block
+std::string BasicBlock::label() const
+{
+    if (!instructions.empty() && instructions[0].opcode == TACOpcode::LABEL)
+        return instructions[0].result;
+    return "";
+}
+
+// Final jump of the block
+const TACInstruction* BasicBlock::terminator() const
+{
+    if (instructions.empty())
+        return nullptr;
+
+    const TACInstruction& last = instructions.back();
+    if (last.opcode == TACOpcode::GOTO || last.opcode == TACOpcode::IF_FALSE || last.opcode == TACOpcode::IF_TRUE)
+        return &last;
+    return nullptr;
+}
+
+// Split TAC into basic blocks: every label starts a block, every jump ends one
+ControlFlowGraph::ControlFlowGraph(const std::vector<TACInstruction>& tac)
+{
+    for (const auto& instr : tac)
+    {
+        bool startsBlock = blocks.empty() || instr.opcode == TACOpcode::LABEL;
+        if (!startsBlock)
+        {
+            const BasicBlock& current = blocks.back();
+            startsBlock = current.terminator() != nullptr;
+        }
+
+        if (startsBlock)
+        {
+            BasicBlock block;
+            block.id = static_cast<int>(blocks.size());
+            blocks.push_back(block);
+        }
+
+        blocks.back().instructions.push_back(instr);
+    }
+
+    update();
+}
+
+// Block starting with the given label
+int ControlFlowGraph::blockForLabel(const std::string& label) const
+{
+    auto it = labelToBlock.find(label);
+    if (it == labelToBlock.end())
+        return -1;
+    return it->second;
+}
+
+// Recompute labels, edges and dominators
+void ControlFlowGraph::update()
+{
+    labelToBlock.clear();
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        blocks[i].id = static_cast<int>(i);
+        for (const auto& instr : blocks[i].instructions)
+        {
+            if (instr.opcode == TACOpcode::LABEL)
+                labelToBlock[instr.result] = static_cast<int>(i);
+        }
+    }
+
+    computeEdges();
+    computeDominators();
+}
+
+// Connect blocks through jumps and fall-through
+void ControlFlowGraph::computeEdges()
+{
+    for (auto& block : blocks)
+    {
+        block.successors.clear();
+        block.predecessors.clear();
+    }
+
+    auto addEdge = [this](int from, int to) {
+        if (to < 0)
+            return;
+        auto& succ = blocks[from].successors;
+        if (std::find(succ.begin(), succ.end(), to) != succ.end())
+            return;
+        succ.push_back(to);
+        blocks[to].predecessors.push_back(from);
+    };
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        int id = static_cast<int>(i);
+        int next = (i + 1 < blocks.size()) ? id + 1 : -1;
+        const TACInstruction* term = blocks[i].terminator();
+
+        if (!term)
+        {
+            addEdge(id, next);
+        }
+        else if (term->opcode == TACOpcode::GOTO)
+        {
+            addEdge(id, blockForLabel(term->result));
+        }
+        else
+        {
+            addEdge(id, blockForLabel(term->result));
+            addEdge(id, next);
+        }
+    }
+}
+
+// Blocks reachable from the entry in reverse postorder
+std::vector<int> ControlFlowGraph::reversePostorder() const
+{
+    std::vector<int> order;
+    if (blocks.empty())
+        return order;
+
+    std::vector<char> visited(blocks.size(), 0);
+    std::vector<std::pair<int, size_t>> stack;
+    stack.push_back({0, 0});
+    visited[0] = 1;
+
+    while (!stack.empty())
+    {
+        auto& top = stack.back();
+        const auto& succ = blocks[top.first].successors;
+        if (top.second < succ.size())
+        {
+            int next = succ[top.second++];
+            if (!visited[next])
+            {
+                visited[next] = 1;
+                stack.push_back({next, 0});
+            }
+        }
+        else
+        {
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Immediate dominators (Cooper, Harvey and Kennedy iterative algorithm)
+void ControlFlowGraph::computeDominators()
+{
+    idom.assign(blocks.size(), -1);
+    rpoNumber.assign(blocks.size(), -1);
+    if (blocks.empty())
+        return;
+
+    std::vector<int> order = reversePostorder();
+    for (size_t i = 0; i < order.size(); i++)
+        rpoNumber[order[i]] = static_cast<int>(i);
+
+    auto intersect = [this](int a, int b) {
+        while (a != b)
+        {
+            while (rpoNumber[a] > rpoNumber[b])
+                a = idom[a];
+            while (rpoNumber[b] > rpoNumber[a])
+                b = idom[b];
+        }
+        return a;
+    };
+
+    idom[0] = 0;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 1; i < order.size(); i++)
+        {
+            int b = order[i];
+            int newIdom = -1;
+            for (int p : blocks[b].predecessors)
+            {
+                if (idom[p] == -1)
+                    continue;
+                newIdom = (newIdom == -1) ? p : intersect(p, newIdom);
+            }
+            if (newIdom != idom[b])
+            {
+                idom[b] = newIdom;
+                changed = true;
+            }
+        }
+    }
+}
+
+// Check if block a dominates block b
+bool ControlFlowGraph::dominates(int a, int b) const
+{
+    if (idom[a] == -1 || idom[b] == -1)
+        return false;
+
+    while (true)
+    {
+        if (a == b)
+            return true;
+        if (b == 0)
+            return false;
+        b = idom[b];
+    }
+}
+
+// Find natural loops from back edges (edges whose target dominates the source)
+std::vector<Loop> ControlFlowGraph::findLoops() const
+{
+    std::vector<Loop> loops;
+    std::unordered_map<int, size_t> loopByHeader;
+
+    for (const auto& block : blocks)
+    {
+        for (int succ : block.successors)
+        {
+            if (!dominates(succ, block.id))
+                continue;
+
+            auto it = loopByHeader.find(succ);
+            if (it == loopByHeader.end())
+            {
+                Loop loop;
+                loop.header = succ;
+                loopByHeader[succ] = loops.size();
+                loops.push_back(loop);
+                it = loopByHeader.find(succ);
+            }
+            loops[it->second].latches.push_back(block.id);
+        }
+    }
+
+    // Collect loop bodies by walking predecessors backwards from each latch
+    for (auto& loop : loops)
+    {
+        std::vector<char> inLoop(blocks.size(), 0);
+        inLoop[loop.header] = 1;
+        std::vector<int> worklist;
+        for (int latch : loop.latches)
+        {
+            if (!inLoop[latch])
+            {
+                inLoop[latch] = 1;
+                worklist.push_back(latch);
+            }
+        }
+
+        while (!worklist.empty())
+        {
+            int b = worklist.back();
+            worklist.pop_back();
+            for (int p : blocks[b].predecessors)
+            {
+                if (!inLoop[p] && idom[p] != -1)
+                {
+                    inLoop[p] = 1;
+                    worklist.push_back(p);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            if (inLoop[i])
+                loop.blocks.push_back(static_cast<int>(i));
+        }
+    }
+
+    return loops;
+}
+
+// Linearize blocks in their current order
+std::vector<TACInstruction> ControlFlowGraph::flatten() const
+{
+    std::vector<TACInstruction> tac;
+    for (const auto& block : blocks)
+    {
+        tac.insert(tac.end(), block.instructions.begin(), block.instructions.end());
+    }
+    return tac;
+}
+
+TemporaryLiveness::TemporaryLiveness(const ControlFlowGraph& cfg) : cfg(cfg), globalCount(0)
+{
+    const auto& blocks = cfg.getBlocks();
+
+    // A temporary read in a block before any write there is live across a
+    // block boundary; all others live and die inside one block
+    std::vector<std::string> order;
+    std::vector<int> writtenIn;
+    std::vector<char> global;
+    for (const auto& block : blocks)
+    {
+        for (size_t i = 0; i < block.instructions.size(); i++)
+            positions.push_back({block.id, i});
+        for (const auto& instr : block.instructions)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            for (const std::string* name : {&instr.arg1, &instr.arg2, &instr.result})
+            {
+                if (!isTemporary(*name))
+                    continue;
+                auto it = tempIndex.emplace(*name, order.size()).first;
+                if (it->second == order.size())
+                {
+                    order.push_back(*name);
+                    writtenIn.push_back(-1);
+                    global.push_back(0);
+                }
+                if (name != &instr.result)
+                {
+                    if (writtenIn[it->second] != block.id)
+                        global[it->second] = 1;
+                }
+                else if (writesResult(instr.opcode))
+                {
+                    writtenIn[it->second] = block.id;
+                }
+            }
+        }
+    }
+
+    // Number the temporaries live across blocks first; only they are in the sets
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (size_t t = 0; t < order.size(); t++)
+        {
+            if (global[t] == (pass == 0))
+            {
+                tempIndex[order[t]] = temps.size();
+                temps.push_back(order[t]);
+            }
+        }
+        if (pass == 0)
+            globalCount = temps.size();
+    }
+
+    size_t words = (globalCount + 63) / 64;
+    auto insert = [](TempSet& set, size_t temp) { set[temp / 64] |= uint64_t(1) << (temp % 64); };
+
+    // Per block: temporaries read before written (use) and written (def)
+    std::vector<TempSet> use(blocks.size(), TempSet(words, 0));
+    std::vector<TempSet> def(blocks.size(), TempSet(words, 0));
+    for (const auto& block : blocks)
+    {
+        for (const auto& instr : block.instructions)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            for (const std::string* name : {&instr.arg1, &instr.arg2})
+            {
+                if (!isTemporary(*name))
+                    continue;
+                size_t temp = tempIndex[*name];
+                if (temp < globalCount && !contains(def[block.id], temp))
+                    insert(use[block.id], temp);
+            }
+            if (writesResult(instr.opcode) && isTemporary(instr.result))
+            {
+                size_t temp = tempIndex[instr.result];
+                if (temp < globalCount)
+                    insert(def[block.id], temp);
+            }
+        }
+    }
+
+    // in = use | (out & ~def), out = union of successor ins, until nothing changes
+    liveIn.assign(blocks.size(), TempSet(words, 0));
+    liveOut.assign(blocks.size(), TempSet(words, 0));
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t b = blocks.size(); b-- > 0;)
+        {
+            TempSet out(words, 0);
+            for (int succ : blocks[b].successors)
+            {
+                for (size_t w = 0; w < words; w++)
+                    out[w] |= liveIn[succ][w];
+            }
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t in = use[b][w] | (out[w] & ~def[b][w]);
+                if (in != liveIn[b][w] || out[w] != liveOut[b][w])
+                    changed = true;
+                liveIn[b][w] = in;
+            }
+            liveOut[b] = out;
+        }
+    }
+}
+
+bool TemporaryLiveness::isLiveOut(int block, const std::string& temp) const
+{
+    auto it = tempIndex.find(temp);
+    return it != tempIndex.end() && contains(liveOut[block], it->second);
+}
+
+bool TemporaryLiveness::isDeadAfter(size_t index, const std::string& temp) const
+{
+    int block = positions[index].first;
+    const auto& instructions = cfg.getBlocks()[block].instructions;
+    for (size_t j = positions[index].second + 1; j < instructions.size(); j++)
+    {
+        const TACInstruction& instr = instructions[j];
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        if (instr.arg1 == temp || instr.arg2 == temp)
+            return false;
+        if (writesResult(instr.opcode) && instr.result == temp)
+            return true;
+    }
+    return !isLiveOut(block, temp);
+}
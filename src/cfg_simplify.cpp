@@ -0,0 +1,258 @@
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include "../include/optimizer.h"
+#include "../include/cfg.h"
+#include "../include/context.h"
+
+// Statistics of one CFG simplification run
+struct SimplifyStats
+{
+    int threadedJumps = 0;
+    int removedJumps = 0;
+    int invertedBranches = 0;
+    int removedBlocks = 0;
+    int removedLabels = 0;
+    int mergedBlocks = 0;
+
+    int total() const
+    {
+        return threadedJumps + removedJumps + invertedBranches + removedBlocks + removedLabels + mergedBlocks;
+    }
+};
+
+// Check if instruction jumps to its result label
+static bool isJump(const TACInstruction& instr)
+{
+    return instr.opcode == TACOpcode::GOTO || instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE;
+}
+
+// Index of every label in the instruction sequence
+static std::unordered_map<std::string, size_t> labelPositions(const std::vector<TACInstruction>& tac)
+{
+    std::unordered_map<std::string, size_t> positions;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::LABEL)
+            positions[tac[i].result] = i;
+    }
+    return positions;
+}
+
+// Check if a label sits in the run of labels starting at 'from'
+static bool labelInRunAt(const std::vector<TACInstruction>& tac, size_t from, const std::string& label)
+{
+    for (size_t i = from; i < tac.size() && tac[i].opcode == TACOpcode::LABEL; i++)
+    {
+        if (tac[i].result == label)
+            return true;
+    }
+    return false;
+}
+
+// Thread jumps through empty blocks and jumps to jumps: a jump to a label is
+// redirected to the first label in front of the code it finally reaches
+static int threadJumps(std::vector<TACInstruction>& tac)
+{
+    auto positions = labelPositions(tac);
+
+    // First label of the run each label belongs to
+    std::unordered_map<std::string, std::string> runHead;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode != TACOpcode::LABEL)
+            continue;
+        size_t head = i;
+        while (head > 0 && tac[head - 1].opcode == TACOpcode::LABEL)
+            head--;
+        runHead[tac[i].result] = tac[head].result;
+    }
+
+    auto resolve = [&](const std::string& label) {
+        std::string current = label;
+        std::unordered_set<std::string> visited;
+        while (visited.insert(current).second)
+        {
+            auto it = positions.find(current);
+            if (it == positions.end())
+                break;
+            size_t i = it->second;
+            while (i < tac.size() && tac[i].opcode == TACOpcode::LABEL)
+                i++;
+            if (i >= tac.size() || tac[i].opcode != TACOpcode::GOTO)
+                break;
+            current = tac[i].result;
+        }
+        auto head = runHead.find(current);
+        return head != runHead.end() ? head->second : current;
+    };
+
+    int threaded = 0;
+    for (auto& instr : tac)
+    {
+        if (!isJump(instr))
+            continue;
+        std::string target = resolve(instr.result);
+        if (target != instr.result)
+        {
+            instr.result = target;
+            threaded++;
+        }
+    }
+    return threaded;
+}
+
+// Remove jumps to the next instruction and invert "if c goto A; goto B; A:"
+static void removeRedundantJumps(std::vector<TACInstruction>& tac, SimplifyStats& stats)
+{
+    std::vector<TACInstruction> result;
+    result.reserve(tac.size());
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+
+        if (isJump(instr) && labelInRunAt(tac, i + 1, instr.result))
+        {
+            stats.removedJumps++;
+            continue;
+        }
+
+        if ((instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE) &&
+            i + 1 < tac.size() && tac[i + 1].opcode == TACOpcode::GOTO &&
+            labelInRunAt(tac, i + 2, instr.result))
+        {
+            TACOpcode inverted = (instr.opcode == TACOpcode::IF_FALSE) ? TACOpcode::IF_TRUE : TACOpcode::IF_FALSE;
+            result.push_back(TACInstruction(inverted, tac[i + 1].result, instr.arg1));
+            stats.invertedBranches++;
+            i++;
+            continue;
+        }
+
+        result.push_back(instr);
+    }
+
+    tac.swap(result);
+}
+
+// Remove labels no jump refers to, so fall-through blocks merge
+static int removeUnusedLabels(std::vector<TACInstruction>& tac)
+{
+    std::unordered_set<std::string> used;
+    for (const auto& instr : tac)
+    {
+        if (isJump(instr))
+            used.insert(instr.result);
+    }
+
+    std::vector<TACInstruction> result;
+    result.reserve(tac.size());
+    int removed = 0;
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL && used.find(instr.result) == used.end())
+        {
+            removed++;
+            continue;
+        }
+        result.push_back(instr);
+    }
+
+    tac.swap(result);
+    return removed;
+}
+
+// Remove unreachable blocks and move single-predecessor blocks reached by a
+// goto next to their predecessor
+static void simplifyBlocks(std::vector<TACInstruction>& tac, SimplifyStats& stats)
+{
+    ControlFlowGraph cfg(tac);
+    auto& blocks = cfg.getBlocks();
+    if (blocks.empty())
+        return;
+
+    std::vector<char> removed(blocks.size(), 0);
+    for (const auto& block : blocks)
+    {
+        if (!cfg.isReachable(block.id))
+        {
+            removed[block.id] = 1;
+            stats.removedBlocks++;
+        }
+    }
+
+    // B: ... goto L    C (L:) ... goto M    where C is only reached from B
+    std::vector<char> changed(blocks.size(), 0);
+    for (auto& block : blocks)
+    {
+        if (removed[block.id] || changed[block.id])
+            continue;
+        const TACInstruction* term = block.terminator();
+        if (!term || term->opcode != TACOpcode::GOTO)
+            continue;
+
+        int target = cfg.blockForLabel(term->result);
+        if (target <= 0 || target == block.id || removed[target] || changed[target])
+            continue;
+
+        BasicBlock& next = blocks[target];
+        const TACInstruction* nextTerm = next.terminator();
+        const TACInstruction* prevTerm = blocks[target - 1].terminator();
+        bool reachedByFallThrough = !removed[target - 1] && (!prevTerm || prevTerm->opcode != TACOpcode::GOTO);
+        if (next.predecessors.size() != 1 || reachedByFallThrough ||
+            !nextTerm || nextTerm->opcode != TACOpcode::GOTO)
+            continue;
+
+        block.instructions.pop_back();
+        block.instructions.insert(block.instructions.end(), next.instructions.begin(), next.instructions.end());
+        removed[target] = 1;
+        changed[block.id] = 1;
+        stats.mergedBlocks++;
+    }
+
+    std::vector<TACInstruction> result;
+    result.reserve(tac.size());
+    for (const auto& block : blocks)
+    {
+        if (!removed[block.id])
+            result.insert(result.end(), block.instructions.begin(), block.instructions.end());
+    }
+    tac.swap(result);
+}
+
+// Simplify the control flow left by nested if/while lowering: thread jumps to
+// jumps, drop jumps to the next instruction, remove unreachable blocks and
+// unused labels, and merge single-predecessor/single-successor blocks.
+// Runs until nothing changes.
+int simplifyCFG(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context)
+{
+    SimplifyStats stats;
+    size_t before = tac.size();
+
+    while (true)
+    {
+        int previous = stats.total();
+
+        stats.threadedJumps += threadJumps(tac);
+        removeRedundantJumps(tac, stats);
+        stats.removedLabels += removeUnusedLabels(tac);
+        simplifyBlocks(tac, stats);
+
+        if (stats.total() == previous)
+            break;
+    }
+
+    if (options.logReport && stats.total() > 0)
+    {
+        context.logger << "CFG simplification: " << stats.threadedJumps << " jumps threaded, "
+                       << stats.removedJumps << " redundant jumps removed, "
+                       << stats.invertedBranches << " branches inverted, "
+                       << stats.removedBlocks << " unreachable blocks removed, "
+                       << stats.removedLabels << " labels removed, "
+                       << stats.mergedBlocks << " blocks merged ("
+                       << before << " -> " << tac.size() << " instructions)" << std::endl;
+    }
+
+    return stats.total();
+}
@@ -1,9 +1,137 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <algorithm>
+#include <thread>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 #include "../include/codegen.h"
+#include "runtime_format.h"     // runtimeFormatSource: generated by the Makefile from runtime/taco_format.h
 
-CCodeGenerator::CCodeGenerator() {}
+// Print runtime of generated programs after the shared value formatter: a
+// large output buffer written with write(2) when full and before main returns
+static const char printRuntime[] =
+    "\n// Print runtime\n"
+    "static char taco_output[1 << 20];\n"
+    "static size_t taco_output_length;\n"
+    "\n"
+    "void taco_flush(void) {\n"
+    "    size_t done = 0;\n"
+    "    while (done < taco_output_length) {\n"
+    "        ssize_t written = write(1, taco_output + done, taco_output_length - done);\n"
+    "        if (written < 0 && errno == EINTR)\n"
+    "            continue;\n"
+    "        if (written <= 0)\n"
+    "            break;\n"
+    "        done += (size_t)written;\n"
+    "    }\n"
+    "    taco_output_length = 0;\n"
+    "}\n"
+    "\n"
+    "void taco_print(double value) {\n"
+    "    if (taco_output_length + 32 > sizeof(taco_output))\n"
+    "        taco_flush();\n"
+    "    taco_output_length += taco_format_g(value, taco_output + taco_output_length);\n"
+    "    taco_output[taco_output_length++] = '\\n';\n"
+    "}\n\n";
+
+CodeWriter::CodeWriter(int fd) : buffer(bufferSize), used(0), fd(fd), target(nullptr), failed(fd < 0) {}
+
+CodeWriter::CodeWriter(std::string& target) : buffer(bufferSize), used(0), fd(-1), target(&target), failed(false) {}
+
+CodeWriter::~CodeWriter()
+{
+    flush();
+}
+
+CodeWriter& CodeWriter::operator<<(const char* text)
+{
+    return append(text, std::strlen(text));
+}
+
+CodeWriter& CodeWriter::append(const char* data, size_t size)
+{
+    if (used + size > buffer.size())
+    {
+        flush();
+        // Text larger than the buffer goes out directly
+        if (size > buffer.size())
+        {
+            if (target)
+            {
+                target->append(data, size);
+                return *this;
+            }
+            buffer.resize(size);
+        }
+    }
+    std::memcpy(buffer.data() + used, data, size);
+    used += size;
+    return *this;
+}
+
+bool CodeWriter::flush()
+{
+    if (target)
+    {
+        target->append(buffer.data(), used);
+        used = 0;
+        return true;
+    }
+    size_t written = 0;
+    while (!failed && written < used)
+    {
+        ssize_t count = ::write(fd, buffer.data() + written, used - written);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            failed = true;
+        else
+            written += count;
+    }
+    used = 0;
+    return !failed;
+}
+
+// Format an operand (add .0 to numeric literals if needed)
+static std::string formatOperand(const std::string& op)
+{
+    // Check if it's a numeric literal (all digits, possibly with decimal point)
+    if (!op.empty() && (isdigit(op[0]) || (op[0] == '-' && op.length() > 1 && isdigit(op[1]))))
+    {
+        // If it doesn't contain a decimal point or exponent, add .0
+        if (op.find_first_of(".eE") == std::string::npos)
+        {
+            return op + ".0";
+        }
+    }
+    return op;
+}
+
+static bool isComparison(TACOpcode opcode)
+{
+    return opcode == TACOpcode::LT || opcode == TACOpcode::GT || opcode == TACOpcode::LE ||
+           opcode == TACOpcode::GE || opcode == TACOpcode::EQ || opcode == TACOpcode::NE;
+}
+
+static bool isBranch(TACOpcode opcode)
+{
+    return opcode == TACOpcode::IF_FALSE || opcode == TACOpcode::IF_TRUE;
+}
+
+CCodeGenerator::CCodeGenerator()
+    : integerTyping(false), structured(true), foldExpressions(true), program(nullptr), liveness(nullptr),
+      foldedCount(0), compiler(nullptr), pipeSignalPending(false), loopCount(0), ifCount(0), gotoCount(0),
+      functionCount(0), sharedNameCount(0)
+{
+    sigemptyset(&savedSignalMask);
+}
 
 // Collect all variables and temporaries from TAC
 void CCodeGenerator::collectVariables(const std::vector<TACInstruction>& tac)
@@ -14,7 +142,8 @@ void CCodeGenerator::collectVariables(const std::vector<TACInstruction>& tac)
     for (const auto& instr : tac)
     {
         // Skip labels - they shouldn't be treated as variables
-        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO || instr.opcode == TACOpcode::IF_FALSE)
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO ||
+            instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
         {
             continue;
         }
@@ -29,7 +158,7 @@ void CCodeGenerator::collectVariables(const std::vector<TACInstruction>& tac)
         }
         
         // Collect argument variables
-        if (!instr.arg1.empty() && !isdigit(instr.arg1[0]))
+        if (!instr.arg1.empty() && !isNumericLiteral(instr.arg1))
         {
             if (instr.arg1[0] == 't')
                 temporaries.insert(instr.arg1);
@@ -37,7 +166,7 @@ void CCodeGenerator::collectVariables(const std::vector<TACInstruction>& tac)
                 variables.insert(instr.arg1);
         }
         
-        if (!instr.arg2.empty() && !isdigit(instr.arg2[0]))
+        if (!instr.arg2.empty() && !isNumericLiteral(instr.arg2))
         {
             if (instr.arg2[0] == 't')
                 temporaries.insert(instr.arg2);
@@ -48,152 +177,774 @@ void CCodeGenerator::collectVariables(const std::vector<TACInstruction>& tac)
 }
 
 // Generate variable declarations
-std::string CCodeGenerator::generateVariableDeclarations()
+void CCodeGenerator::generateVariableDeclarations(CodeWriter& out)
 {
-    std::ostringstream oss;
-    
     // Declare user variables
     if (!variables.empty())
     {
-        oss << "    // User variables\n";
+        out << "    // User variables\n";
         for (const auto& var : variables)
         {
-            oss << "    double " << var << " = 0.0;\n";
+            if (types.integerNames.count(var))
+                out << "    int64_t " << var << " = 0;\n";
+            else
+                out << "    double " << var << " = 0.0;\n";
         }
-        oss << "\n";
+        out << "\n";
     }
     
     // Declare temporaries
     if (!temporaries.empty())
     {
-        oss << "    // Temporary variables\n";
+        out << "    // Temporary variables\n";
         for (const auto& temp : temporaries)
         {
-            oss << "    double " << temp << " = 0.0;\n";
+            if (types.integerNames.count(temp))
+                out << "    int64_t " << temp << " = 0;\n";
+            else
+                out << "    double " << temp << " = 0.0;\n";
         }
-        oss << "\n";
+        out << "\n";
     }
-    
-    return oss.str();
 }
 
-// Generate C code for a single TAC instruction
-std::string CCodeGenerator::generateInstruction(const TACInstruction& instr)
+// Operand of an instruction: a name or literal, or the expression of a
+// temporary folded into the instruction (converted to the temporary's type
+// where the result could differ)
+std::string CCodeGenerator::operand(const std::string& name, size_t index, bool parenthesize)
+{
+    const std::vector<TACInstruction>& tac = *program;
+    for (size_t definition : foldedOperands[index])
+    {
+        const TACInstruction& folded = tac[definition];
+        if (folded.result != name)
+            continue;
+        std::string text = expression(folded, definition);
+        bool integerValue = isIntegerExpression(folded, definition);
+        bool integerName = types.integerNames.count(name) > 0;
+        if (integerName && !integerValue)
+            return "(int64_t)(" + text + ")";
+        // int results of comparisons only differ from double under /
+        if (!integerName && integerValue && tac[index].opcode == TACOpcode::DIV)
+            return "(double)(" + text + ")";
+        return parenthesize ? "(" + text + ")" : text;
+    }
+    if (isTemporary(name))
+        declaredTemporaries.insert(name);
+    return formatOperand(name);
+}
+
+// The C expression of an instruction has type int (comparisons, logic) or
+// int64_t (integer arithmetic) rather than double
+bool CCodeGenerator::isIntegerExpression(const TACInstruction& instr, size_t index) const
+{
+    switch (instr.opcode)
+    {
+        case TACOpcode::ADD:
+        case TACOpcode::SUB:
+        case TACOpcode::MUL:
+            return integerTyping && types.isInteger(instr.arg1) && types.isInteger(instr.arg2) &&
+                   types.integerResults[index];
+        case TACOpcode::DIV:
+            return false;
+        case TACOpcode::ASSIGN:
+            return types.integerNames.count(instr.result) > 0;
+        default:
+            return true;
+    }
+}
+
+// Right-hand side of an instruction that computes a value
+std::string CCodeGenerator::expression(const TACInstruction& instr, size_t index)
 {
-    std::ostringstream oss;
+    // Operands of integer arithmetic: integer literals lose their fraction
+    auto formatIntegerOperand = [&](const std::string& op, bool parenthesize) -> std::string {
+        if (isNumericLiteral(op))
+            return formatNumericLiteral(std::strtod(op.c_str(), nullptr));
+        return operand(op, index, parenthesize);
+    };
     
-    // Helper lambda to format operands (add .0 to numeric literals if needed)
-    auto formatOperand = [](const std::string& op) -> std::string {
-        // Check if it's a numeric literal (all digits, possibly with decimal point)
-        if (!op.empty() && (isdigit(op[0]) || (op[0] == '-' && op.length() > 1 && isdigit(op[1]))))
-        {
-            // If it doesn't contain a decimal point, add .0
-            if (op.find('.') == std::string::npos)
-            {
-                return op + ".0";
-            }
-        }
-        return op;
+    // Arithmetic runs in int64_t only if both operands and the result are
+    // integers; otherwise an integer operand is converted to double first
+    auto formatArithmetic = [&](const char* op) -> std::string {
+        bool integerOperands = types.isInteger(instr.arg1) && types.isInteger(instr.arg2);
+        if (integerTyping && integerOperands && types.integerResults[index] && instr.opcode != TACOpcode::DIV)
+            return formatIntegerOperand(instr.arg1, true) + " " + op + " " + formatIntegerOperand(instr.arg2, true);
+        std::string left = operand(instr.arg1, index);
+        if (types.integerNames.count(instr.arg1) && types.integerNames.count(instr.arg2))
+            left = "(double)" + left;
+        return left + " " + op + " " + operand(instr.arg2, index);
     };
     
     switch (instr.opcode)
     {
         case TACOpcode::ADD:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " + " << formatOperand(instr.arg2) << ";";
-            break;
+            return formatArithmetic("+");
         case TACOpcode::SUB:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " - " << formatOperand(instr.arg2) << ";";
-            break;
+            return formatArithmetic("-");
         case TACOpcode::MUL:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " * " << formatOperand(instr.arg2) << ";";
-            break;
+            return formatArithmetic("*");
         case TACOpcode::DIV:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " / " << formatOperand(instr.arg2) << ";";
-            break;
+            return formatArithmetic("/");
         case TACOpcode::ASSIGN:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << ";";
-            break;
+            if (types.integerNames.count(instr.result))
+                return formatIntegerOperand(instr.arg1, false);
+            return operand(instr.arg1, index, false);
         case TACOpcode::LT:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " < " << formatOperand(instr.arg2) << ";";
-            break;
         case TACOpcode::GT:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " > " << formatOperand(instr.arg2) << ";";
-            break;
         case TACOpcode::LE:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " <= " << formatOperand(instr.arg2) << ";";
-            break;
         case TACOpcode::GE:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " >= " << formatOperand(instr.arg2) << ";";
-            break;
         case TACOpcode::EQ:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " == " << formatOperand(instr.arg2) << ";";
-            break;
         case TACOpcode::NE:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " != " << formatOperand(instr.arg2) << ";";
-            break;
+            return comparison(instr, index);
         case TACOpcode::AND:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " && " << formatOperand(instr.arg2) << ";";
-            break;
+            return operand(instr.arg1, index) + " && " + operand(instr.arg2, index);
         case TACOpcode::OR:
-            oss << "    " << instr.result << " = " << formatOperand(instr.arg1) << " || " << formatOperand(instr.arg2) << ";";
-            break;
+            return operand(instr.arg1, index) + " || " + operand(instr.arg2, index);
         case TACOpcode::NOT:
-            oss << "    " << instr.result << " = !" << formatOperand(instr.arg1) << ";";
-            break;
+            return "!" + operand(instr.arg1, index);
+        default:
+            return "";
+    }
+}
+
+// Generate C code for a single TAC instruction
+std::string CCodeGenerator::generateInstruction(const TACInstruction& instr, size_t index)
+{
+    switch (instr.opcode)
+    {
         case TACOpcode::LABEL:
-            oss << instr.result << ":;";
-            break;
+            return instr.result + ":;";
         case TACOpcode::GOTO:
-            oss << "    goto " << instr.result << ";";
-            break;
+            return "goto " + instr.result + ";";
         case TACOpcode::IF_FALSE:
-            oss << "    if (!" << formatOperand(instr.arg1) << ") goto " << instr.result << ";";
-            break;
+            return "if (!" + operand(instr.arg1, index) + ") goto " + instr.result + ";";
+        case TACOpcode::IF_TRUE:
+            return "if (" + operand(instr.arg1, index) + ") goto " + instr.result + ";";
         case TACOpcode::PRINT:
-            oss << "    printf(\"%g\\n\", " << formatOperand(instr.arg1) << ");";
-            break;
+            return "taco_print(" + operand(instr.arg1, index, false) + ");";
         default:
-            oss << "    // Unsupported instruction";
-            break;
+            if (!writesResult(instr.opcode))
+                return "// Unsupported instruction";
+            if (isTemporary(instr.result))
+                declaredTemporaries.insert(instr.result);
+            return instr.result + " = " + expression(instr, index) + ";";
+    }
+}
+
+// C expression of a comparison instruction
+std::string CCodeGenerator::comparison(const TACInstruction& instr, size_t index)
+{
+    const char* op = "";
+    switch (instr.opcode)
+    {
+        case TACOpcode::LT: op = " < "; break;
+        case TACOpcode::GT: op = " > "; break;
+        case TACOpcode::LE: op = " <= "; break;
+        case TACOpcode::GE: op = " >= "; break;
+        case TACOpcode::EQ: op = " == "; break;
+        case TACOpcode::NE: op = " != "; break;
+        default: break;
+    }
+    return operand(instr.arg1, index) + op + operand(instr.arg2, index);
+}
+
+// Find the instructions whose value is written into the expression of its
+// only reader instead of a temporary: the reader must follow in the same
+// basic block, with no write in between to a name the expression reads. In
+// structured output a comparison read only by the next branch is always
+// folded into the condition; with expression folding every arithmetic,
+// comparison and logic instruction into a temporary may be.
+void CCodeGenerator::findFoldableExpressions()
+{
+    const std::vector<TACInstruction>& tac = *program;
+    foldable.assign(tac.size(), false);
+    foldedOperands.assign(tac.size(), std::vector<size_t>());
+    foldedReads.assign(tac.size(), std::vector<std::string>());
+    foldedCount = 0;
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+        const std::string& temp = instr.result;
+        if (!writesResult(instr.opcode) || instr.opcode == TACOpcode::ASSIGN || !isTemporary(temp))
+            continue;
+        bool intoBranch = structured && isComparison(instr.opcode) && i + 1 < tac.size() &&
+                          isBranch(tac[i + 1].opcode) && tac[i + 1].arg1 == temp;
+        if (!foldExpressions && !intoBranch)
+            continue;
+
+        // Names the expression reads, including those of expressions folded into it
+        std::vector<std::string>& reads = foldedReads[i];
+        for (const std::string* arg : {&instr.arg1, &instr.arg2})
+        {
+            if (!arg->empty() && !isNumericLiteral(*arg))
+                reads.push_back(*arg);
+        }
+        for (size_t definition : foldedOperands[i])
+            reads.insert(reads.end(), foldedReads[definition].begin(), foldedReads[definition].end());
+
+        for (size_t k = i + 1; k < tac.size(); k++)
+        {
+            const TACInstruction& next = tac[k];
+            if (next.opcode == TACOpcode::LABEL || partStarts[k])
+                break;
+            if (next.opcode != TACOpcode::GOTO && (next.arg1 == temp || next.arg2 == temp))
+            {
+                bool overwritten = writesResult(next.opcode) && next.result == temp;
+                if (next.arg1 != next.arg2 && (overwritten || liveness->isDeadAfter(k, temp)))
+                {
+                    foldable[i] = true;
+                    foldedOperands[k].push_back(i);
+                    foldedCount++;
+                }
+                break;
+            }
+            if (next.opcode == TACOpcode::GOTO || isBranch(next.opcode))
+                break;
+            if (writesResult(next.opcode) &&
+                (next.result == temp || std::find(reads.begin(), reads.end(), next.result) != reads.end()))
+                break;
+        }
     }
-    
-    return oss.str();
+}
+
+// Condition tested by a branch (true when the branch operand is nonzero);
+// a comparison folded into the branch is written without conversion
+std::string CCodeGenerator::condition(size_t branch, bool negate)
+{
+    const std::vector<TACInstruction>& tac = *program;
+    for (size_t definition : foldedOperands[branch])
+    {
+        if (isComparison(tac[definition].opcode))
+        {
+            std::string text = comparison(tac[definition], definition);
+            return negate ? "!(" + text + ")" : text;
+        }
+    }
+    std::string text = operand(tac[branch].arg1, branch);
+    return negate ? "!" + text : text;
+}
+
+// The condition of a branch reads a name, directly or through folded expressions
+bool CCodeGenerator::conditionReads(size_t branch, const std::string& name) const
+{
+    if ((*program)[branch].arg1 == name)
+        return true;
+    for (size_t definition : foldedOperands[branch])
+    {
+        const std::vector<std::string>& reads = foldedReads[definition];
+        if (std::find(reads.begin(), reads.end(), name) != reads.end())
+            return true;
+    }
+    return false;
+}
+
+// Labels go in the first column and are only kept if a goto remains
+void CCodeGenerator::emitLine(int depth, const std::string& text, const std::string& label)
+{
+    lines.push_back(depth < 0 ? text : std::string(4 * (depth + 1), ' ') + text);
+    lineLabels.push_back(label);
+}
+
+// Emit the instructions [begin, end) as statements at a nesting depth
+void CCodeGenerator::emitRange(size_t begin, size_t end, int depth, const LoopContext* loop)
+{
+    const std::vector<TACInstruction>& tac = *program;
+    size_t i = begin;
+    while (i < end)
+    {
+        const TACInstruction& instr = tac[i];
+        if (instr.opcode == TACOpcode::LABEL)
+        {
+            // The last jump back to a label within the range closes a loop
+            size_t latch = i;
+            auto jumps = jumpsTo.find(instr.result);
+            if (jumps != jumpsTo.end())
+            {
+                for (size_t jump : jumps->second)
+                {
+                    if (jump > i && jump < end)
+                        latch = jump;
+                }
+            }
+            if (latch > i)
+            {
+                i = emitLoop(i, latch, depth);
+                continue;
+            }
+            emitLine(-1, instr.result + ":;", instr.result);
+            i++;
+        }
+        else if (instr.opcode == TACOpcode::GOTO || isBranch(instr.opcode))
+        {
+            std::string guard;
+            if (isBranch(instr.opcode))
+                guard = "if (" + condition(i, instr.opcode == TACOpcode::IF_FALSE) + ") ";
+
+            if (loop && instr.result == loop->exit)
+            {
+                emitLine(depth, guard + "break;");
+                i++;
+                continue;
+            }
+            if (loop && !loop->header.empty() && instr.result == loop->header)
+            {
+                emitLine(depth, guard + "continue;");
+                i++;
+                continue;
+            }
+
+            // A forward branch within the range skips a then part; a jump
+            // at the end of the then part over a later label adds an else part
+            auto target = labelPositions.find(instr.result);
+            if (isBranch(instr.opcode) && target != labelPositions.end() && target->second > i && target->second < end)
+            {
+                size_t thenEnd = target->second;
+                size_t elseEnd = thenEnd;
+                const TACInstruction& last = tac[thenEnd - 1];
+                if (thenEnd - 1 > i && last.opcode == TACOpcode::GOTO)
+                {
+                    auto join = labelPositions.find(last.result);
+                    if (join != labelPositions.end() && join->second > thenEnd && join->second < end)
+                    {
+                        elseEnd = join->second;
+                        thenEnd--;
+                    }
+                }
+
+                ifCount++;
+                emitLine(depth, "if (" + condition(i, instr.opcode == TACOpcode::IF_TRUE) + ") {");
+                emitRange(i + 1, thenEnd, depth + 1, loop);
+                if (elseEnd != target->second)
+                {
+                    emitLine(depth, "} else {");
+                    emitRange(target->second, elseEnd, depth + 1, loop);
+                }
+                emitLine(depth, "}");
+                i = elseEnd;
+                continue;
+            }
+
+            gotoCount++;
+            gotoTargets.insert(instr.result);
+            emitLine(depth, guard + "goto " + instr.result + ";");
+            i++;
+        }
+        else
+        {
+            if (!foldable[i])
+                emitLine(depth, generateInstruction(instr, i));
+            i++;
+        }
+    }
+}
+
+// Emit the loop from a header label to the jump back to it at the latch, and
+// return the index after the latch. A loop that tests its exit first becomes
+// while (or for, with the update at the end of the body moved into the
+// statement), one that tests at the latch do-while, and any other for (;;).
+size_t CCodeGenerator::emitLoop(size_t header, size_t latch, int depth)
+{
+    const std::vector<TACInstruction>& tac = *program;
+    const TACInstruction& back = tac[latch];
+    const std::string& label = tac[header].result;
+
+    LoopContext context;
+    if (latch + 1 < tac.size() && tac[latch + 1].opcode == TACOpcode::LABEL)
+        context.exit = tac[latch + 1].result;
+    loopCount++;
+    emitLine(-1, label + ":;", label);
+
+    if (isBranch(back.opcode))
+    {
+        // continue would skip to the condition, so jumps to the header stay gotos
+        emitLine(depth, "do {");
+        emitRange(header + 1, latch, depth + 1, &context);
+        emitLine(depth, "} while (" + condition(latch, back.opcode == TACOpcode::IF_FALSE) + ");");
+        return latch + 1;
+    }
+
+    // Instructions folded into the exit test are part of its condition
+    size_t test = header + 1;
+    while (test < latch && foldable[test])
+        test++;
+    if (test >= latch || !isBranch(tac[test].opcode) || context.exit.empty() || tac[test].result != context.exit)
+    {
+        context.header = label;
+        emitLine(depth, "for (;;) {");
+        emitRange(header + 1, latch, depth + 1, &context);
+        emitLine(depth, "}");
+        return latch + 1;
+    }
+    std::string loopCondition = condition(test, tac[test].opcode == TACOpcode::IF_TRUE);
+
+    // Update: an assignment to a name the condition reads ends the body,
+    // possibly through a temporary computed right before it; there must be no
+    // continue, which would skip it
+    size_t stepBegin = latch;
+    const std::vector<size_t>& backJumps = jumpsTo[label];
+    bool hasContinue = std::any_of(backJumps.begin(), backJumps.end(),
+                                   [&](size_t jump) { return jump > header && jump < latch; });
+    const TACInstruction& update = tac[latch - 1];
+    if (!hasContinue && latch - 1 > test && writesResult(update.opcode) && !isTemporary(update.result) &&
+        conditionReads(test, update.result))
+    {
+        stepBegin = latch - 1;
+        const TACInstruction& computed = tac[latch - 2];
+        if (latch - 2 > test && writesResult(computed.opcode) && isTemporary(computed.result) &&
+            (update.arg1 == computed.result || update.arg2 == computed.result) &&
+            liveness->isDeadAfter(latch - 1, computed.result))
+            stepBegin--;
+    }
+
+    if (stepBegin == latch)
+    {
+        context.header = label;
+        emitLine(depth, "while (" + loopCondition + ") {");
+    }
+    else
+    {
+        std::string step;
+        for (size_t j = stepBegin; j < latch; j++)
+        {
+            if (foldable[j])
+                continue;
+            std::string statement = generateInstruction(tac[j], j);
+            step += (step.empty() ? "" : ", ") + statement.substr(0, statement.size() - 1);
+        }
+        emitLine(depth, "for (; " + loopCondition + "; " + step + ") {");
+    }
+    emitRange(test + 1, stepBegin, depth + 1, &context);
+    emitLine(depth, "}");
+    return latch + 1;
+}
+
+// Set up the analyses shared by all code emitted for a program
+void CCodeGenerator::prepare(const std::vector<TACInstruction>& tac, const TemporaryLiveness& temporaryLiveness)
+{
+    program = &tac;
+    liveness = &temporaryLiveness;
+    declaredTemporaries.clear();
+    labelPositions.clear();
+    jumpsTo.clear();
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::LABEL)
+            labelPositions[tac[i].result] = i;
+        else if (tac[i].opcode == TACOpcode::GOTO || isBranch(tac[i].opcode))
+            jumpsTo[tac[i].result].push_back(i);
+    }
+    if (partStarts.size() != tac.size())
+        partStarts.assign(tac.size(), false);
+    findFoldableExpressions();
+    loopCount = 0;
+    ifCount = 0;
+    gotoCount = 0;
+}
+
+// Statements for the instructions [begin, end), which no jump enters or leaves
+void CCodeGenerator::emitBodyLines(size_t begin, size_t end)
+{
+    const std::vector<TACInstruction>& tac = *program;
+    lines.clear();
+    lineLabels.clear();
+    gotoTargets.clear();
+    if (structured)
+    {
+        emitRange(begin, end, 0, nullptr);
+        return;
+    }
+    for (size_t i = begin; i < end; i++)
+    {
+        if (foldable[i])
+            continue;
+        std::string line = generateInstruction(tac[i], i);
+        if (tac[i].opcode == TACOpcode::GOTO || isBranch(tac[i].opcode))
+            gotoCount++;
+        if (!line.empty())
+            emitLine(tac[i].opcode == TACOpcode::LABEL ? -1 : 0, line);
+    }
+}
+
+// Write the emitted lines, dropping labels no goto reaches
+void CCodeGenerator::writeBody(CodeWriter& out)
+{
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        if (lineLabels[i].empty() || gotoTargets.count(lineLabels[i]))
+            out << lines[i] << '\n';
+    }
+    lines.clear();
+    lineLabels.clear();
+}
+
+std::string CCodeGenerator::emitBody(size_t begin, size_t end)
+{
+    std::string body;
+    emitBodyLines(begin, end);
+    CodeWriter out(body);
+    writeBody(out);
+    out.flush();
+    return body;
+}
+
+// C declaration of a name with its type
+std::string CCodeGenerator::declaration(const std::string& name) const
+{
+    return (types.integerNames.count(name) ? "int64_t " : "double ") + name;
 }
 
 // Generate complete C program from TAC
 std::string CCodeGenerator::generate(const std::vector<TACInstruction>& tac)
+{
+    std::string code;
+    {
+        CodeWriter out(code);
+        generate(tac, out);
+    }
+    return code;
+}
+
+// Generate the program straight into a writer: the body is kept as lines
+// only until the declarations it needs are known
+void CCodeGenerator::generate(const std::vector<TACInstruction>& tac, CodeWriter& out)
 {
     collectVariables(tac);
-    
-    std::ostringstream oss;
+    types = TypeInfo();
+    if (integerTyping)
+        types = inferTypes(tac);
+
+    ControlFlowGraph cfg(tac);
+    TemporaryLiveness temporaryLiveness(cfg);
+    partStarts.assign(tac.size(), false);
+    prepare(tac, temporaryLiveness);
+    emitBodyLines(0, tac.size());
+    program = nullptr;
+    liveness = nullptr;
+
+    // Temporaries that only lived in folded expressions need no declaration
+    for (auto it = temporaries.begin(); it != temporaries.end();)
+    {
+        if (!isTemporary(*it) || declaredTemporaries.count(*it))
+            ++it;
+        else
+            it = temporaries.erase(it);
+    }
     
     // Generate C header
-    oss << "// Generated C code from TACO compiler\n";
-    oss << "#include <stdio.h>\n";
-    oss << "#include <math.h>\n\n";
+    out << "// Generated C code from TACO compiler\n";
+    out << "#include <stddef.h>\n";
+    out << "#include <errno.h>\n";
+    out << "#include <unistd.h>\n";
+    if (!types.integerNames.empty())
+        out << "#include <stdint.h>\n";
+    out << "#include <math.h>\n\n";
+    out << runtimeFormatSource << printRuntime;
     
     // Generate main function
-    oss << "int main() {\n";
+    out << "int main() {\n";
     
     // Variable declarations
-    oss << generateVariableDeclarations();
+    generateVariableDeclarations(out);
     
-    // Generate instructions
-    oss << "    // Program code\n";
-    for (const auto& instr : tac)
+    out << "    // Program code\n";
+    writeBody(out);
+    
+    // End main function
+    out << "\n    taco_flush();\n";
+    out << "    return 0;\n";
+    out << "}\n";
+    out.flush();
+}
+
+// Generate the program into a C file without building it in memory first
+bool CCodeGenerator::generateToFile(const std::vector<TACInstruction>& tac, const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
     {
-        std::string line = generateInstruction(instr);
-        if (!line.empty())
+        std::cerr << "Error: Could not open file " << filename << " for writing" << std::endl;
+        return false;
+    }
+    CodeWriter out(fd);
+    generate(tac, out);
+    bool written = out.good();
+    if (close(fd) != 0)
+        written = false;
+    if (!written)
+    {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    std::cout << "C code written to: " << filename << std::endl;
+    return true;
+}
+
+// Generate the program as functions spread over several translation units.
+// The program is cut into parts of about partSize instructions where no jump
+// crosses, and each part becomes a function that main calls once, in order.
+// Names used by more than one part live in a struct passed to every part:
+// a part copies the ones it uses into locals on entry (so gcc can keep them
+// in registers) and stores the ones it writes back before returning. Parts
+// go to the shards in order, balanced by instruction count; shard 0 also
+// holds main.
+std::vector<std::string> CCodeGenerator::generateShards(const std::vector<TACInstruction>& tac, size_t shardCount)
+{
+    collectVariables(tac);
+    types = TypeInfo();
+    if (integerTyping)
+        types = inferTypes(tac);
+
+    // Cut points: positions no jump crosses
+    std::vector<int> crossing(tac.size() + 1, 0);
+    std::unordered_map<std::string, size_t> labels;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::LABEL)
+            labels[tac[i].result] = i;
+    }
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode != TACOpcode::GOTO && !isBranch(tac[i].opcode))
+            continue;
+        auto target = labels.find(tac[i].result);
+        if (target == labels.end())
+            continue;
+        crossing[std::min(i, target->second) + 1]++;
+        crossing[std::max(i, target->second) + 1]--;
+    }
+    std::vector<size_t> starts;
+    partStarts.assign(tac.size(), false);
+    int open = 0;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        open += crossing[i];
+        if (i == 0 || (open == 0 && i - starts.back() >= partSize))
         {
-            oss << line << "\n";
+            starts.push_back(i);
+            partStarts[i] = true;
         }
     }
-    
-    // End main function
-    oss << "\n    return 0;\n";
-    oss << "}\n";
-    
-    return oss.str();
+    if (starts.empty())
+        starts.push_back(0);
+    starts.push_back(tac.size());
+    size_t partCount = starts.size() - 1;
+
+    ControlFlowGraph cfg(tac);
+    TemporaryLiveness temporaryLiveness(cfg);
+    prepare(tac, temporaryLiveness);
+
+    // Emit every part and record the names it uses and writes
+    std::vector<std::string> bodies(partCount);
+    std::vector<std::set<std::string>> used(partCount);
+    std::vector<std::set<std::string>> written(partCount);
+    std::unordered_map<std::string, size_t> partsUsing;
+    for (size_t part = 0; part < partCount; part++)
+    {
+        declaredTemporaries.clear();
+        bodies[part] = emitBody(starts[part], starts[part + 1]);
+        for (size_t i = starts[part]; i < starts[part + 1]; i++)
+        {
+            const TACInstruction& instr = tac[i];
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            std::vector<std::string> names = {instr.arg1, instr.arg2};
+            if (writesResult(instr.opcode))
+                names.push_back(instr.result);
+            for (const std::string& name : names)
+            {
+                // Folded temporaries do not appear in the code
+                if (name.empty() || isNumericLiteral(name) || (isTemporary(name) && !declaredTemporaries.count(name)))
+                    continue;
+                if (used[part].insert(name).second)
+                    partsUsing[name]++;
+            }
+            if (writesResult(instr.opcode) && used[part].count(instr.result))
+                written[part].insert(instr.result);
+        }
+    }
+    program = nullptr;
+    liveness = nullptr;
+
+    std::set<std::string> shared;
+    for (const auto& entry : partsUsing)
+    {
+        if (entry.second > 1)
+            shared.insert(entry.first);
+    }
+    sharedNameCount = shared.size();
+
+    // Every translation unit starts with the state struct and the part prototypes
+    std::ostringstream common;
+    common << "// Generated C code from TACO compiler\n";
+    common << "#include <stddef.h>\n";
+    common << "#include <errno.h>\n";
+    common << "#include <unistd.h>\n";
+    if (!types.integerNames.empty())
+        common << "#include <stdint.h>\n";
+    common << "#include <math.h>\n\n";
+    common << "void taco_print(double value);\n";
+    common << "void taco_flush(void);\n\n";
+    common << "// Names shared between parts\n";
+    common << "struct taco_state {\n";
+    for (const auto& name : shared)
+        common << "    " << declaration(name) << ";\n";
+    if (shared.empty())
+        common << "    char unused;\n";
+    common << "};\n\n";
+    for (size_t part = 0; part < partCount; part++)
+        common << "void taco_part_" << part << "(struct taco_state* taco_state);\n";
+
+    // Balance the shards by instruction count
+    shardCount = std::max<size_t>(1, std::min(shardCount, partCount));
+    std::vector<std::string> shards(shardCount, common.str());
+    shards[0] += runtimeFormatSource;
+    shards[0] += printRuntime;
+    std::vector<bool> filled(shardCount, false);
+    for (size_t part = 0; part < partCount; part++)
+    {
+        size_t shard = starts[part] * shardCount / std::max<size_t>(1, tac.size());
+        filled[shard] = true;
+        std::ostringstream function;
+        function << "\nvoid taco_part_" << part << "(struct taco_state* taco_state) {\n";
+        for (const auto& name : used[part])
+        {
+            if (shared.count(name))
+                function << "    " << declaration(name) << " = taco_state->" << name << ";\n";
+            else
+                function << "    " << declaration(name) << " = 0;\n";
+        }
+        function << "\n    // Program code\n";
+        function << bodies[part];
+        for (const auto& name : written[part])
+        {
+            if (shared.count(name))
+                function << "    taco_state->" << name << " = " << name << ";\n";
+        }
+        function << "}\n";
+        shards[shard] += function.str();
+    }
+
+    std::ostringstream entry;
+    entry << "\nint main() {\n";
+    entry << "    static struct taco_state state;\n";
+    for (size_t part = 0; part < partCount; part++)
+        entry << "    taco_part_" << part << "(&state);\n";
+    entry << "    taco_flush();\n";
+    entry << "    return 0;\n";
+    entry << "}\n";
+    shards[0] += entry.str();
+
+    // Shards too small to receive a part are dropped
+    std::vector<std::string> units;
+    for (size_t shard = 0; shard < shardCount; shard++)
+    {
+        if (shard == 0 || filled[shard])
+            units.push_back(shards[shard]);
+    }
+    functionCount = partCount;
+    return units;
 }
 
 // Write generated code to file
@@ -254,3 +1005,154 @@ bool CCodeGenerator::compileToExecutable(const std::string& cFilename, const std
     std::cout << "Executable created: " << outputExecutable << std::endl;
     return true;
 }
+
+// gcc compiles the program from a pipe, so no temporary C file is written.
+// Its diagnostics go to stderr as they are produced.
+int CCodeGenerator::startCompiler(const std::string& outputExecutable)
+{
+    std::string command = "gcc -x c -o " + outputExecutable + " - -lm 1>&2";
+
+    std::cout << "Compiling C code to executable..." << std::endl;
+    std::cout << "Command: " << command << std::endl;
+
+    // A compiler that exits early makes writes fail with EPIPE instead of
+    // killing taco. Only this thread blocks SIGPIPE, and only until
+    // finishCompiler, so the process's handler is left alone.
+    sigset_t pipeSignal;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    sigset_t pending;
+    sigpending(&pending);
+    pipeSignalPending = sigismember(&pending, SIGPIPE) == 1;
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &savedSignalMask);
+
+    std::fflush(nullptr);
+    compiler = popen(command.c_str(), "w");
+    if (!compiler)
+    {
+        restoreSignalMask();
+        std::cerr << "Error: Could not execute GCC compiler" << std::endl;
+        return -1;
+    }
+    return fileno(compiler);
+}
+
+bool CCodeGenerator::finishCompiler()
+{
+    if (!compiler)
+        return false;
+    int returnCode = pclose(compiler);
+    compiler = nullptr;
+    restoreSignalMask();
+    if (returnCode != 0)
+    {
+        std::cerr << "GCC compilation failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Discard the SIGPIPE that writes to a gcc which exited raised while it was
+// blocked, then unblock it again
+void CCodeGenerator::restoreSignalMask()
+{
+    sigset_t pending;
+    sigpending(&pending);
+    if (!pipeSignalPending && sigismember(&pending, SIGPIPE) == 1)
+    {
+        sigset_t pipeSignal;
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        struct timespec noWait = {0, 0};
+        sigtimedwait(&pipeSignal, nullptr, &noWait);
+    }
+    pthread_sigmask(SIG_SETMASK, &savedSignalMask, nullptr);
+}
+
+// Compile translation units to objects with one gcc process each, as many
+// at a time as there are hardware threads, then link the objects
+bool CCodeGenerator::compileShardsToExecutable(const std::vector<std::string>& cFilenames, const std::string& outputExecutable)
+{
+    size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Compiling " << cFilenames.size() << " translation units in parallel (" << jobs
+              << " at a time)..." << std::endl;
+
+    std::vector<std::string> objects;
+    std::vector<FILE*> pipes;
+    bool compiled = true;
+    size_t finished = 0;
+    for (size_t i = 0; i <= cFilenames.size(); i++)
+    {
+        // Wait for the oldest gcc once all job slots are taken, and for the
+        // rest after the last one started
+        while (finished < pipes.size() && (pipes.size() - finished >= jobs || i == cFilenames.size()))
+        {
+            FILE* pipe = pipes[finished];
+            const std::string& cFilename = cFilenames[finished++];
+            if (!pipe)
+            {
+                std::cerr << "Error: Could not execute GCC compiler" << std::endl;
+                compiled = false;
+                continue;
+            }
+            char buffer[256];
+            std::string result;
+            while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+                result += buffer;
+            if (pclose(pipe) != 0)
+            {
+                std::cerr << "GCC compilation of " << cFilename << " failed:" << std::endl;
+                std::cerr << result << std::endl;
+                compiled = false;
+            }
+            else if (!result.empty())
+            {
+                std::cout << "Compiler warnings/notes:" << std::endl;
+                std::cout << result << std::endl;
+            }
+        }
+        if (i == cFilenames.size())
+            break;
+
+        std::string object = cFilenames[i].substr(0, cFilenames[i].rfind('.')) + ".o";
+        std::string command = "gcc -c -o " + object + " " + cFilenames[i] + " 2>&1";
+        std::cout << "Command: " << command << std::endl;
+        objects.push_back(object);
+        pipes.push_back(popen(command.c_str(), "r"));
+    }
+
+    if (compiled)
+    {
+        std::string command = "gcc -o " + outputExecutable;
+        for (const auto& object : objects)
+            command += " " + object;
+        command += " -lm 2>&1";
+        std::cout << "Command: " << command << std::endl;
+
+        FILE* pipe = popen(command.c_str(), "r");
+        if (!pipe)
+        {
+            std::cerr << "Error: Could not execute GCC compiler" << std::endl;
+            compiled = false;
+        }
+        else
+        {
+            char buffer[256];
+            std::string result;
+            while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+                result += buffer;
+            if (pclose(pipe) != 0)
+            {
+                std::cerr << "GCC linking failed:" << std::endl;
+                std::cerr << result << std::endl;
+                compiled = false;
+            }
+        }
+    }
+
+    for (const auto& object : objects)
+        std::remove(object.c_str());
+    if (compiled)
+        std::cout << "Executable created: " << outputExecutable << std::endl;
+    return compiled;
+}
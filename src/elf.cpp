@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstring>
+#include "../include/elf.h"
+#include "../include/files.h"
+#include "../include/jit.h"
+#include "../include/interpreter.h"
+#include "runtime_blob.h"       // runtimeBlob: generated by the Makefile from runtime/taco_rt.c
+
+// Address space layout: text segment from the ELF header at the base address,
+// data segment on the next page
+static const uint64_t baseAddress = 0x400000;
+static const uint64_t pageSize = 0x1000;
+static const uint64_t headerSize = 64;
+static const uint64_t programHeaderSize = 56;
+static const uint64_t sectionHeaderSize = 64;
+static const uint64_t programHeaderCount = 3;      // text, data, non-executable stack
+static const uint64_t sectionCount = 5;            // null, .text, .data, .bss, .shstrtab
+static const uint64_t runtimePrintOffset = 0;      // Entry jumps at the start of the runtime
+static const uint64_t runtimeExitOffset = 5;
+static const uint64_t outputBufferSize = 8 + (1 << 16);    // struct taco_output
+static const char sectionNames[] = "\0.text\0.data\0.bss\0.shstrtab";
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Little-endian field writers
+static void put(std::vector<uint8_t>& bytes, uint64_t offset, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++)
+        bytes[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static void putProgramHeader(std::vector<uint8_t>& bytes, uint64_t at, uint32_t type, uint32_t flags,
+                             uint64_t offset, uint64_t address, uint64_t fileSize, uint64_t memorySize)
+{
+    put(bytes, at, type, 4);
+    put(bytes, at + 4, flags, 4);
+    put(bytes, at + 8, offset, 8);
+    put(bytes, at + 16, address, 8);
+    put(bytes, at + 24, address, 8);
+    put(bytes, at + 32, fileSize, 8);
+    put(bytes, at + 40, memorySize, 8);
+    put(bytes, at + 48, type == 1 ? pageSize : 16, 8);
+}
+
+static void putSectionHeader(std::vector<uint8_t>& bytes, uint64_t at, uint32_t name, uint32_t type, uint64_t flags,
+                             uint64_t address, uint64_t offset, uint64_t size, uint64_t alignment)
+{
+    put(bytes, at, name, 4);
+    put(bytes, at + 4, type, 4);
+    put(bytes, at + 8, flags, 8);
+    put(bytes, at + 16, address, 8);
+    put(bytes, at + 24, offset, 8);
+    put(bytes, at + 32, size, 8);
+    put(bytes, at + 48, alignment, 8);
+}
+
+ELFWriter::ELFWriter() : programSize(0), textSize(0), dataSize(0), bssSize(0) {}
+
+size_t ELFWriter::getRuntimeSize() const
+{
+    return sizeof(runtimeBlob);
+}
+
+bool ELFWriter::build(const std::vector<TACInstruction>& tac, std::vector<uint8_t>& bytes, std::string& error)
+{
+    SlotLayout layout(tac);
+    std::vector<uint8_t> program;
+    size_t fusedBranches;
+    if (!JITCompiler::generateCode(tac, 0, 0, tac.size(), layout, program, fusedBranches, error))
+        return false;
+
+    // .text: start stub, program, runtime
+    uint64_t textOffset = alignUp(headerSize + programHeaderCount * programHeaderSize, 64);
+    uint64_t stubSize = 38;
+    uint64_t programOffset = alignUp(textOffset + stubSize, 16);
+    uint64_t runtimeOffset = alignUp(programOffset + program.size(), 64);
+    uint64_t textEnd = runtimeOffset + sizeof(runtimeBlob);
+
+    // .data: value slots; .bss: output buffer
+    const std::vector<double>& values = layout.getInitialValues();
+    uint64_t dataOffset = alignUp(textEnd, pageSize);
+    uint64_t dataEnd = dataOffset + values.size() * sizeof(double);
+    uint64_t bssOffset = alignUp(dataEnd, 16);
+    uint64_t namesOffset = dataEnd;
+    uint64_t sectionsOffset = alignUp(namesOffset + sizeof(sectionNames), 8);
+    uint64_t fileSize = sectionsOffset + sectionCount * sectionHeaderSize;
+
+    auto address = [](uint64_t offset) { return baseAddress + offset; };
+    bytes.assign(fileSize, 0);
+
+    // ELF header
+    const uint8_t ident[] = {0x7F, 'E', 'L', 'F', 2, 1, 1, 0};     // 64-bit, little-endian, version 1, System V
+    for (size_t i = 0; i < sizeof(ident); i++)
+        bytes[i] = ident[i];
+    put(bytes, 16, 2, 2);                               // ET_EXEC
+    put(bytes, 18, 62, 2);                              // EM_X86_64
+    put(bytes, 20, 1, 4);
+    put(bytes, 24, address(textOffset), 8);             // Entry: start stub
+    put(bytes, 32, headerSize, 8);
+    put(bytes, 40, sectionsOffset, 8);
+    put(bytes, 52, headerSize, 2);
+    put(bytes, 54, programHeaderSize, 2);
+    put(bytes, 56, programHeaderCount, 2);
+    put(bytes, 58, sectionHeaderSize, 2);
+    put(bytes, 60, sectionCount, 2);
+    put(bytes, 62, sectionCount - 1, 2);                // .shstrtab
+
+    // Segments: text (R+X) from the start of the file, data (R+W) with .bss, stack (R+W)
+    uint64_t at = headerSize;
+    putProgramHeader(bytes, at, 1, 5, 0, baseAddress, textEnd, textEnd);
+    putProgramHeader(bytes, at + programHeaderSize, 1, 6, dataOffset, address(dataOffset),
+                     dataEnd - dataOffset, bssOffset + outputBufferSize - dataOffset);
+    putProgramHeader(bytes, at + 2 * programHeaderSize, 0x6474E551, 6, 0, 0, 0, 0);    // PT_GNU_STACK
+
+    // Start stub: program(values, output, print), then exit(output) flushes and exits
+    uint64_t stub = textOffset;
+    auto relative = [&](uint64_t target, uint64_t next) { return address(target) - address(next); };
+    const uint8_t stubCode[] = {
+        0x48, 0x8D, 0x3D, 0, 0, 0, 0,       // lea rdi, [rip + values]
+        0x48, 0x8D, 0x35, 0, 0, 0, 0,       // lea rsi, [rip + output]
+        0x48, 0x8D, 0x15, 0, 0, 0, 0,       // lea rdx, [rip + print]
+        0xE8, 0, 0, 0, 0,                   // call program
+        0x48, 0x8D, 0x3D, 0, 0, 0, 0,       // lea rdi, [rip + output]
+        0xE8, 0, 0, 0, 0                    // call exit
+    };
+    for (size_t i = 0; i < sizeof(stubCode); i++)
+        bytes[stub + i] = stubCode[i];
+    put(bytes, stub + 3, relative(dataOffset, stub + 7), 4);
+    put(bytes, stub + 10, relative(bssOffset, stub + 14), 4);
+    put(bytes, stub + 17, relative(runtimeOffset + runtimePrintOffset, stub + 21), 4);
+    put(bytes, stub + 22, relative(programOffset, stub + 26), 4);
+    put(bytes, stub + 29, relative(bssOffset, stub + 33), 4);
+    put(bytes, stub + 34, relative(runtimeOffset + runtimeExitOffset, stub + 38), 4);
+
+    std::copy(program.begin(), program.end(), bytes.begin() + programOffset);
+    std::copy(runtimeBlob, runtimeBlob + sizeof(runtimeBlob), bytes.begin() + runtimeOffset);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        put(bytes, dataOffset + 8 * i, bits, 8);
+    }
+
+    // Sections, for tools like objdump; the loader only reads the segments
+    std::copy(sectionNames, sectionNames + sizeof(sectionNames), bytes.begin() + namesOffset);
+    at = sectionsOffset + sectionHeaderSize;
+    putSectionHeader(bytes, at, 1, 1, 6, address(textOffset), textOffset, textEnd - textOffset, 64);
+    putSectionHeader(bytes, at + sectionHeaderSize, 7, 1, 3, address(dataOffset), dataOffset, dataEnd - dataOffset, 16);
+    putSectionHeader(bytes, at + 2 * sectionHeaderSize, 13, 8, 3, address(bssOffset), bssOffset, outputBufferSize, 16);
+    putSectionHeader(bytes, at + 3 * sectionHeaderSize, 18, 3, 0, 0, namesOffset, sizeof(sectionNames), 1);
+
+    programSize = program.size();
+    textSize = textEnd - textOffset;
+    dataSize = dataEnd - dataOffset;
+    bssSize = outputBufferSize;
+    return true;
+}
+
+bool ELFWriter::write(const std::vector<TACInstruction>& tac, const std::string& filename, std::string& error)
+{
+    std::vector<uint8_t> bytes;
+    if (!build(tac, bytes, error))
+        return false;
+
+    if (!replaceFile(filename, std::string(bytes.begin(), bytes.end()), true))
+    {
+        error = "Could not write executable: " + filename;
+        return false;
+    }
+    return true;
+}
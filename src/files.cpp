@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/files.h"
+
+bool replaceFile(const std::string& filename, const std::string& contents, bool executable)
+{
+    // A unique name, so threads and processes writing the same file do not meet
+    std::string temporary = filename + ".tmpXXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+        return false;
+
+    bool written = true;
+    size_t offset = 0;
+    while (written && offset < contents.size())
+    {
+        ssize_t count = ::write(fd, contents.data() + offset, contents.size() - offset);
+        written = count > 0;
+        offset += written ? static_cast<size_t>(count) : 0;
+    }
+    written = written && fchmod(fd, executable ? 0755 : 0644) == 0;
+    written = ::close(fd) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
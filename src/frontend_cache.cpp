@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <climits>
+#include <unordered_set>
+#include "../include/frontend_cache.h"
+#include "../include/cache.h"
+#include "../include/files.h"
+
+static const char fileMagic[] = "taco-frontend";
+static const int fragmentVersion = 1;   // Layout of the file and its fragments
+
+// First line of a cache file: fragments written in another layout or by
+// another version of the TAC generator are not reused
+static std::string fileHeader()
+{
+    return std::string(fileMagic) + " " + std::to_string(fragmentVersion) + " " +
+           std::to_string(TACGenerator::version) + "\n";
+}
+
+static bool hasLabelResult(TACOpcode opcode)
+{
+    return opcode == TACOpcode::LABEL || opcode == TACOpcode::GOTO ||
+           opcode == TACOpcode::IF_FALSE || opcode == TACOpcode::IF_TRUE;
+}
+
+// Serialized instructions: "<opcode> <result> <arg1> <arg2>" per line, with
+// "-" for an empty operand
+static void serialize(const std::vector<TACInstruction>& tac, std::string& text)
+{
+    for (const auto& instr : tac)
+    {
+        text += std::to_string(static_cast<int>(instr.opcode));
+        for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+        {
+            text += ' ';
+            text += operand->empty() ? "-" : *operand;
+        }
+        text += '\n';
+    }
+}
+
+// Operand [start, end) of a fragment into operand; a generated name (prefix
+// and a number below count) is shifted by base
+static void decodeOperand(std::string& operand, const char* start, const char* end, char prefix, int count,
+                          int base)
+{
+    if (end - start == 1 && *start == '-')
+        return;
+    if (base != 0 && end - start >= 2 && *start == prefix)
+    {
+        int number = 0;
+        const char* digit = start + 1;
+        while (digit < end && *digit >= '0' && *digit <= '9')
+            number = number * 10 + (*digit++ - '0');
+        if (digit == end && number < count)
+        {
+            char name[16];
+            operand.assign(name, std::snprintf(name, sizeof(name), "%c%d", prefix, number + base));
+            return;
+        }
+    }
+    operand.assign(start, end);
+}
+
+FrontEndCache::FrontEndCache(CompilationContext& context, const std::string& directory,
+                             const std::string& sourcePath)
+    : context(context), usedCount(0), reusedCount(0), savedMilliseconds(0)
+{
+    char resolved[PATH_MAX];
+    std::string path = realpath(sourcePath.c_str(), resolved) ? resolved : sourcePath;
+    std::string frontendDirectory = directory + "/frontend";
+    if (makeDirectories(frontendDirectory))
+        filename = frontendDirectory + "/" + contentHash(path);
+    load();
+}
+
+// Fragments stay serialized until a build splices them; loading only checks
+// the shape of every line
+void FrontEndCache::load()
+{
+    if (filename.empty())
+        return;
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        return;
+    in.seekg(0, std::ios::end);
+    std::string data(static_cast<size_t>(std::max<std::streamoff>(in.tellg(), 0)), '\0');
+    in.seekg(0, std::ios::beg);
+    if (!in.read(&data[0], data.size()))
+        return;
+
+    std::string header = fileHeader();
+    if (data.compare(0, header.size(), header) != 0)
+        return;
+    const char* p = data.c_str() + header.size();
+    const char* end = data.c_str() + data.size();
+    while (p < end)
+    {
+        // <key> <temps> <labels> <milliseconds> <instructions>
+        const char* space = static_cast<const char*>(std::memchr(p, ' ', end - p));
+        if (!space)
+            break;
+        std::string key(p, space);
+        char* next;
+        Fragment fragment;
+        fragment.tempCount = static_cast<int>(std::strtol(space, &next, 10));
+        fragment.labelCount = static_cast<int>(std::strtol(next, &next, 10));
+        fragment.milliseconds = std::strtod(next, &next);
+        fragment.instructionCount = std::strtoul(next, &next, 10);
+        if (*next != '\n')
+            break;
+        p = next + 1;
+
+        const char* first = p;
+        for (size_t i = 0; i < fragment.instructionCount; i++)
+        {
+            // <opcode> and three operands
+            int opcode = 0;
+            const char* digit = p;
+            while (digit < end && *digit >= '0' && *digit <= '9')
+                opcode = opcode * 10 + (*digit++ - '0');
+            int spaces = 0;
+            const char* newline = digit;
+            while (newline < end && *newline != '\n')
+                spaces += *newline++ == ' ';
+            if (digit == p || newline == end || opcode > static_cast<int>(TACOpcode::PRINT) || spaces != 3)
+            {
+                previous.clear();
+                return;
+            }
+            p = newline + 1;
+        }
+        fragment.text.assign(first, p);
+        previous[key] = std::move(fragment);
+    }
+}
+
+// A statement ends after a ';' or '}' outside parentheses and braces, unless
+// an else follows
+void FrontEndCache::parse(const std::vector<Token>& tokens, std::vector<std::unique_ptr<ASTNode>>& ast,
+                          std::vector<std::string>& errors)
+{
+    statements.clear();
+    current.clear();
+    for (auto& entry : previous)
+        entry.second.used = false;
+    usedCount = 0;
+    reusedCount = 0;
+    savedMilliseconds = 0;
+    auto parseStart = std::chrono::high_resolution_clock::now();
+    double freshMilliseconds = 0;
+
+    std::string text;
+    size_t i = 0;
+    while (i < tokens.size() && tokens[i].type != TokenType::END_OF_FILE)
+    {
+        size_t begin = i;
+        int depth = 0;
+        while (i < tokens.size() && tokens[i].type != TokenType::END_OF_FILE)
+        {
+            TokenType type = tokens[i++].type;
+            if (type == TokenType::LPAREN || type == TokenType::LBRACE)
+                depth++;
+            else if (type == TokenType::RPAREN || type == TokenType::RBRACE)
+                depth--;
+            if (depth <= 0 && (type == TokenType::SEMICOLON || type == TokenType::RBRACE) &&
+                (i >= tokens.size() || tokens[i].type != TokenType::ELSE))
+                break;
+        }
+
+        // Positions are not part of the key: moving a statement keeps its TAC
+        text.clear();
+        for (size_t k = begin; k < i; k++)
+        {
+            text += static_cast<char>('A' + static_cast<int>(tokens[k].type));
+            text += tokens[k].value;
+            text += '\0';
+        }
+        Statement statement = {contentHash(text), true, ast.size(), 0, 0};
+        auto cached = previous.find(statement.key);
+        if (cached != previous.end())
+        {
+            if (!cached->second.used)
+                usedCount++;
+            cached->second.used = true;
+            reusedCount++;
+        }
+        else if (current.count(statement.key))
+        {
+            reusedCount++;
+        }
+        else
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<Token> range(tokens.begin() + begin, tokens.begin() + i);
+            range.push_back({TokenType::END_OF_FILE, "", tokens[i - 1].line, tokens[i - 1].column});
+            Parser parser(range, context);
+            for (auto& node : parser.parse())
+                ast.push_back(std::move(node));
+            errors.insert(errors.end(), parser.getErrors().begin(), parser.getErrors().end());
+            auto end = std::chrono::high_resolution_clock::now();
+            statement.reused = false;
+            statement.nodeCount = ast.size() - statement.firstNode;
+            statement.parseMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+            freshMilliseconds += statement.parseMilliseconds;
+            // Lowered by generate(); a repeat later in this build reuses it
+            current[statement.key];
+        }
+        statements.push_back(statement);
+    }
+
+    // What splitting and hashing cost is taken off the savings
+    auto parseEnd = std::chrono::high_resolution_clock::now();
+    savedMilliseconds -= std::chrono::duration<double, std::milli>(parseEnd - parseStart).count() - freshMilliseconds;
+}
+
+// Fresh fragments are serialized too and spliced the same way as cached ones
+std::vector<TACInstruction> FrontEndCache::generate(const std::vector<std::unique_ptr<ASTNode>>& ast)
+{
+    auto generateStart = std::chrono::high_resolution_clock::now();
+    double freshMilliseconds = 0;
+    std::vector<TACInstruction> tac;
+    size_t total = 0;
+    for (const auto& entry : previous)
+        total += entry.second.used ? entry.second.instructionCount : 0;
+    tac.reserve(total);
+    const TACInstruction blank(TACOpcode::ASSIGN);
+    int tempBase = 0;
+    int labelBase = 0;
+    for (const auto& statement : statements)
+    {
+        auto built = current.find(statement.key);
+        const Fragment* fragment;
+        if (!statement.reused)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            TACGenerator generator(context);
+            std::vector<TACInstruction> code = generator.generate(ast, statement.firstNode, statement.nodeCount);
+            Fragment& lowered = built->second;
+            serialize(code, lowered.text);
+            lowered.instructionCount = code.size();
+            lowered.tempCount = generator.getTempCount();
+            lowered.labelCount = generator.getLabelCount();
+            auto end = std::chrono::high_resolution_clock::now();
+            double lowering = std::chrono::duration<double, std::milli>(end - start).count();
+            lowered.milliseconds = statement.parseMilliseconds + lowering;
+            freshMilliseconds += lowering;
+            fragment = &lowered;
+        }
+        else
+        {
+            // Lowered earlier in this build, else from the previous one
+            fragment = built != current.end() ? &built->second : &previous.at(statement.key);
+            savedMilliseconds += fragment->milliseconds;
+        }
+
+        const char* p = fragment->text.c_str();
+        for (size_t n = 0; n < fragment->instructionCount; n++)
+        {
+            char* next;
+            TACOpcode opcode = static_cast<TACOpcode>(std::strtol(p, &next, 10));
+            tac.push_back(blank);
+            TACInstruction& instr = tac.back();
+            instr.opcode = opcode;
+            for (std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+            {
+                const char* start = next + 1;
+                const char* stop = start;
+                while (*stop != ' ' && *stop != '\n')
+                    stop++;
+                if (operand == &instr.result && hasLabelResult(opcode))
+                    decodeOperand(*operand, start, stop, 'L', fragment->labelCount, labelBase);
+                else
+                    decodeOperand(*operand, start, stop, 't', fragment->tempCount, tempBase);
+                next = const_cast<char*>(stop);
+            }
+            p = next + 1;
+        }
+        tempBase += fragment->tempCount;
+        labelBase += fragment->labelCount;
+    }
+
+    // Splicing is overhead as well, for fresh fragments too
+    auto generateEnd = std::chrono::high_resolution_clock::now();
+    savedMilliseconds -= std::chrono::duration<double, std::milli>(generateEnd - generateStart).count() -
+                         freshMilliseconds;
+    return tac;
+}
+
+// Replaced as a whole, so a concurrent build reads either the old or the new
+// fragments. Only this build's statements are kept.
+bool FrontEndCache::save(std::string& error) const
+{
+    if (filename.empty())
+    {
+        error = "no cache directory";
+        return false;
+    }
+    // Nothing new, and every fragment in the file is still used
+    if (current.empty() && usedCount == previous.size())
+        return true;
+
+    std::string data = fileHeader();
+    std::unordered_set<std::string> written;
+    for (const auto& statement : statements)
+    {
+        if (!written.insert(statement.key).second)
+            continue;
+        auto built = current.find(statement.key);
+        const Fragment& fragment = built != current.end() ? built->second : previous.at(statement.key);
+        data += statement.key + " " + std::to_string(fragment.tempCount) + " " +
+                std::to_string(fragment.labelCount) + " " + std::to_string(fragment.milliseconds) + " " +
+                std::to_string(fragment.instructionCount) + "\n";
+        data += fragment.text;
+    }
+
+    if (!replaceFile(filename, data, false))
+    {
+        error = "could not write " + filename;
+        return false;
+    }
+    return true;
+}
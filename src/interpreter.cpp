@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+#include "../include/interpreter.h"
+#include "../include/cfg.h"
+
+PrintBuffer::PrintBuffer(FILE* out) : out(out), length(0) {}
+
+void PrintBuffer::flush()
+{
+    if (length > 0)
+        std::fwrite(buffer, 1, length, out);
+    length = 0;
+    std::fflush(out);
+}
+
+SlotLayout::SlotLayout(const std::vector<TACInstruction>& tac) : nameCount(0)
+{
+    // Names take the first slots, one unused slot follows for missing operands
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (const auto& instr : tac)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+            {
+                if (operand->empty() || (operand == &instr.result && !writesResult(instr.opcode)))
+                    continue;
+                if (isNumericLiteral(*operand) != (pass == 1) || slots.count(*operand))
+                    continue;
+                slots[*operand] = static_cast<uint32_t>(initialValues.size());
+                initialValues.push_back(pass == 1 ? std::strtod(operand->c_str(), nullptr) : 0.0);
+            }
+        }
+        if (pass == 0)
+        {
+            nameCount = initialValues.size();
+            initialValues.push_back(0.0);
+        }
+    }
+}
+
+uint32_t SlotLayout::slotOf(const std::string& operand) const
+{
+    auto it = slots.find(operand);
+    return it != slots.end() ? it->second : static_cast<uint32_t>(nameCount);
+}
+
+TACInterpreter::TACInterpreter(const std::vector<TACInstruction>& tac, uint64_t hotThreshold)
+    : layout(tac), programSize(0), hotThreshold(hotThreshold)
+{
+    uint32_t unused = static_cast<uint32_t>(layout.getNameCount());
+
+    // Labels resolve to the index of the next real instruction
+    std::unordered_map<std::string, uint32_t> labels;
+    uint32_t index = 0;
+    for (const auto& instr : tac)
+    {
+        threadedIndex.push_back(index);
+        if (instr.opcode == TACOpcode::LABEL)
+            labels[instr.result] = index;
+        else
+            index++;
+    }
+    uint32_t halt = index;
+    threadedIndex.push_back(halt);
+
+    for (const auto& instr : tac)
+    {
+        ThreadedInstruction threaded{nullptr, Operation::HALT, unused, unused, unused, halt};
+        switch (instr.opcode)
+        {
+            case TACOpcode::ADD: threaded.operation = Operation::ADD; break;
+            case TACOpcode::SUB: threaded.operation = Operation::SUB; break;
+            case TACOpcode::MUL: threaded.operation = Operation::MUL; break;
+            case TACOpcode::DIV: threaded.operation = Operation::DIV; break;
+            case TACOpcode::ASSIGN: threaded.operation = Operation::ASSIGN; break;
+            case TACOpcode::LT: threaded.operation = Operation::LT; break;
+            case TACOpcode::GT: threaded.operation = Operation::GT; break;
+            case TACOpcode::LE: threaded.operation = Operation::LE; break;
+            case TACOpcode::GE: threaded.operation = Operation::GE; break;
+            case TACOpcode::EQ: threaded.operation = Operation::EQ; break;
+            case TACOpcode::NE: threaded.operation = Operation::NE; break;
+            case TACOpcode::AND: threaded.operation = Operation::AND; break;
+            case TACOpcode::OR: threaded.operation = Operation::OR; break;
+            case TACOpcode::NOT: threaded.operation = Operation::NOT; break;
+            case TACOpcode::GOTO: threaded.operation = Operation::GOTO; break;
+            case TACOpcode::IF_FALSE: threaded.operation = Operation::IF_FALSE; break;
+            case TACOpcode::IF_TRUE: threaded.operation = Operation::IF_TRUE; break;
+            case TACOpcode::PRINT: threaded.operation = Operation::PRINT; break;
+            case TACOpcode::LABEL: continue;
+        }
+
+        if (instr.opcode == TACOpcode::GOTO || instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+        {
+            auto it = labels.find(instr.result);
+            if (it != labels.end())
+                threaded.target = it->second;
+        }
+        else if (writesResult(instr.opcode))
+        {
+            threaded.result = layout.slotOf(instr.result);
+        }
+        if (instr.opcode != TACOpcode::GOTO)
+        {
+            threaded.arg1 = layout.slotOf(instr.arg1);
+            threaded.arg2 = layout.slotOf(instr.arg2);
+        }
+        code.push_back(threaded);
+    }
+    code.push_back(ThreadedInstruction{nullptr, Operation::HALT, unused, unused, unused, halt});
+    programSize = code.size();
+
+    if (hotThreshold > 0)
+        addBackEdgeTrampolines(tac);
+
+    std::vector<double> values;
+    execute(values, nullptr, 0, true);
+}
+
+// Send the back edges of every natural loop through a trampoline after HALT
+// that counts them. A loop region spans its blocks in program order; other
+// blocks in between are harmless, since leaving the region is always an exit.
+void TACInterpreter::addBackEdgeTrampolines(const std::vector<TACInstruction>& tac)
+{
+    ControlFlowGraph cfg(tac);
+    const std::vector<BasicBlock>& blocks = cfg.getBlocks();
+    std::vector<size_t> blockStart;
+    size_t position = 0;
+    for (const auto& block : blocks)
+    {
+        blockStart.push_back(position);
+        position += block.instructions.size();
+    }
+
+    for (const auto& loop : cfg.findLoops())
+    {
+        std::string header = blocks[loop.header].label();
+        if (header.empty())
+            continue;
+
+        LoopRegion region{blockStart[loop.blocks.front()], blockStart[loop.header], 0, 0};
+        for (int block : loop.blocks)
+            region.end = std::max(region.end, blockStart[block] + blocks[block].instructions.size());
+
+        uint32_t trampoline = static_cast<uint32_t>(code.size());
+        uint32_t unused = static_cast<uint32_t>(layout.getNameCount());
+        code.push_back(ThreadedInstruction{nullptr, Operation::BACK_EDGE, static_cast<uint32_t>(loops.size()),
+                                           unused, unused, threadedIndex[region.header]});
+        loops.push_back(region);
+
+        for (int latch : loop.latches)
+        {
+            const TACInstruction* jump = blocks[latch].terminator();
+            if (jump && jump->result == header)
+                code[threadedIndex[blockStart[latch] + blocks[latch].instructions.size() - 1]].target = trampoline;
+        }
+    }
+}
+
+// Interpreter loop from an entry instruction; returns the HALT or BACK_EDGE
+// instruction it stopped at. With resolveHandlers set it only stores the
+// handler address of every instruction, since labels as values are local to
+// the function that defines them.
+uint32_t TACInterpreter::execute(std::vector<double>& values, PrintBuffer* output, uint32_t entry, bool resolveHandlers)
+{
+#if TACO_THREADED_DISPATCH
+    static const void* const handlers[] = {
+        &&op_ADD, &&op_SUB, &&op_MUL, &&op_DIV, &&op_ASSIGN,
+        &&op_LT, &&op_GT, &&op_LE, &&op_GE, &&op_EQ, &&op_NE,
+        &&op_AND, &&op_OR, &&op_NOT,
+        &&op_GOTO, &&op_IF_FALSE, &&op_IF_TRUE,
+        &&op_PRINT, &&op_HALT, &&op_BACK_EDGE
+    };
+    if (resolveHandlers)
+    {
+        for (auto& instr : code)
+            instr.handler = handlers[static_cast<int>(instr.operation)];
+        return 0;
+    }
+#define HANDLER(name) op_##name
+#define DISPATCH() goto *ip->handler
+#define NEXT() do { ++ip; DISPATCH(); } while (0)
+#define JUMP() do { ip = start + ip->target; DISPATCH(); } while (0)
+#else
+    if (resolveHandlers)
+        return 0;
+#define HANDLER(name) case Operation::name
+#define NEXT() do { ++ip; goto dispatch; } while (0)
+#define JUMP() do { ip = start + ip->target; goto dispatch; } while (0)
+#endif
+
+    double* v = values.data();
+    const ThreadedInstruction* start = code.data();
+    const ThreadedInstruction* ip = start + entry;
+
+#if TACO_THREADED_DISPATCH
+    DISPATCH();
+#else
+dispatch:
+    switch (ip->operation)
+    {
+#endif
+    HANDLER(ADD): v[ip->result] = v[ip->arg1] + v[ip->arg2]; NEXT();
+    HANDLER(SUB): v[ip->result] = v[ip->arg1] - v[ip->arg2]; NEXT();
+    HANDLER(MUL): v[ip->result] = v[ip->arg1] * v[ip->arg2]; NEXT();
+    HANDLER(DIV): v[ip->result] = v[ip->arg1] / v[ip->arg2]; NEXT();
+    HANDLER(ASSIGN): v[ip->result] = v[ip->arg1]; NEXT();
+    HANDLER(LT): v[ip->result] = v[ip->arg1] < v[ip->arg2]; NEXT();
+    HANDLER(GT): v[ip->result] = v[ip->arg1] > v[ip->arg2]; NEXT();
+    HANDLER(LE): v[ip->result] = v[ip->arg1] <= v[ip->arg2]; NEXT();
+    HANDLER(GE): v[ip->result] = v[ip->arg1] >= v[ip->arg2]; NEXT();
+    HANDLER(EQ): v[ip->result] = v[ip->arg1] == v[ip->arg2]; NEXT();
+    HANDLER(NE): v[ip->result] = v[ip->arg1] != v[ip->arg2]; NEXT();
+    HANDLER(AND): v[ip->result] = v[ip->arg1] && v[ip->arg2]; NEXT();
+    HANDLER(OR): v[ip->result] = v[ip->arg1] || v[ip->arg2]; NEXT();
+    HANDLER(NOT): v[ip->result] = !v[ip->arg1]; NEXT();
+    HANDLER(GOTO): JUMP();
+    HANDLER(IF_FALSE):
+        if (!v[ip->arg1])
+            JUMP();
+        NEXT();
+    HANDLER(IF_TRUE):
+        if (v[ip->arg1])
+            JUMP();
+        NEXT();
+    HANDLER(PRINT): output->print(v[ip->arg1]); NEXT();
+    HANDLER(HALT): return static_cast<uint32_t>(ip - start);
+    HANDLER(BACK_EDGE):
+        if (++loops[ip->result].backEdges < hotThreshold)
+            JUMP();
+        return static_cast<uint32_t>(ip - start);
+#if !TACO_THREADED_DISPATCH
+    }
+    return static_cast<uint32_t>(programSize - 1);
+#endif
+
+#undef HANDLER
+#undef DISPATCH
+#undef NEXT
+#undef JUMP
+}
+
+// Run the program from a fresh state
+void TACInterpreter::run(FILE* out)
+{
+    std::vector<double> values = layout.getInitialValues();
+    PrintBuffer output(out);
+    execute(values, &output, 0, false);
+}
+
+// Continue a program, stopping early at the back edge of a hot loop
+size_t TACInterpreter::resume(std::vector<double>& values, PrintBuffer& output, size_t index, int& hotLoop)
+{
+    const ThreadedInstruction& stop = code[execute(values, &output, threadedIndex[index], false)];
+    if (stop.operation == Operation::BACK_EDGE)
+    {
+        hotLoop = static_cast<int>(stop.result);
+        return loops[stop.result].header;
+    }
+    hotLoop = -1;
+    return threadedIndex.size() - 1;
+}
@@ -0,0 +1,377 @@
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+#include "../include/jit.h"
+#include "../include/interpreter.h"
+#include "../include/cfg.h"
+
+#if TACO_JIT_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// x86 condition codes, as the low nibble of Jcc (0F 8x) and SETcc (0F 9x)
+enum ConditionCode : uint8_t
+{
+    CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5,
+    CC_BE = 0x6, CC_A = 0x7, CC_P = 0xA, CC_NP = 0xB
+};
+
+// Flags test after ucomisd. Equality needs two flags, since an unordered
+// compare (NaN) sets ZF as well as PF.
+struct Condition
+{
+    enum Kind { SIMPLE, EQUAL, NOT_EQUAL } kind;
+    uint8_t code;       // Condition code of a SIMPLE test
+
+    Condition negated() const
+    {
+        if (kind == EQUAL)
+            return Condition{NOT_EQUAL, 0};
+        if (kind == NOT_EQUAL)
+            return Condition{EQUAL, 0};
+        return Condition{SIMPLE, static_cast<uint8_t>(code ^ 1)};
+    }
+};
+
+// Byte-level x86-64 encoder for the few instructions the JIT needs. Memory
+// operands are always [rbx + disp32] with the displacement of a value slot.
+class Assembler
+{
+private:
+    std::vector<uint8_t> bytes;
+
+public:
+    size_t position() const { return bytes.size(); }
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+
+    void emit(std::initializer_list<uint8_t> values) { bytes.insert(bytes.end(), values); }
+
+    void emit32(uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    // prefix 0F opcode xmm, [rbx + 8 * slot]
+    void sseMemory(uint8_t prefix, uint8_t opcode, int xmm, uint32_t slot)
+    {
+        emit({prefix, 0x0F, opcode, static_cast<uint8_t>(0x83 | (xmm << 3))});
+        emit32(slot * 8);
+    }
+
+    void load(int xmm, uint32_t slot) { sseMemory(0xF2, 0x10, xmm, slot); }          // movsd xmm, [slot]
+    void store(uint32_t slot, int xmm) { sseMemory(0xF2, 0x11, xmm, slot); }         // movsd [slot], xmm
+    void compare(int xmm, uint32_t slot) { sseMemory(0x66, 0x2E, xmm, slot); }       // ucomisd xmm, [slot]
+
+    // Jump with a 32-bit displacement; returns where the displacement goes
+    size_t jump(const Condition& condition)
+    {
+        emit({0x0F, static_cast<uint8_t>(0x80 | condition.code)});
+        emit32(0);
+        return position() - 4;
+    }
+    size_t jump()
+    {
+        emit({0xE9});
+        emit32(0);
+        return position() - 4;
+    }
+
+    void patch(size_t at, size_t target)
+    {
+        uint32_t displacement = static_cast<uint32_t>(target - (at + 4));
+        std::memcpy(&bytes[at], &displacement, sizeof(displacement));
+    }
+};
+
+// Called from machine code for PRINT
+static void printValue(PrintBuffer* output, double value)
+{
+    output->print(value);
+}
+
+JITCompiler::JITCompiler() : code(nullptr), codeSize(0), mappedSize(0), fusedBranches(0) {}
+
+JITCompiler::~JITCompiler()
+{
+    release();
+}
+
+void JITCompiler::release()
+{
+#if TACO_JIT_SUPPORTED
+    if (code)
+        munmap(code, mappedSize);
+#endif
+    code = nullptr;
+    codeSize = 0;
+    mappedSize = 0;
+}
+
+bool JITCompiler::compile(const std::vector<TACInstruction>& tac, std::string& error)
+{
+    SlotLayout layout(tac);
+    initialValues = layout.getInitialValues();
+    return compileRegion(tac, 0, 0, tac.size(), layout, error);
+}
+
+bool JITCompiler::generateCode(const std::vector<TACInstruction>& tac, size_t begin, size_t entry, size_t end,
+                               const SlotLayout& layout, std::vector<uint8_t>& code, size_t& fusedBranches,
+                               std::string& error)
+{
+    fusedBranches = 0;
+    if (layout.getSlotCount() >= (1u << 28))
+    {
+        error = "too many names and literals for machine code";
+        return false;
+    }
+    auto slotOf = [&](const std::string& operand) { return layout.slotOf(operand); };
+
+    // Labels outside the region are exits to their TAC index
+    std::unordered_map<std::string, size_t> labelIndices;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::LABEL)
+            labelIndices[tac[i].result] = i;
+    }
+
+    ControlFlowGraph cfg(tac);
+    TemporaryLiveness liveness(cfg);
+    Assembler as;
+
+    // Flags for "a relation b"; a, b and the relation may be swapped so
+    // that an unordered compare always fails the returned test
+    auto emitComparison = [&](TACOpcode opcode, uint32_t a, uint32_t b) -> Condition {
+        switch (opcode)
+        {
+            case TACOpcode::LT: as.load(0, b); as.compare(0, a); return Condition{Condition::SIMPLE, CC_A};
+            case TACOpcode::LE: as.load(0, b); as.compare(0, a); return Condition{Condition::SIMPLE, CC_AE};
+            case TACOpcode::GT: as.load(0, a); as.compare(0, b); return Condition{Condition::SIMPLE, CC_A};
+            case TACOpcode::GE: as.load(0, a); as.compare(0, b); return Condition{Condition::SIMPLE, CC_AE};
+            case TACOpcode::EQ: as.load(0, a); as.compare(0, b); return Condition{Condition::EQUAL, 0};
+            default: as.load(0, a); as.compare(0, b); return Condition{Condition::NOT_EQUAL, 0};
+        }
+    };
+
+    // Flags for "value is true" (non-zero or NaN)
+    auto emitTruth = [&](uint32_t slot) -> Condition {
+        as.load(0, slot);
+        as.emit({0x66, 0x0F, 0x57, 0xC9});        // xorpd xmm1, xmm1
+        as.emit({0x66, 0x0F, 0x2E, 0xC1});        // ucomisd xmm0, xmm1
+        return Condition{Condition::NOT_EQUAL, 0};
+    };
+
+    // al = condition ? 1 : 0
+    auto emitSet = [&](const Condition& condition) {
+        if (condition.kind == Condition::SIMPLE)
+        {
+            as.emit({0x0F, static_cast<uint8_t>(0x90 | condition.code), 0xC0});
+            return;
+        }
+        bool equal = condition.kind == Condition::EQUAL;
+        as.emit({0x0F, static_cast<uint8_t>(0x90 | (equal ? CC_E : CC_NE)), 0xC0});     // setcc al
+        as.emit({0x0F, static_cast<uint8_t>(0x90 | (equal ? CC_NP : CC_P)), 0xC1});     // setcc cl
+        as.emit({static_cast<uint8_t>(equal ? 0x20 : 0x08), 0xC8});                      // and/or al, cl
+    };
+
+    // slot = (double)al
+    auto emitStoreFlag = [&](uint32_t slot) {
+        as.emit({0x0F, 0xB6, 0xC0});              // movzx eax, al
+        as.emit({0xF2, 0x0F, 0x2A, 0xC0});        // cvtsi2sd xmm0, eax
+        as.store(slot, 0);
+    };
+
+    // Jumps are patched once every label has an address
+    std::unordered_map<std::string, size_t> labelAddresses;
+    std::vector<std::pair<size_t, std::string>> fixups;
+    auto emitJumpIf = [&](const Condition& condition, const std::string& label) {
+        if (condition.kind == Condition::SIMPLE)
+        {
+            fixups.push_back({as.jump(condition), label});
+        }
+        else if (condition.kind == Condition::EQUAL)
+        {
+            as.emit({0x7A, 0x06});                // jp +6 (unordered is not equal)
+            fixups.push_back({as.jump(Condition{Condition::SIMPLE, CC_E}), label});
+        }
+        else
+        {
+            fixups.push_back({as.jump(Condition{Condition::SIMPLE, CC_P}), label});
+            fixups.push_back({as.jump(Condition{Condition::SIMPLE, CC_NE}), label});
+        }
+    };
+
+    // Prologue: rbx = values, r12 = print buffer, r13 = print function;
+    // three pushes keep the stack 16-byte aligned for calls
+    as.emit({0x53, 0x41, 0x54, 0x41, 0x55});     // push rbx; push r12; push r13
+    as.emit({0x48, 0x89, 0xFB});                  // mov rbx, rdi
+    as.emit({0x49, 0x89, 0xF4});                  // mov r12, rsi
+    as.emit({0x49, 0x89, 0xD5});                  // mov r13, rdx
+    if (entry != begin)
+        fixups.push_back({as.jump(), tac[entry].result});
+
+    for (size_t i = begin; i < end; i++)
+    {
+        const TACInstruction& instr = tac[i];
+        switch (instr.opcode)
+        {
+            case TACOpcode::ADD:
+            case TACOpcode::SUB:
+            case TACOpcode::MUL:
+            case TACOpcode::DIV:
+            {
+                uint8_t opcode = instr.opcode == TACOpcode::ADD ? 0x58 : instr.opcode == TACOpcode::SUB ? 0x5C :
+                                 instr.opcode == TACOpcode::MUL ? 0x59 : 0x5E;
+                as.load(0, slotOf(instr.arg1));
+                as.sseMemory(0xF2, opcode, 0, slotOf(instr.arg2));
+                as.store(slotOf(instr.result), 0);
+                break;
+            }
+
+            case TACOpcode::ASSIGN:
+                as.load(0, slotOf(instr.arg1));
+                as.store(slotOf(instr.result), 0);
+                break;
+
+            case TACOpcode::LT:
+            case TACOpcode::GT:
+            case TACOpcode::LE:
+            case TACOpcode::GE:
+            case TACOpcode::EQ:
+            case TACOpcode::NE:
+            {
+                Condition condition = emitComparison(instr.opcode, slotOf(instr.arg1), slotOf(instr.arg2));
+
+                // Compare and branch on the flags if only the branch reads the result
+                if (isTemporary(instr.result) && i + 1 < end &&
+                    (tac[i + 1].opcode == TACOpcode::IF_TRUE || tac[i + 1].opcode == TACOpcode::IF_FALSE) &&
+                    tac[i + 1].arg1 == instr.result && liveness.isDeadAfter(i + 1, instr.result))
+                {
+                    emitJumpIf(tac[i + 1].opcode == TACOpcode::IF_TRUE ? condition : condition.negated(),
+                               tac[i + 1].result);
+                    fusedBranches++;
+                    i++;
+                    break;
+                }
+                emitSet(condition);
+                emitStoreFlag(slotOf(instr.result));
+                break;
+            }
+
+            case TACOpcode::AND:
+            case TACOpcode::OR:
+                emitSet(emitTruth(slotOf(instr.arg1)));
+                as.emit({0x88, 0xC2});                // mov dl, al
+                emitSet(emitTruth(slotOf(instr.arg2)));
+                as.emit({static_cast<uint8_t>(instr.opcode == TACOpcode::AND ? 0x20 : 0x08), 0xD0});   // and/or al, dl
+                emitStoreFlag(slotOf(instr.result));
+                break;
+
+            case TACOpcode::NOT:
+                emitSet(emitTruth(slotOf(instr.arg1)).negated());
+                emitStoreFlag(slotOf(instr.result));
+                break;
+
+            case TACOpcode::LABEL:
+                labelAddresses[instr.result] = as.position();
+                break;
+
+            case TACOpcode::GOTO:
+                fixups.push_back({as.jump(), instr.result});
+                break;
+
+            case TACOpcode::IF_FALSE:
+                emitJumpIf(emitTruth(slotOf(instr.arg1)).negated(), instr.result);
+                break;
+
+            case TACOpcode::IF_TRUE:
+                emitJumpIf(emitTruth(slotOf(instr.arg1)), instr.result);
+                break;
+
+            case TACOpcode::PRINT:
+                as.load(0, slotOf(instr.arg1));
+                as.emit({0x4C, 0x89, 0xE7});          // mov rdi, r12
+                as.emit({0x41, 0xFF, 0xD5});          // call r13
+                break;
+        }
+    }
+
+    // Falling off the end continues after the region
+    as.emit({0xB8});                              // mov eax, end
+    as.emit32(static_cast<uint32_t>(end));
+    size_t epilogue = as.position();
+    as.emit({0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3});   // pop r13; pop r12; pop rbx; ret
+
+    // Exits: one stub per label outside the region; unknown labels end the program
+    for (const auto& fixup : fixups)
+    {
+        if (labelAddresses.count(fixup.second))
+            continue;
+        auto it = labelIndices.find(fixup.second);
+        labelAddresses[fixup.second] = as.position();
+        as.emit({0xB8});                          // mov eax, index
+        as.emit32(static_cast<uint32_t>(it != labelIndices.end() ? it->second : tac.size()));
+        as.patch(as.jump(), epilogue);
+    }
+    for (const auto& fixup : fixups)
+        as.patch(fixup.first, labelAddresses[fixup.second]);
+    code = as.getBytes();
+    return true;
+}
+
+bool JITCompiler::compileRegion(const std::vector<TACInstruction>& tac, size_t begin, size_t entry, size_t end,
+                                const SlotLayout& layout, std::string& error)
+{
+#if !TACO_JIT_SUPPORTED
+    (void)tac;
+    (void)begin;
+    (void)entry;
+    (void)end;
+    (void)layout;
+    error = "JIT compilation is only supported on x86-64";
+    return false;
+#else
+    release();
+    std::vector<uint8_t> bytes;
+    if (!generateCode(tac, begin, entry, end, layout, bytes, fusedBranches, error))
+        return false;
+
+    // Write the code, then make it executable (never writable and executable at once)
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t size = (bytes.size() + page - 1) / page * page;
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        error = std::string("mmap failed: ") + std::strerror(errno);
+        return false;
+    }
+    std::memcpy(memory, bytes.data(), bytes.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        error = std::string("mprotect failed: ") + std::strerror(errno);
+        munmap(memory, size);
+        return false;
+    }
+
+    code = memory;
+    codeSize = bytes.size();
+    mappedSize = size;
+    return true;
+#endif
+}
+
+void JITCompiler::run(FILE* out) const
+{
+    std::vector<double> values = initialValues;
+    PrintBuffer output(out);
+    execute(values, output);
+}
+
+size_t JITCompiler::execute(std::vector<double>& values, PrintBuffer& output) const
+{
+    if (!code)
+        return 0;
+    EntryFunction entry = reinterpret_cast<EntryFunction>(code);
+    return entry(values.data(), &output, printValue);
+}
@@ -6,7 +6,20 @@
 #include <vector>
 #include "../include/lexer.h"
 
+// Characters that start no token are skipped and reported
+static void unexpected(std::vector<std::string>& errors, char symbol, int line, int column)
+{
+    errors.push_back(std::string("Unexpected character '") + symbol + "' at line " + std::to_string(line) + ":" +
+                     std::to_string(column));
+}
+
 std::vector<Token> lexing(const std::string &source_code)
+{
+    std::vector<std::string> errors;
+    return lexing(source_code, errors);
+}
+
+std::vector<Token> lexing(const std::string &source_code, std::vector<std::string>& errors)
 {
     std::vector<Token> tokens;
     int line = 1;
@@ -219,6 +232,7 @@ std::vector<Token> lexing(const std::string &source_code)
             }
             else
             {
+                unexpected(errors, symbol, line, column);
                 column++; // Skip single &
             }
         }
@@ -233,6 +247,7 @@ std::vector<Token> lexing(const std::string &source_code)
             }
             else
             {
+                unexpected(errors, symbol, line, column);
                 column++; // Skip single |
             }
         }
@@ -263,6 +278,7 @@ std::vector<Token> lexing(const std::string &source_code)
         }
         else
         {
+            unexpected(errors, symbol, line, column);
             column++;
         }
     }
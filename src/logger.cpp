@@ -4,9 +4,6 @@
 #include <unistd.h>
 #include <cmath>
 
-// Global logger instance
-Logger logger;
-
 Logger::Logger() : isOpen(false), filename(), timings(), resourceTimings(), profilingEnabled(false) {}
 
 Logger::~Logger()
@@ -48,16 +45,45 @@ void Logger::close()
 
 void Logger::startTimer()
 {
-    stageStartTime = std::chrono::high_resolution_clock::now();
+    stageStartTimes.push_back({std::chrono::high_resolution_clock::now(), timings.size()});
 }
 
 void Logger::endTimer(const std::string& stageName)
 {
     auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - stageStartTime);
-    double durationMs = duration.count() / 1000.0;
-    
-    timings.push_back({stageName, durationMs});
+    if (stageStartTimes.empty())
+        return;
+
+    std::chrono::duration<double, std::milli> duration = endTime - stageStartTimes.back().first;
+    size_t firstNested = stageStartTimes.back().second;
+    stageStartTimes.pop_back();
+    int depth = static_cast<int>(stageStartTimes.size());
+
+    // Merge repeated runs of a nested stage into one entry
+    if (depth > 0 && firstNested == timings.size())
+    {
+        for (size_t i = stageStartTimes.back().second; i < timings.size(); i++)
+        {
+            if (timings[i].depth == depth && timings[i].stageName == stageName)
+            {
+                timings[i].durationMs += duration.count();
+                timings[i].count++;
+                return;
+            }
+        }
+    }
+
+    // Stages nested in this one were recorded first: the stage goes in front of them
+    timings.insert(timings.begin() + firstNested, TimingInfo{stageName, duration.count(), depth, 1});
+}
+
+// Stage name with its nesting and run count
+static std::string timingLabel(const TimingInfo& timing)
+{
+    std::string label = std::string(2 * timing.depth, ' ') + timing.stageName;
+    if (timing.count > 1)
+        label += " (x" + std::to_string(timing.count) + ")";
+    return label;
 }
 
 void Logger::printTimingReport()
@@ -76,17 +102,20 @@ void Logger::printTimingReportToConsole()
     double totalTime = 0.0;
     for (const auto& timing : timings)
     {
-        std::cout << std::left << std::setw(30) << timing.stageName << ": " 
+        std::cout << std::left << std::setw(30) << timingLabel(timing) << ": " 
                   << std::fixed << std::setprecision(3) << std::right << std::setw(10) 
                   << timing.durationMs << " ms" << std::endl;
         
-        totalTime += timing.durationMs;
+        if (timing.depth == 0)
+            totalTime += timing.durationMs;
     }
     
     std::cout << std::string(44, '-') << std::endl;
     std::cout << std::left << std::setw(30) << "Total" << ": " 
               << std::fixed << std::setprecision(3) << std::right << std::setw(10) 
               << totalTime << " ms" << std::endl;
+    for (const auto& note : timingNotes)
+        std::cout << note << std::endl;
     std::cout << std::string(44, '=') << std::endl;
 }
 
@@ -100,17 +129,20 @@ void Logger::printTimingReportToLog()
     double totalTime = 0.0;
     for (const auto& timing : timings)
     {
-        logFile << std::left << std::setw(30) << timing.stageName << ": " 
+        logFile << std::left << std::setw(30) << timingLabel(timing) << ": " 
                 << std::fixed << std::setprecision(3) << std::right << std::setw(10) 
                 << timing.durationMs << " ms" << std::endl;
         
-        totalTime += timing.durationMs;
+        if (timing.depth == 0)
+            totalTime += timing.durationMs;
     }
     
     logFile << std::string(44, '-') << std::endl;
     logFile << std::left << std::setw(30) << "Total" << ": " 
             << std::fixed << std::setprecision(3) << std::right << std::setw(10) 
             << totalTime << " ms" << std::endl;
+    for (const auto& note : timingNotes)
+        logFile << note << std::endl;
     logFile << std::string(44, '=') << std::endl;
     logFile.flush();
 }
@@ -120,7 +152,8 @@ double Logger::getTotalTime() const
     double total = 0.0;
     for (const auto& timing : timings)
     {
-        total += timing.durationMs;
+        if (timing.depth == 0)
+            total += timing.durationMs;
     }
     return total;
 }
@@ -129,6 +162,12 @@ void Logger::clearTimings()
 {
     timings.clear();
     resourceTimings.clear();
+    timingNotes.clear();
+}
+
+void Logger::addTimingNote(const std::string& note)
+{
+    timingNotes.push_back(note);
 }
 
 void Logger::enableProfiling(bool enable)
@@ -346,3 +385,15 @@ void Logger::printProfilingReportToLog()
     logFile << std::string(82, '=') << std::endl;
     logFile.flush();
 }
+
+StageTimer::StageTimer(Logger& logger, const std::string& stageName) : logger(logger), stageName(stageName)
+{
+    logger.startTimer();
+    logger.startProfiling();
+}
+
+StageTimer::~StageTimer()
+{
+    logger.endProfiling(stageName);
+    logger.endTimer(stageName);
+}
@@ -0,0 +1,485 @@
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include <unordered_map>
+#include "../include/optimizer.h"
+#include "../include/cfg.h"
+#include "../include/context.h"
+
+// A while/for loop in the shape produced by TACGenerator:
+//
+//   header:  <condition>  if !c goto exit  <body>  goto header  exit:
+struct RotationCandidate
+{
+    size_t header;      // Index of the header LABEL
+    size_t test;        // Index of the IF_FALSE leaving the loop
+    size_t backEdge;    // Index of the GOTO back to the header
+    std::string bodyLabel;
+};
+
+// Rotate loops into guarded do-while form:
+//
+//   header:  <condition>  if !c goto exit
+//   body:    <body>  <condition>  if c goto body
+//   exit:
+//
+// The header test now runs only once on entry and every iteration ends in a
+// single conditional backward branch. The header label is kept so any other
+// jump to it still evaluates the guard.
+int rotateLoops(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context)
+{
+    // Locate every GOTO by target so back edges can be found quickly
+    std::unordered_map<std::string, std::vector<size_t>> gotosByTarget;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::GOTO)
+            gotosByTarget[tac[i].result].push_back(i);
+    }
+
+    TACNameAllocator names(tac);
+    std::unordered_map<size_t, RotationCandidate> byTest;
+    std::unordered_map<size_t, RotationCandidate> byBackEdge;
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode != TACOpcode::LABEL)
+            continue;
+
+        // The condition must be straight-line code ending in the exit test
+        size_t j = i + 1;
+        while (j < tac.size() && !isControlFlow(tac[j].opcode))
+            j++;
+        if (j >= tac.size() || tac[j].opcode != TACOpcode::IF_FALSE)
+            continue;
+        if (j - i - 1 > options.maxRotatedCondition)
+            continue;
+
+        // The back edge must be immediately followed by the exit label
+        auto it = gotosByTarget.find(tac[i].result);
+        if (it == gotosByTarget.end())
+            continue;
+
+        const std::string& exitLabel = tac[j].result;
+        for (size_t k : it->second)
+        {
+            if (k > j && k + 1 < tac.size() &&
+                tac[k + 1].opcode == TACOpcode::LABEL && tac[k + 1].result == exitLabel)
+            {
+                RotationCandidate candidate = {i, j, k, names.newLabel()};
+                byTest[j] = candidate;
+                byBackEdge[k] = candidate;
+
+                if (options.logReport)
+                {
+                    context.logger << "Loop rotation: " << tac[i].result << " -> do-while at "
+                                   << candidate.bodyLabel << " (condition: " << (j - i - 1)
+                                   << " instructions)" << std::endl;
+                }
+                break;
+            }
+        }
+    }
+
+    if (byTest.empty())
+        return 0;
+
+    std::vector<TACInstruction> rotated;
+    rotated.reserve(tac.size() + byTest.size() * 4);
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        auto backEdge = byBackEdge.find(i);
+        if (backEdge != byBackEdge.end())
+        {
+            // Re-evaluate the condition at the bottom and branch back while true
+            const RotationCandidate& loop = backEdge->second;
+            for (size_t c = loop.header + 1; c < loop.test; c++)
+                rotated.push_back(tac[c]);
+            rotated.push_back(TACInstruction(TACOpcode::IF_TRUE, loop.bodyLabel, tac[loop.test].arg1));
+            continue;
+        }
+
+        rotated.push_back(tac[i]);
+
+        auto test = byTest.find(i);
+        if (test != byTest.end())
+            rotated.push_back(TACInstruction(TACOpcode::LABEL, test->second.bodyLabel));
+    }
+
+    tac.swap(rotated);
+    return static_cast<int>(byTest.size());
+}
+
+// Induction variable of a single-block loop: var = var + step (or var - step)
+struct InductionInfo
+{
+    std::string var;
+    TACOpcode stepOp;       // ADD or SUB
+    double step;
+    size_t updateIndex;     // Instruction that writes the new value of var
+    size_t compareIndex;    // Instruction computing the loop condition
+    TACOpcode compareOp;
+    bool varOnLeft;         // var OP bound (true) or bound OP var (false)
+    std::string bound;
+};
+
+// Value of a numeric literal
+static bool literalValue(const std::string& operand, double& value)
+{
+    if (!isNumericLiteral(operand))
+        return false;
+    value = std::strtod(operand.c_str(), nullptr);
+    return true;
+}
+
+// Count definitions of a name inside an instruction range
+static int countDefinitions(const std::vector<TACInstruction>& instrs, const std::string& name, size_t& lastIndex)
+{
+    int count = 0;
+    for (size_t i = 0; i < instrs.size(); i++)
+    {
+        if (writesResult(instrs[i].opcode) && instrs[i].result == name)
+        {
+            count++;
+            lastIndex = i;
+        }
+    }
+    return count;
+}
+
+// Constant value of a variable at the end of a block, following single-predecessor
+// chains backwards. Variables start at 0 on entry to the program.
+static bool constantAtEnd(const ControlFlowGraph& cfg, int block, const std::string& var, double& value)
+{
+    const auto& blocks = cfg.getBlocks();
+    const int maxSteps = 1000;
+    int steps = 0;
+    int start = block;
+
+    while (true)
+    {
+        const auto& instrs = blocks[block].instructions;
+        for (size_t i = instrs.size(); i-- > 0;)
+        {
+            if (++steps > maxSteps)
+                return false;
+            if (writesResult(instrs[i].opcode) && instrs[i].result == var)
+            {
+                return instrs[i].opcode == TACOpcode::ASSIGN && literalValue(instrs[i].arg1, value);
+            }
+        }
+
+        const auto& preds = blocks[block].predecessors;
+        if (preds.empty())
+        {
+            if (block != 0)
+                return false;
+            value = 0.0;
+            return true;
+        }
+        if (preds.size() != 1 || preds[0] == start)
+            return false;
+        block = preds[0];
+    }
+}
+
+// Recognize "var = var +/- step" followed or preceded by "c = var OP bound"
+static bool findInduction(const std::vector<TACInstruction>& instrs, InductionInfo& info)
+{
+    const TACInstruction& branch = instrs.back();
+    const std::string& cond = branch.arg1;
+
+    size_t compareIndex = 0;
+    if (countDefinitions(instrs, cond, compareIndex) != 1)
+        return false;
+
+    const TACInstruction& compare = instrs[compareIndex];
+    switch (compare.opcode)
+    {
+        case TACOpcode::LT: case TACOpcode::GT: case TACOpcode::LE:
+        case TACOpcode::GE: case TACOpcode::EQ: case TACOpcode::NE:
+            break;
+        default:
+            return false;
+    }
+
+    // The induction variable is the compared operand written in the loop
+    size_t ignored = 0;
+    bool leftVaries = !isNumericLiteral(compare.arg1) && countDefinitions(instrs, compare.arg1, ignored) > 0;
+    bool rightVaries = !isNumericLiteral(compare.arg2) && countDefinitions(instrs, compare.arg2, ignored) > 0;
+    if (leftVaries == rightVaries)
+        return false;
+
+    info.varOnLeft = leftVaries;
+    info.var = leftVaries ? compare.arg1 : compare.arg2;
+    info.bound = leftVaries ? compare.arg2 : compare.arg1;
+    info.compareIndex = compareIndex;
+    info.compareOp = compare.opcode;
+
+    size_t updateIndex = 0;
+    if (countDefinitions(instrs, info.var, updateIndex) != 1)
+        return false;
+    info.updateIndex = updateIndex;
+
+    // Either "var = var + step" or "t = var + step; var = t"
+    const TACInstruction* update = &instrs[updateIndex];
+    if (update->opcode == TACOpcode::ASSIGN && !isNumericLiteral(update->arg1))
+    {
+        size_t tempIndex = 0;
+        if (countDefinitions(instrs, update->arg1, tempIndex) != 1 || tempIndex > updateIndex)
+            return false;
+        update = &instrs[tempIndex];
+    }
+
+    if (update->opcode == TACOpcode::ADD)
+    {
+        if (update->arg1 == info.var && literalValue(update->arg2, info.step))
+            info.stepOp = TACOpcode::ADD;
+        else if (update->arg2 == info.var && literalValue(update->arg1, info.step))
+            info.stepOp = TACOpcode::ADD;
+        else
+            return false;
+    }
+    else if (update->opcode == TACOpcode::SUB)
+    {
+        if (update->arg1 != info.var || !literalValue(update->arg2, info.step))
+            return false;
+        info.stepOp = TACOpcode::SUB;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// Number of times the body of a do-while loop runs, by replaying the induction
+// variable with the same double arithmetic as the generated code. Every step
+// is paid from budget; -1 when the loop runs longer than maxTrip or the budget.
+static long simulateTripCount(const InductionInfo& info, double entry, double bound,
+                              bool continueOnTrue, long maxTrip, long& budget)
+{
+    double value = entry;
+    for (long trip = 1; trip <= maxTrip; trip++)
+    {
+        if (budget <= 0)
+            return -1;
+        budget--;
+
+        double updated = (info.stepOp == TACOpcode::ADD) ? value + info.step : value - info.step;
+        double tested = (info.compareIndex > info.updateIndex) ? updated : value;
+        double lhs = info.varOnLeft ? tested : bound;
+        double rhs = info.varOnLeft ? bound : tested;
+
+        bool cond = false;
+        switch (info.compareOp)
+        {
+            case TACOpcode::LT: cond = lhs < rhs; break;
+            case TACOpcode::GT: cond = lhs > rhs; break;
+            case TACOpcode::LE: cond = lhs <= rhs; break;
+            case TACOpcode::GE: cond = lhs >= rhs; break;
+            case TACOpcode::EQ: cond = lhs == rhs; break;
+            case TACOpcode::NE: cond = lhs != rhs; break;
+            default: return -1;
+        }
+
+        if (cond != continueOnTrue)
+            return trip;
+        value = updated;
+    }
+    return -1;
+}
+
+// Unroll single-block loops (the shape left by loop rotation):
+//
+//   body:  <instructions>  c = ...  if c goto body
+//
+// Loops with a known trip count are unrolled completely when small, otherwise
+// by the configured factor with the remainder iterations peeled in front.
+// Loops with an unknown trip count are unrolled by the factor, keeping an
+// exit test after every copy. Growth is bounded per loop and per program.
+int unrollLoops(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                CompilationContext& context)
+{
+    ControlFlowGraph cfg(tac);
+    auto& blocks = cfg.getBlocks();
+    TACNameAllocator names(tac);
+
+    const long maxSimulatedTrip = 1L << 24;
+    long replayBudget = options.tripReplayBudget;    // Shared by all loops of the pass
+    size_t budget = std::max(options.minUnrollBudget,
+                             static_cast<size_t>(tac.size() * options.maxUnrollGrowth));
+    size_t growth = 0;
+    int unrolled = 0;
+    int factor = options.unrollFactor;
+
+    std::vector<std::vector<TACInstruction>> replacements(blocks.size());
+    std::vector<char> replaced(blocks.size(), 0);
+
+    for (const Loop& loop : cfg.findLoops())
+    {
+        if (loop.blocks.size() != 1)
+            continue;
+
+        const BasicBlock& block = blocks[loop.header];
+        const auto& instrs = block.instructions;
+        const TACInstruction* branch = block.terminator();
+        if (!branch || branch->opcode == TACOpcode::GOTO || branch->result != block.label())
+            continue;
+
+        const std::string label = block.label();
+        bool continueOnTrue = branch->opcode == TACOpcode::IF_TRUE;
+        size_t bodySize = instrs.size() - 2;
+        if (bodySize == 0)
+            continue;
+
+        // Trip count from the induction variable and the values reaching the loop
+        InductionInfo info;
+        long trip = -1;
+        bool hasInduction = findInduction(instrs, info);
+        if (hasInduction && block.predecessors.size() == 2)
+        {
+            int entryPred = (block.predecessors[0] == block.id) ? block.predecessors[1] : block.predecessors[0];
+            double entry = 0.0;
+            double bound = 0.0;
+            bool boundKnown = literalValue(info.bound, bound) || constantAtEnd(cfg, entryPred, info.bound, bound);
+            if (boundKnown && constantAtEnd(cfg, entryPred, info.var, entry))
+            {
+                bool hadBudget = replayBudget > 0;
+                trip = simulateTripCount(info, entry, bound, continueOnTrue, maxSimulatedTrip, replayBudget);
+                if (hadBudget && replayBudget <= 0 && trip < 0 && options.logReport)
+                {
+                    context.logger << "Loop unrolling: trip count replay budget of " << options.tripReplayBudget
+                                   << " steps exhausted at " << label << std::endl;
+                }
+            }
+        }
+
+        // The condition temp of intermediate copies is dead if only the branch reads it
+        bool dropCompare = false;
+        size_t compareIndex = 0;
+        if (isTemporary(branch->arg1) && countDefinitions(instrs, branch->arg1, compareIndex) == 1)
+        {
+            dropCompare = true;
+            for (size_t i = 1; i + 1 < instrs.size(); i++)
+            {
+                if (instrs[i].arg1 == branch->arg1 || instrs[i].arg2 == branch->arg1)
+                    dropCompare = false;
+            }
+        }
+
+        auto appendBody = [&](std::vector<TACInstruction>& out, bool keepCompare) {
+            for (size_t i = 1; i + 1 < instrs.size(); i++)
+            {
+                if (dropCompare && !keepCompare && i == compareIndex)
+                    continue;
+                out.push_back(instrs[i]);
+            }
+        };
+
+        std::vector<TACInstruction> out;
+        out.push_back(instrs[0]);
+        std::string report;
+
+        if (trip > 0 && trip <= options.maxFullUnrollTrip &&
+            static_cast<size_t>(trip) * bodySize <= options.maxUnrolledLoopSize)
+        {
+            // Full unrolling: the loop disappears
+            for (long k = 0; k < trip; k++)
+                appendBody(out, k == trip - 1);
+            report = "fully unrolled (trip count " + std::to_string(trip) + ")";
+        }
+        else if (trip > 0 && factor > 1 && trip >= factor && bodySize <= options.maxUnrollBodySize &&
+                 static_cast<size_t>(factor + trip % factor) * bodySize <= options.maxUnrolledLoopSize)
+        {
+            // Partial unrolling with a known trip count: peel the remainder, then
+            // run groups of 'factor' copies with a single test per group
+            long remainder = trip % factor;
+            for (long k = 0; k < remainder; k++)
+                appendBody(out, false);
+
+            std::string head = label;
+            if (remainder > 0)
+            {
+                head = names.newLabel();
+                out.push_back(TACInstruction(TACOpcode::LABEL, head));
+            }
+            for (int k = 0; k < factor; k++)
+                appendBody(out, k == factor - 1);
+            out.push_back(TACInstruction(branch->opcode, head, branch->arg1));
+
+            report = "unrolled x" + std::to_string(factor) + " (trip count " + std::to_string(trip) +
+                     ", " + std::to_string(remainder) + " remainder iterations peeled)";
+        }
+        else if (trip < 0 && factor > 1 && bodySize <= options.maxUnrollBodySize &&
+                 static_cast<size_t>(factor) * (bodySize + 1) <= options.maxUnrolledLoopSize)
+        {
+            // Partial unrolling with an unknown trip count: every copy but the
+            // last keeps an exit test, so no remainder loop is needed
+            std::string exitLabel;
+            if (static_cast<size_t>(block.id + 1) < blocks.size())
+                exitLabel = blocks[block.id + 1].label();
+            bool newExit = exitLabel.empty();
+            if (newExit)
+                exitLabel = names.newLabel();
+
+            TACOpcode exitOp = continueOnTrue ? TACOpcode::IF_FALSE : TACOpcode::IF_TRUE;
+            for (int k = 0; k < factor - 1; k++)
+            {
+                appendBody(out, true);
+                out.push_back(TACInstruction(exitOp, exitLabel, branch->arg1));
+            }
+            appendBody(out, true);
+            out.push_back(*branch);
+            if (newExit)
+                out.push_back(TACInstruction(TACOpcode::LABEL, exitLabel));
+
+            report = "unrolled x" + std::to_string(factor) + " with exit tests (trip count unknown)";
+        }
+        else
+        {
+            if (options.logReport)
+            {
+                context.logger << "Loop unrolling: " << label << " skipped (body: " << bodySize
+                               << " instructions, trip count "
+                               << (trip > 0 ? std::to_string(trip) : std::string("unknown")) << ")" << std::endl;
+            }
+            continue;
+        }
+
+        size_t added = out.size() > instrs.size() ? out.size() - instrs.size() : 0;
+        if (growth + added > budget)
+        {
+            if (options.logReport)
+            {
+                context.logger << "Loop unrolling: " << label << " skipped (code-size budget of "
+                               << budget << " instructions exhausted)" << std::endl;
+            }
+            continue;
+        }
+        growth += added;
+
+        if (options.logReport)
+        {
+            context.logger << "Loop unrolling: " << label << " " << report << ", "
+                           << instrs.size() << " -> " << out.size() << " instructions" << std::endl;
+        }
+
+        replacements[block.id].swap(out);
+        replaced[block.id] = 1;
+        unrolled++;
+    }
+
+    if (unrolled == 0)
+        return 0;
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        if (replaced[i])
+            blocks[i].instructions.swap(replacements[i]);
+    }
+    tac = cfg.flatten();
+    return unrolled;
+}
@@ -2,14 +2,20 @@
 #include <fstream>
 #include <string>
 #include <chrono>
+#include <memory>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
-#include "../include/lexer.h"
-#include "../include/parser.h"
-#include "../include/tac.h"
-#include "../include/codegen.h"
-#include "../include/logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/tac_file.h"
+#include "../include/elf.h"
+#include "../include/tiered.h"
+#include "../include/range.h"
+#include "../include/files.h"
+#include "../include/cache.h"
+#include "../include/frontend_cache.h"
+#include "../include/taco.h"
 
 void printUsage(const char *program)
 {
@@ -19,13 +25,66 @@ void printUsage(const char *program)
     std::cout << "  -o <file>         Output executable file (default: output)\n";
     std::cout << "  --gen-c           Generate C code file (required for --c-only)\n";
     std::cout << "  --c-only          Generate only C code without compiling (implies --gen-c)\n";
+    std::cout << "  --goto-c          Emit C control flow as labels and goto instead of if/while/for\n";
+    std::cout << "  --flat-c          Emit one C statement per TAC instruction instead of nested expressions\n";
+    std::cout << "  --shards=<n>      Split C into n translation units of functions compiled by parallel gcc\n";
+    std::cout << "  --cache           Reuse executables gcc built from identical C (C backend)\n";
+    std::cout << "  --cache-dir=<dir> Cache directory (implies --cache; default: $TACO_CACHE_DIR,\n";
+    std::cout << "                    $XDG_CACHE_HOME/taco or ~/.cache/taco)\n";
+    std::cout << "  --cache-size=<mb> Cache size cap in MB, least recently used entries go first (default: 256)\n";
+    std::cout << "  --incremental     Reuse the parse and TAC of top-level statements unchanged since the\n";
+    std::cout << "                    last build of the file (kept in the cache directory)\n";
+    std::cout << "  --backend=<name>  Executable backend: elf (built-in, default on x86-64 Linux),\n";
+    std::cout << "                    asm (x86-64 assembly) or c\n";
+    std::cout << "  -S                Generate only x86-64 assembly (<output>.s; implies --backend=asm)\n";
+    std::cout << "  --run             Run the program in-process with the TAC interpreter (no C compiler)\n";
+    std::cout << "  --jit             Compile to x86-64 machine code in memory and run it\n";
+    std::cout << "  --tiered          Interpret, compiling hot loops to machine code as they run\n";
+    std::cout << "  --tier-threshold=<n>\n";
+    std::cout << "                    Loop back edges before --tiered compiles a loop (default: 1000)\n";
+    std::cout << "  --emit-tbc=<file> Write register bytecode (.tbc) instead of an executable\n";
+    std::cout << "  --emit-tac=<file> Write the TAC (.tacb, after -O passes) instead of an executable;\n";
+    std::cout << "                    a .tacb file is accepted as input in place of source\n";
+    std::cout << "  --exec <file.tbc> Run a bytecode file in the virtual machine\n";
+    std::cout << "  -O<level>         Optimization level 0-3 (-O is -O2)\n";
+    std::cout << "  --passes=<list>   Run a custom pass pipeline instead of a level preset\n";
+    std::cout << "                    Passes: partial-eval, rotate-loops, unroll-loops, simplify-cfg,\n";
+    std::cout << "                    algebraic, copy-prop, dce, ranges, alloc-temps;\n";
+    std::cout << "                    fixpoint(a,b,...) repeats a group\n";
+    std::cout << "  --fast-math       Allow optimizations that are not exact for NaN, infinities and -0\n";
+    std::cout << "  --unroll=<n>      Partial loop unrolling factor (default: 4, 1 disables)\n";
+    std::cout << "  --fuel=<n>        Instructions partial evaluation may run (default: 1000000, 0 disables)\n";
     std::cout << "  --log <options>   Enable logging with specified components (comma-separated)\n";
-    std::cout << "                    Options: tokens, ast, tac, timing, profile, all\n";
+    std::cout << "                    Options: tokens, ast, tac, opt, ranges, timing, profile, all\n";
     std::cout << "                    Example: --log tokens,ast or --log all\n";
     std::cout << "                    Log file: compilation_DDMMYYYY_HHMMSS.log\n";
     std::cout << "  --help            Show this help message\n\n";
 }
 
+// Write a generated file, reporting it the way the code generators did
+bool writeOutput(const std::string& filename, const std::string& contents, const std::string& what)
+{
+    if (!replaceFile(filename, contents, false))
+    {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    std::cout << what << " written to: " << filename << std::endl;
+    return true;
+}
+
+// Copy an executable built earlier from the same input out of the cache
+bool fetchExecutable(ExecutableCache* cache, const std::string& key, const std::string& outputFile, Logger& logger,
+                     std::string& cacheResult)
+{
+    if (!cache)
+        return false;
+    StageTimer timer(logger, "Executable Cache Lookup");
+    bool hit = cache->fetch(key, outputFile);
+    cacheResult = hit ? "hit" : "miss";
+    return hit;
+}
+
 int main(int argc, char *argv[])
 {
     if (argc < 2)
@@ -40,9 +99,32 @@ int main(int argc, char *argv[])
     bool logTAC = false;
     bool logTiming = false;
     bool cOnly = false;
+    bool runProgram = false;
+    bool jitProgram = false;
+    bool tieredProgram = false;
+    uint64_t tierThreshold = TieredExecutor::defaultThreshold;
+    std::string bytecodeFile;
+    std::string tacFile;
+    std::string execFile;
     bool generateC = false;
+    bool structuredC = true;
+    bool foldC = true;
+    size_t shardCount = 0;  // 0: one translation unit with a single main
+    bool useCache = false;
+    std::string cacheDirectory;
+    uint64_t cacheSizeMB = ExecutableCache::defaultCapacityMB;
+    bool incremental = false;
+    std::string backend;    // Empty: elf where supported, otherwise c
+    bool asmOnly = false;
     bool enableLogging = false;
     bool logProfiling = false;
+    bool logOptimization = false;
+    bool logRanges = false;
+    int optimizationLevel = 0;
+    std::string passList;
+    int unrollFactor = 4;
+    long partialEvalFuel = OptimizationOptions().partialEvalFuel;
+    bool fastMath = false;
     std::string outputFile = "output";
     std::string logFile = "";
     std::string inputFile;
@@ -65,6 +147,154 @@ int main(int argc, char *argv[])
             cOnly = true;
             generateC = true; // --c-only implies --gen-c
         }
+        else if (arg == "--goto-c")
+        {
+            structuredC = false;
+        }
+        else if (arg == "--flat-c")
+        {
+            foldC = false;
+        }
+        else if (arg.rfind("--shards=", 0) == 0)
+        {
+            std::string value = arg.substr(9);
+            if (value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != std::string::npos ||
+                std::stoul(value) < 1)
+            {
+                std::cerr << "Error: Invalid shard count '" << value << "' (expected a positive integer)\n";
+                return 1;
+            }
+            shardCount = std::stoul(value);
+        }
+        else if (arg == "--cache")
+        {
+            useCache = true;
+        }
+        else if (arg == "--incremental")
+        {
+            incremental = true;
+        }
+        else if (arg.rfind("--cache-dir=", 0) == 0)
+        {
+            cacheDirectory = arg.substr(12);
+            if (cacheDirectory.empty())
+            {
+                std::cerr << "Error: Empty cache directory\n";
+                return 1;
+            }
+            useCache = true;
+        }
+        else if (arg.rfind("--cache-size=", 0) == 0)
+        {
+            std::string value = arg.substr(13);
+            if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos ||
+                std::stoull(value) < 1)
+            {
+                std::cerr << "Error: Invalid cache size '" << value << "' (expected a positive number of MB)\n";
+                return 1;
+            }
+            cacheSizeMB = std::stoull(value);
+        }
+        else if (arg.rfind("--backend=", 0) == 0)
+        {
+            backend = arg.substr(10);
+            if (backend != "c" && backend != "asm" && backend != "elf")
+            {
+                std::cerr << "Error: Unknown backend '" << backend << "' (expected elf, asm or c)\n";
+                return 1;
+            }
+        }
+        else if (arg == "-S")
+        {
+            asmOnly = true;
+            backend = "asm";
+        }
+        else if (arg == "--run")
+        {
+            runProgram = true;
+        }
+        else if (arg == "--jit")
+        {
+            jitProgram = true;
+        }
+        else if (arg == "--tiered")
+        {
+            tieredProgram = true;
+        }
+        else if (arg.rfind("--tier-threshold=", 0) == 0)
+        {
+            std::string value = arg.substr(17);
+            if (value.empty() || value.size() > 18 || value.find_first_not_of("0123456789") != std::string::npos ||
+                std::stoull(value) < 1)
+            {
+                std::cerr << "Error: Invalid tier threshold '" << value << "' (expected a positive integer)\n";
+                return 1;
+            }
+            tierThreshold = std::stoull(value);
+        }
+        else if (arg.rfind("--emit-tbc=", 0) == 0)
+        {
+            bytecodeFile = arg.substr(11);
+            if (bytecodeFile.empty())
+            {
+                std::cerr << "Error: Missing file name in --emit-tbc\n";
+                return 1;
+            }
+        }
+        else if (arg.rfind("--emit-tac=", 0) == 0)
+        {
+            tacFile = arg.substr(11);
+            if (tacFile.empty())
+            {
+                std::cerr << "Error: Missing file name in --emit-tac\n";
+                return 1;
+            }
+        }
+        else if (arg == "--exec" && i + 1 < argc)
+        {
+            execFile = argv[++i];
+        }
+        else if (arg == "-O")
+        {
+            optimizationLevel = 2;
+        }
+        else if (arg.length() == 3 && arg.rfind("-O", 0) == 0)
+        {
+            if (arg[2] < '0' || arg[2] > '3')
+            {
+                std::cerr << "Error: Invalid optimization level '" << arg << "' (expected -O0 to -O3)\n";
+                return 1;
+            }
+            optimizationLevel = arg[2] - '0';
+        }
+        else if (arg.rfind("--passes=", 0) == 0)
+        {
+            passList = arg.substr(9);
+        }
+        else if (arg == "--fast-math")
+        {
+            fastMath = true;
+        }
+        else if (arg.rfind("--unroll=", 0) == 0)
+        {
+            std::string value = arg.substr(9);
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || std::stoi(value) < 1)
+            {
+                std::cerr << "Error: Invalid unroll factor '" << value << "' (expected a positive integer)\n";
+                return 1;
+            }
+            unrollFactor = std::stoi(value);
+        }
+        else if (arg.rfind("--fuel=", 0) == 0)
+        {
+            std::string value = arg.substr(7);
+            if (value.empty() || value.size() > 18 || value.find_first_not_of("0123456789") != std::string::npos)
+            {
+                std::cerr << "Error: Invalid fuel '" << value << "' (expected a non-negative integer)\n";
+                return 1;
+            }
+            partialEvalFuel = std::stol(value);
+        }
         else if (arg == "-o" && i + 1 < argc)
         {
             outputFile = argv[++i];
@@ -84,6 +314,8 @@ int main(int argc, char *argv[])
                     logTokens = true;
                     logAST = true;
                     logTAC = true;
+                    logOptimization = true;
+                    logRanges = true;
                     logTiming = true;
                     logProfiling = true;
                 }
@@ -99,6 +331,14 @@ int main(int argc, char *argv[])
                 {
                     logTAC = true;
                 }
+                else if (option == "opt")
+                {
+                    logOptimization = true;
+                }
+                else if (option == "ranges")
+                {
+                    logRanges = true;
+                }
                 else if (option == "timing")
                 {
                     logTiming = true;
@@ -109,7 +349,7 @@ int main(int argc, char *argv[])
                 }
                 else
                 {
-                    std::cerr << "Warning: Unknown log option '" << option << "' (valid: tokens, ast, tac, timing, profile, all)\n";
+                    std::cerr << "Warning: Unknown log option '" << option << "' (valid: tokens, ast, tac, opt, ranges, timing, profile, all)\n";
                 }
             }
         }
@@ -119,6 +359,76 @@ int main(int argc, char *argv[])
         }
     }
 
+    // The pipeline itself is libtaco's; the driver adds files, caches and reports.
+    // Everything this compilation logs and times goes to its context.
+    CompilationContext context;
+    Logger& logger = context.logger;
+    CompileOptions compileOptions;
+    compileOptions.optimizationLevel = optimizationLevel;
+    compileOptions.passList = passList;
+    compileOptions.optimization.logReport = logOptimization && enableLogging;
+    compileOptions.optimization.unrollFactor = unrollFactor;
+    compileOptions.optimization.fastMath = fastMath;
+    compileOptions.optimization.partialEvalFuel = partialEvalFuel;
+    compileOptions.structuredC = structuredC;
+    compileOptions.foldC = foldC;
+    TacoCompiler compiler(context, compileOptions);
+    bool optimize = compiler.optimizes();
+
+    if (backend.empty())
+        backend = generateC || shardCount > 0 || !TACO_NATIVE_ELF ? "c" : "elf";
+    if (backend == "elf" && !TACO_NATIVE_ELF)
+    {
+        std::cerr << "Error: The elf backend writes x86-64 Linux executables and needs an x86-64 Linux host\n";
+        return 1;
+    }
+    if (generateC && backend != "c")
+    {
+        std::cerr << "Error: --gen-c and --c-only need the C backend\n";
+        return 1;
+    }
+    if (shardCount > 0 && backend != "c")
+    {
+        std::cerr << "Error: --shards needs the C backend\n";
+        return 1;
+    }
+
+    // Only builds that run gcc on generated C go through the cache
+    std::unique_ptr<ExecutableCache> cache;
+    if (useCache && backend == "c" && !cOnly && !runProgram && !jitProgram && !tieredProgram &&
+        bytecodeFile.empty() && tacFile.empty() && execFile.empty())
+    {
+        cache.reset(new ExecutableCache(cacheDirectory.empty() ? ExecutableCache::defaultDirectory() : cacheDirectory,
+                                        cacheSizeMB * 1024 * 1024));
+        if (!cache->isUsable())
+            cache.reset();
+    }
+    std::string cacheResult;    // "hit" or "miss" once the cache was asked
+
+    // Check a custom pass pipeline before doing any work
+    {
+        std::string error;
+        if (!compiler.validate(error))
+        {
+            std::cerr << "Error: " << error << " in --passes\n";
+            return 1;
+        }
+    }
+
+    // Run precompiled bytecode: no source file and no compilation
+    if (!execFile.empty())
+    {
+        BytecodeProgram program;
+        std::string error;
+        if (!BytecodeProgram::load(execFile, program, error))
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        program.run(stdout);
+        return 0;
+    }
+
     if (inputFile.empty())
     {
         std::cerr << "Error: No input file specified\n";
@@ -128,11 +438,13 @@ int main(int argc, char *argv[])
 
     // Check file extension
     size_t dotPos = inputFile.find_last_of(".");
-    if (dotPos == std::string::npos || inputFile.substr(dotPos + 1) != "taco")
+    std::string extension = dotPos == std::string::npos ? "" : inputFile.substr(dotPos + 1);
+    if (extension != "taco" && extension != "tacb")
     {
-        std::cerr << "Error: Input file must have .taco extension\n";
+        std::cerr << "Error: Input file must have .taco or .tacb extension\n";
         return 1;
     }
+    bool fromTACFile = extension == "tacb";
 
     // Open log file if logging is enabled
     if (enableLogging)
@@ -171,239 +483,411 @@ int main(int argc, char *argv[])
         }
     }
 
-    // Read source file
-    std::ifstream sourceFile(inputFile);
-    if (!sourceFile.is_open())
+    std::vector<Token> tokens;
+    std::vector<std::unique_ptr<ASTNode>> ast;
+    std::unique_ptr<FrontEndCache> frontEndCache;
+    std::vector<TACInstruction> tac;
+    if (fromTACFile)
     {
-        std::cerr << "Error: Could not open file: " << inputFile << std::endl;
-        return 1;
+        // Start from TAC an earlier run wrote with --emit-tac
+        TACFile file;
+        std::string error;
+        bool opened;
+        {
+            StageTimer timer(logger, "TAC Loading");
+            opened = file.open(inputFile, error);
+            if (opened)
+                tac = file.toTAC();
+        }
+        if (!opened)
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        logger << "Loading: " << inputFile << " (" << file.getInstructionCount() << " instructions, "
+               << file.getSymbolCount() << " symbols, " << file.getConstantCount() << " constants)\n\n";
     }
-
-    std::string sourceCode;
-    std::string line;
-    while (std::getline(sourceFile, line))
+    else
     {
-        sourceCode += line + "\n";
+        // Read source file
+        std::ifstream sourceFile(inputFile);
+        if (!sourceFile.is_open())
+        {
+            std::cerr << "Error: Could not open file: " << inputFile << std::endl;
+            return 1;
+        }
+
+        std::string sourceCode;
+        std::string line;
+        while (std::getline(sourceFile, line))
+        {
+            sourceCode += line + "\n";
+        }
+        sourceFile.close();
+
+        logger << "Compiling: " << inputFile << "\n\n";
+
+        // 1. Lexical Analysis
+        std::vector<std::string> errors;
+        tokens = compiler.tokenize(sourceCode, errors);
+
+        if (logTokens)
+        {
+            logger << "=== TOKENS ===" << std::endl;
+            for (const auto &token : tokens)
+            {
+                if (token.type == TokenType::END_OF_FILE)
+                    break;
+                logger << "Line " << token.line << ":" << token.column
+                       << " - " << token.value << std::endl;
+            }
+            logger << std::endl;
+        }
+
+        // 2. Syntax Analysis (Parsing). Incrementally only the statements that
+        // changed since the last build are parsed, each by a parser of its own,
+        // so ast holds just those
+        if (incremental)
+        {
+            StageTimer timer(logger, "Syntax Analysis (Parsing)");
+            frontEndCache.reset(new FrontEndCache(context, cacheDirectory.empty() ? ExecutableCache::defaultDirectory()
+                                                                                  : cacheDirectory, inputFile));
+            frontEndCache->parse(tokens, ast, errors);
+        }
+        else
+        {
+            ast = compiler.parse(tokens, errors);
+        }
+
+        if (!errors.empty())
+        {
+            for (const auto& error : errors)
+                std::cerr << "Error: " << error << std::endl;
+            std::cerr << errors.size() << (errors.size() == 1 ? " error" : " errors") << " in " << inputFile
+                      << std::endl;
+            return 1;
+        }
+
+        // Print AST to logs if requested
+        if (logAST)
+        {
+            logger << "=== ABSTRACT SYNTAX TREE ===" << std::endl;
+            Parser printer(std::vector<Token>(), context);
+            for (const auto &statement : ast)
+            {
+                printer.printAST(statement.get(), 0, false);
+            }
+            logger << std::endl;
+        }
+
+        // 3. TAC Generation
+        if (frontEndCache)
+        {
+            {
+                StageTimer timer(logger, "TAC Generation");
+                tac = frontEndCache->generate(ast);
+            }
+
+            std::string error;
+            if (!frontEndCache->save(error))
+                std::cerr << "Warning: Could not save the front-end cache: " << error << std::endl;
+
+            size_t statements = frontEndCache->getStatementCount();
+            size_t reused = frontEndCache->getReusedCount();
+            std::ostringstream note;
+            note << "Front-end cache: " << reused << " of " << statements << " statements reused ("
+                 << std::fixed << std::setprecision(1) << (statements ? 100.0 * reused / statements : 0.0)
+                 << "%), saved ~" << std::setprecision(3) << frontEndCache->getSavedMilliseconds() << " ms";
+            logger.addTimingNote(note.str());
+        }
+        else
+        {
+            tac = compiler.generateTAC(ast);
+        }
     }
-    sourceFile.close();
 
-    if (enableLogging)
+    // Print TAC to logs if requested
+    TACGenerator tacGen(context);
+    if (logTAC)
     {
-        logger << "Compiling: " << inputFile << "\n\n";
+        tacGen.printTAC(tac, false);
+        logger << std::endl;
     }
 
-    // 1. Lexical Analysis
-    logger.startTimer();
-    if (logProfiling)
-        logger.startProfiling();
-    
-    std::vector<Token> tokens = lexing(sourceCode);
-    
-    if (logProfiling)
-        logger.endProfiling("Lexical Analysis");
-    logger.endTimer("Lexical Analysis");
-
-    if (logTokens && enableLogging)
+    // 3b. TAC Optimization (only with -O1 and above or --passes)
+    size_t unoptimizedSize = tac.size();
+    if (optimize)
     {
-        logger << "=== TOKENS ===" << std::endl;
-        for (const auto &token : tokens)
+        std::string error;
+        if (!compiler.optimize(tac, error))
         {
-            if (token.type == TokenType::END_OF_FILE)
-                break;
-            logger << "Line " << token.line << ":" << token.column
-                   << " - " << token.value << std::endl;
+            std::cerr << "Error: " << error << " in --passes\n";
+            return 1;
         }
+
+        if (logTAC)
+        {
+            tacGen.printTAC(tac, false, "OPTIMIZED THREE-ADDRESS CODE");
+            logger << std::endl;
+        }
+    }
+
+    // Print value ranges of the final TAC to logs if requested
+    if (logRanges)
+    {
+        RangeAnalysis ranges(tac);
+        ranges.print(tac, context);
         logger << std::endl;
     }
 
-    // 2. Syntax Analysis (Parsing)
-    logger.startTimer();
-    if (logProfiling)
-        logger.startProfiling();
-    
-    Parser parser(tokens);
-    auto ast = parser.parse();
-    
-    if (logProfiling)
-        logger.endProfiling("Syntax Analysis (Parsing)");
-    logger.endTimer("Syntax Analysis (Parsing)");
-
-    // Print AST to logs if requested
-    if (logAST && enableLogging)
+    // 4. Back end
+    std::string error;
+    std::string cacheKey;
+    if (runProgram)
     {
-        logger << "=== ABSTRACT SYNTAX TREE ===" << std::endl;
-        for (const auto &statement : ast)
+        // Run in-process instead of generating and compiling C
+        compiler.run(tac, stdout);
+    }
+    else if (jitProgram)
+    {
+        // Compile to machine code in memory and run it
+        JITCompiler jit;
+        if (!compiler.generateMachineCode(tac, jit, error))
         {
-            parser.printAST(statement.get(), 0, false);
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
         }
-        logger << std::endl;
+        compiler.runMachineCode(jit, stdout);
     }
-
-    // 3. TAC Generation
-    logger.startTimer();
-    if (logProfiling)
-        logger.startProfiling();
-    
-    TACGenerator tacGen;
-    std::vector<TACInstruction> tac = tacGen.generate(ast);
-    
-    if (logProfiling)
-        logger.endProfiling("TAC Generation");
-    logger.endTimer("TAC Generation");
-
-    // Print TAC to logs if requested
-    if (logTAC && enableLogging)
+    else if (tieredProgram)
     {
-        tacGen.printTAC(tac, false);
-        logger << std::endl;
+        // Interpret, switching hot loops to machine code
+        if (!compiler.runTiered(tac, tierThreshold, stdout, error))
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+    }
+    else if (!tacFile.empty())
+    {
+        // Stop after the front end and the TAC optimizer, for a later run to continue
+        bool saved;
+        {
+            StageTimer timer(logger, "TAC Writing");
+            saved = TACFile::save(tac, tacFile, error);
+        }
+        if (!saved)
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "TAC written to: " << tacFile << std::endl;
     }
+    else if (!bytecodeFile.empty())
+    {
+        // Compile to bytecode instead of C
+        BytecodeProgram program = compiler.generateBytecode(tac);
+        if (!program.save(bytecodeFile, error))
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "Bytecode written to: " << bytecodeFile << std::endl;
+    }
+    else if (backend == "elf")
+    {
+        // Write the executable directly, without a C compiler, assembler or linker
+        std::vector<uint8_t> image;
+        if (!compiler.generateExecutable(tac, image, error))
+        {
+            std::cerr << "Error: " << error << std::endl;
+            return 1;
+        }
+        if (!replaceFile(outputFile, std::string(image.begin(), image.end()), true))
+        {
+            std::cerr << "Error: Could not write executable: " << outputFile << std::endl;
+            return 1;
+        }
+    }
+    else if (backend == "asm")
+    {
+        // Generate assembly directly instead of C
+        std::string asmFilename = outputFile + (asmOnly ? ".s" : "_temp.s");
+        if (!writeOutput(asmFilename, compiler.generateAssembly(tac), "Assembly"))
+            return 1;
 
-    // 4. Code Generation (C) - only if --gen-c or --c-only flag is set
-    std::string cFilename;
-    if (generateC)
+        if (asmOnly)
+        {
+            logger << "\nAssembly generation successful!\n";
+            logger << "Output: " << asmFilename << std::endl;
+            std::cout << "Assembly generated: " << asmFilename << std::endl;
+        }
+        else if (compiler.assemble(asmFilename, outputFile))
+        {
+            std::remove(asmFilename.c_str());
+        }
+        else
+        {
+            logger << "\nExecutable creation failed!\n";
+            logger << "Assembly is available in: " << asmFilename << std::endl;
+            std::cerr << "Error: Failed to assemble executable" << std::endl;
+            return 1;
+        }
+    }
+    else if (shardCount > 0)
     {
-        logger.startTimer();
-        if (logProfiling)
-            logger.startProfiling();
-        
-        CCodeGenerator codeGen;
-        std::string cCode = codeGen.generate(tac);
+        std::vector<std::string> units = compiler.generateCShards(tac, shardCount);
 
-        cFilename = outputFile + ".c";
-        codeGen.writeToFile(cCode, cFilename);
-        
-        if (logProfiling)
-            logger.endProfiling("C Code Generation");
-        logger.endTimer("C Code Generation");
+        // Kept as <output>_<k>.c with --gen-c, removed after compiling otherwise
+        std::vector<std::string> cFilenames;
+        for (size_t k = 0; k < units.size(); k++)
+        {
+            cFilenames.push_back(outputFile + (generateC ? "_" : "_temp_") + std::to_string(k) + ".c");
+            if (!writeOutput(cFilenames.back(), units[k], "C code"))
+                return 1;
+        }
 
-        // Compile to executable (unless --c-only flag is set)
-        if (!cOnly)
+        if (cOnly)
         {
-            logger.startTimer();
-            if (logProfiling)
-                logger.startProfiling();
-            
-            if (codeGen.compileToExecutable(cFilename, outputFile))
-            {
-                if (logProfiling)
-                    logger.endProfiling("C to Executable Compilation");
-                logger.endTimer("C to Executable Compilation");
-                if (enableLogging)
-                {
-                    logger << "Compilation successful!\n";
-                    logger << "Executable: " << outputFile << std::endl;
-                }
-                std::cout << "Executable created: " << outputFile << std::endl;
-            }
-            else
+            logger << "\nC code generation successful!\n";
+            logger << "Output: " << cFilenames.size() << " files " << outputFile << "_<k>.c" << std::endl;
+            std::cout << "C code generated: " << cFilenames.size() << " translation units " << outputFile
+                      << "_0.c .. " << cFilenames.back() << std::endl;
+        }
+        else
+        {
+            if (cache)
+                cacheKey = cache->key(units, "gcc -c; gcc -lm");
+            bool built = fetchExecutable(cache.get(), cacheKey, outputFile, logger, cacheResult) ||
+                    compiler.compileCFiles(cFilenames, outputFile);
+            if (!built)
             {
-                if (logProfiling)
-                    logger.endProfiling("C to Executable Compilation");
-                logger.endTimer("C to Executable Compilation");
-                if (enableLogging)
-                {
-                    logger << "\nExecutable creation failed!\n";
-                    logger << "C code is available in: " << cFilename << std::endl;
-                }
+                logger << "\nExecutable creation failed!\n";
+                logger << "C code is available in: " << outputFile << "_*.c" << std::endl;
                 std::cerr << "Error: Failed to compile C code to executable" << std::endl;
                 return 1;
             }
-        }
-        else
-        {
-            if (enableLogging)
+            if (!generateC)
             {
-                logger << "\nC code generation successful!\n";
-                logger << "Output: " << cFilename << std::endl;
+                for (const auto& unitFilename : cFilenames)
+                    std::remove(unitFilename.c_str());
             }
-            std::cout << "C code generated: " << cFilename << std::endl;
         }
     }
-    else
+    else if (generateC)
     {
-        // Default behavior: compile directly to executable without saving C file
-        logger.startTimer();
-        if (logProfiling)
-            logger.startProfiling();
-        
-        CCodeGenerator codeGen;
-        std::string cCode = codeGen.generate(tac);
-
-        // Create temporary C file
-        cFilename = outputFile + "_temp.c";
-        codeGen.writeToFile(cCode, cFilename);
-        
-        if (logProfiling)
-            logger.endProfiling("C Code Generation");
-        logger.endTimer("C Code Generation");
-
-        logger.startTimer();
-        if (logProfiling)
-            logger.startProfiling();
-        
-        if (codeGen.compileToExecutable(cFilename, outputFile))
+        // Stream the C code into <output>.c
+        std::string cFilename = outputFile + ".c";
+        int fd = open(cFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Error: Could not open file " << cFilename << " for writing" << std::endl;
+            return 1;
+        }
+        bool written;
         {
-            // Remove temporary C file after successful compilation
-            std::remove(cFilename.c_str());
+            CodeWriter out(fd);
+            written = compiler.generateC(tac, out);
+        }
+        if (close(fd) != 0 || !written)
+        {
+            std::cerr << "Error: Could not write file " << cFilename << std::endl;
+            return 1;
+        }
+        std::cout << "C code written to: " << cFilename << std::endl;
 
-            if (logProfiling)
-                logger.endProfiling("C to Executable Compilation");
-            logger.endTimer("C to Executable Compilation");
-            if (enableLogging)
-            {
-                logger << "Compilation successful!\n";
-                logger << "Executable: " << outputFile << std::endl;
-            }
-            std::cout << "Compilation successful! Executable: " << outputFile << std::endl;
+        if (cOnly)
+        {
+            logger << "\nC code generation successful!\n";
+            logger << "Output: " << cFilename << std::endl;
+            std::cout << "C code generated: " << cFilename << std::endl;
         }
         else
         {
-            if (logProfiling)
-                logger.endProfiling("C to Executable Compilation");
-            logger.endTimer("C to Executable Compilation");
-            if (enableLogging)
+            if (cache)
+                cacheKey = cache->keyOfFiles({cFilename}, "gcc -lm");
+            bool built = fetchExecutable(cache.get(), cacheKey, outputFile, logger, cacheResult) ||
+                    compiler.compileCFile(cFilename, outputFile);
+            if (!built)
             {
                 logger << "\nExecutable creation failed!\n";
+                logger << "C code is available in: " << cFilename << std::endl;
+                std::cerr << "Error: Failed to compile C code to executable" << std::endl;
+                return 1;
             }
+        }
+    }
+    else
+    {
+        // Default behavior: stream the C code into gcc's stdin without a C file.
+        // With the cache the program is hashed before gcc is started, so it is
+        // generated in memory first
+        bool built;
+        if (cache)
+        {
+            std::string cCode = compiler.generateC(tac);
+            cacheKey = cache->key({cCode}, "gcc -lm");
+            built = fetchExecutable(cache.get(), cacheKey, outputFile, logger, cacheResult) ||
+                    compiler.compileC(cCode, outputFile);
+        }
+        else
+        {
+            built = compiler.compileC(tac, outputFile);
+        }
+        if (!built)
+        {
+            logger << "\nExecutable creation failed!\n";
             std::cerr << "Error: Compilation failed" << std::endl;
             return 1;
         }
     }
 
-    // Print summary - always show in console
-    std::cout << "\n=== COMPILATION SUMMARY ===" << std::endl;
-    std::cout << "Tokens: " << tokens.size() << std::endl;
-    std::cout << "AST nodes: " << ast.size() << std::endl;
-    std::cout << "TAC instructions: " << tac.size() << std::endl;
-    
-    // Print timing report - always show in console
-    logger.printTimingReportToConsole();
-    
-    // Print profiling report to console if enabled
-    if (logProfiling)
+    // A build that missed the cache leaves its executable there for the next one
+    if (cacheResult == "miss")
+        cache->store(cacheKey, outputFile);
+
+    bool executable = !runProgram && !jitProgram && !tieredProgram && tacFile.empty() && bytecodeFile.empty() &&
+                      !asmOnly && !cOnly;
+    if (executable)
     {
-        logger.printProfilingReportToConsole();
+        logger << "Compilation successful!\n";
+        logger << "Executable: " << outputFile << std::endl;
+        std::cout << "Compilation successful! Executable: " << outputFile << std::endl;
     }
-    
-    // Print summary and reports to log file if logging enabled
-    if (enableLogging)
+
+    // The summary is shown in the console (unless it shows the program output)
+    // and in the log
+    std::ostringstream summary;
+    summary << "\n=== COMPILATION SUMMARY ===" << std::endl;
+    summary << "Tokens: " << tokens.size() << std::endl;
+    summary << "AST nodes: " << (frontEndCache ? frontEndCache->getStatementCount() : ast.size()) << std::endl;
+    summary << "TAC instructions: " << unoptimizedSize << std::endl;
+    if (optimize)
+        summary << "TAC instructions (optimized): " << tac.size() << std::endl;
+    if (!cacheResult.empty())
     {
-        logger << "\n=== COMPILATION SUMMARY ===" << std::endl;
-        logger << "Tokens: " << tokens.size() << std::endl;
-        logger << "AST nodes: " << ast.size() << std::endl;
-        logger << "TAC instructions: " << tac.size() << std::endl;
+        summary << "Executable cache: " << cacheResult << " (" << cache->getHits() << " hits, "
+                << cache->getMisses() << " misses, " << cache->getEvictions() << " evictions; "
+                << cache->getEntryCount() << " entries, " << (cache->getTotalSize() + 1023) / 1024
+                << " KB of " << cache->getCapacity() / (1024 * 1024) << " MB in " << cache->getDirectory()
+                << ")" << std::endl;
+    }
 
-        // Print timing report to log if timing flag is set
+    if (!runProgram && !jitProgram && !tieredProgram)
+    {
+        std::cout << summary.str();
+        logger.printTimingReportToConsole();
+        if (logProfiling)
+            logger.printProfilingReportToConsole();
+    }
+
+    if (enableLogging)
+    {
+        logger << summary.str();
         if (logTiming)
-        {
             logger.printTimingReportToLog();
-        }
-        
-        // Print profiling report to log if enabled
         if (logProfiling)
-        {
             logger.printProfilingReportToLog();
-        }
 
         logger.close();
         std::cout << "\nCompilation complete. Log saved to: " << logFile << std::endl;
@@ -0,0 +1,272 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include "../include/optimizer.h"
+#include "../include/context.h"
+
+// Parse the numeric suffix of a generated name (t12 -> 12, L3 -> 3), or -1
+static int generatedNameIndex(const std::string& name, char prefix)
+{
+    if (name.length() < 2 || name[0] != prefix)
+        return -1;
+    for (size_t i = 1; i < name.length(); i++)
+    {
+        if (!isdigit(name[i]))
+            return -1;
+    }
+    return std::stoi(name.substr(1));
+}
+
+// Start numbering after the highest temporary and label already in use
+TACNameAllocator::TACNameAllocator(const std::vector<TACInstruction>& tac) : tempCounter(0), labelCounter(0)
+{
+    for (const auto& instr : tac)
+    {
+        for (const std::string* name : {&instr.result, &instr.arg1, &instr.arg2})
+        {
+            int temp = generatedNameIndex(*name, 't');
+            if (temp >= tempCounter)
+                tempCounter = temp + 1;
+            int label = generatedNameIndex(*name, 'L');
+            if (label >= labelCounter)
+                labelCounter = label + 1;
+        }
+    }
+}
+
+// Generate new temporary variable
+std::string TACNameAllocator::newTemp()
+{
+    return "t" + std::to_string(tempCounter++);
+}
+
+// Generate new label
+std::string TACNameAllocator::newLabel()
+{
+    return "L" + std::to_string(labelCounter++);
+}
+
+// Constructors
+TACOptimizer::TACOptimizer(CompilationContext& context) : context(context), options()
+{
+    setLevel(2);
+}
+
+TACOptimizer::TACOptimizer(CompilationContext& context, const OptimizationOptions& opts)
+    : context(context), options(opts)
+{
+    setLevel(2);
+}
+
+// Registered passes, by the name used in pipelines
+const std::vector<OptimizationPass>& TACOptimizer::registeredPasses()
+{
+    static const std::vector<OptimizationPass> passes = {
+        {"partial-eval", partiallyEvaluate, "Run the program at compile time and keep only its results"},
+        {"rotate-loops", rotateLoops, "Turn while/for loops into guarded do-while loops"},
+        {"unroll-loops", unrollLoops, "Unroll single-block loops"},
+        {"simplify-cfg", simplifyCFG, "Thread jumps, remove unreachable blocks and unused labels"},
+        {"algebraic", simplifyAlgebraic, "Fold constants and apply algebraic identities"},
+        {"copy-prop", propagateCopies, "Propagate copies within basic blocks"},
+        {"dce", eliminateDeadCode, "Remove assignments to temporaries that are never read"},
+        {"ranges", simplifyWithRanges, "Remove decided branches and propagate constants using value ranges"},
+        {"alloc-temps", allocateTemporaries, "Map temporaries onto reusable slots by liveness"},
+    };
+    return passes;
+}
+
+const OptimizationPass* TACOptimizer::findPass(const std::string& name)
+{
+    for (const auto& pass : registeredPasses())
+    {
+        if (name == pass.name)
+            return &pass;
+    }
+    return nullptr;
+}
+
+// Preset pipelines: -O1 only cleans up locally, -O2 first evaluates what it
+// can at compile time and adds loop transformations and range analysis, -O3
+// unrolls more aggressively. Every level ends by
+// packing temporaries into reusable slots.
+void TACOptimizer::setLevel(int level)
+{
+    std::string error;
+    pipeline.clear();
+
+    if (level == 1)
+        setPipeline("fixpoint(algebraic,copy-prop,dce,simplify-cfg),alloc-temps", error);
+    else if (level >= 2)
+        setPipeline("partial-eval,rotate-loops,unroll-loops,fixpoint(algebraic,copy-prop,dce,simplify-cfg,ranges),alloc-temps", error);
+
+    if (level >= 3)
+    {
+        OptimizationOptions defaults;
+        options.maxFullUnrollTrip = std::max(options.maxFullUnrollTrip, 4 * defaults.maxFullUnrollTrip);
+        options.maxUnrollBodySize = std::max(options.maxUnrollBodySize, 2 * defaults.maxUnrollBodySize);
+        options.maxUnrolledLoopSize = std::max(options.maxUnrolledLoopSize, 4 * defaults.maxUnrolledLoopSize);
+        options.maxUnrollGrowth = std::max(options.maxUnrollGrowth, 4 * defaults.maxUnrollGrowth);
+    }
+}
+
+// Parse a pipeline such as "rotate-loops,fixpoint(algebraic,dce)"
+bool TACOptimizer::setPipeline(const std::string& spec, std::string& error)
+{
+    std::vector<PipelineStep> steps;
+    size_t pos = 0;
+
+    auto parseName = [&]() {
+        size_t start = pos;
+        while (pos < spec.length() && spec[pos] != ',' && spec[pos] != '(' && spec[pos] != ')')
+            pos++;
+        return spec.substr(start, pos - start);
+    };
+
+    auto lookupPass = [&](const std::string& name) -> const OptimizationPass* {
+        const OptimizationPass* pass = findPass(name);
+        if (!pass)
+            error = "Unknown optimization pass '" + name + "'";
+        return pass;
+    };
+
+    while (pos < spec.length())
+    {
+        std::string name = parseName();
+        PipelineStep step;
+        step.fixpoint = false;
+
+        if (name == "fixpoint" && pos < spec.length() && spec[pos] == '(')
+        {
+            step.fixpoint = true;
+            pos++;
+            while (true)
+            {
+                const OptimizationPass* pass = lookupPass(parseName());
+                if (!pass)
+                    return false;
+                step.passes.push_back(pass);
+                if (pos < spec.length() && spec[pos] == ',')
+                {
+                    pos++;
+                    continue;
+                }
+                if (pos < spec.length() && spec[pos] == ')')
+                {
+                    pos++;
+                    break;
+                }
+                error = "Missing ')' after fixpoint group";
+                return false;
+            }
+        }
+        else
+        {
+            const OptimizationPass* pass = lookupPass(name);
+            if (!pass)
+                return false;
+            step.passes.push_back(pass);
+        }
+
+        steps.push_back(step);
+        if (pos < spec.length())
+        {
+            if (spec[pos] != ',')
+            {
+                error = "Unexpected '" + std::string(1, spec[pos]) + "' in pass list";
+                return false;
+            }
+            pos++;
+        }
+    }
+
+    pipeline = steps;
+    return true;
+}
+
+// Statistics entry of a pass, created on its first run
+PassStatistics& TACOptimizer::statisticsFor(const std::string& name)
+{
+    for (auto& stats : statistics)
+    {
+        if (stats.name == name)
+            return stats;
+    }
+    statistics.push_back(PassStatistics{name, 0, 0, 0, 0.0});
+    return statistics.back();
+}
+
+// Run one pass with its own timer and record what it did
+void TACOptimizer::runPass(const OptimizationPass& pass, std::vector<TACInstruction>& tac, int& changes)
+{
+    size_t before = tac.size();
+    auto start = std::chrono::high_resolution_clock::now();
+    context.logger.startTimer();
+
+    int passChanges = pass.run(tac, options, context);
+
+    context.logger.endTimer(pass.name);
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+
+    PassStatistics& stats = statisticsFor(pass.name);
+    stats.runs++;
+    stats.changes += passChanges;
+    stats.instructionDelta += static_cast<long>(tac.size()) - static_cast<long>(before);
+    stats.durationMs += duration.count();
+    changes += passChanges;
+
+    if (options.logReport && passChanges > 0)
+    {
+        context.logger << "[" << pass.name << "] " << before << " -> " << tac.size() << " instructions ("
+                       << passChanges << " changes)" << std::endl;
+    }
+}
+
+// Run the pipeline in order; fixpoint groups repeat until no pass changes the code
+void TACOptimizer::optimize(std::vector<TACInstruction>& tac)
+{
+    if (options.logReport)
+        context.logger << "=== OPTIMIZATION REPORT ===" << std::endl;
+
+    for (const auto& step : pipeline)
+    {
+        int iterations = 0;
+        while (true)
+        {
+            iterations++;
+            int changes = 0;
+            for (const OptimizationPass* pass : step.passes)
+                runPass(*pass, tac, changes);
+            if (!step.fixpoint || changes == 0 || iterations >= maxFixpointIterations)
+                break;
+        }
+
+        if (options.logReport && step.fixpoint)
+            context.logger << "Fixpoint reached after " << iterations << " iterations" << std::endl;
+    }
+
+    if (options.logReport)
+    {
+        printStatistics();
+        context.logger << std::endl;
+    }
+}
+
+// Per-pass table: runs, changes, instructions added or removed and time spent
+void TACOptimizer::printStatistics()
+{
+    context.logger << std::endl << "=== PASS STATISTICS ===" << std::endl;
+    context.logger << std::left << std::setw(16) << "Pass" << std::right << std::setw(6) << "Runs"
+                   << std::setw(10) << "Changes" << std::setw(14) << "Instructions" << std::setw(14) << "Time (ms)"
+                   << std::endl;
+
+    for (const auto& stats : statistics)
+    {
+        std::string delta = (stats.instructionDelta > 0 ? "+" : "") + std::to_string(stats.instructionDelta);
+        context.logger << std::left << std::setw(16) << stats.name << std::right << std::setw(6) << stats.runs
+                       << std::setw(10) << stats.changes << std::setw(14) << delta
+                       << std::setw(14) << std::fixed << std::setprecision(3) << stats.durationMs << std::endl;
+    }
+    context.logger << std::defaultfloat << std::setprecision(6);
+}
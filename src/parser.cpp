@@ -2,10 +2,11 @@
 #include <fstream>
 #include "../include/parser.h"
 #include "../include/lexer.h"
-#include "../include/logger.h"
+#include "../include/context.h"
 
 // Constructor
-Parser::Parser(const std::vector<Token> &tokens) : tokens(tokens), current(0) {}
+Parser::Parser(const std::vector<Token> &tokens, CompilationContext& context)
+    : tokens(tokens), current(0), logger(context.logger) {}
 
 // Peek at current token without consuming it
 Token Parser::peek()
@@ -42,6 +43,13 @@ bool Parser::match(TokenType type)
     return false;
 }
 
+// Record a syntax error and write it to the compilation's log
+void Parser::error(const std::string& message, int line)
+{
+    errors.push_back(message + " at line " + std::to_string(line));
+    logger << "Error: " << errors.back() << std::endl;
+}
+
 // Parse primary expressions (numbers, identifiers, and parenthesized expressions)
 std::unique_ptr<ASTNode> Parser::parsePrimary()
 {
@@ -55,7 +63,7 @@ std::unique_ptr<ASTNode> Parser::parsePrimary()
         
         if (!match(TokenType::RPAREN))
         {
-            logger << "Error: Expected ')' at line " << peek().line << std::endl;
+            error("Expected ')'", peek().line);
         }
         
         return expr;
@@ -72,7 +80,7 @@ std::unique_ptr<ASTNode> Parser::parsePrimary()
         return std::make_unique<IdentifierNode>(token.value);
     }
     
-    logger << "Error: Expected number or identifier at line " << token.line << std::endl;
+    error("Expected number or identifier", token.line);
     return nullptr;
 }
 
@@ -187,12 +195,12 @@ std::unique_ptr<ASTNode> Parser::parseAssignment()
         }
         else
         {
-            logger << "Error: Expected '=' after identifier at line " << token.line << std::endl;
+            error("Expected '=' after identifier", token.line);
             return nullptr;
         }
     }
     
-    logger << "Error: Expected identifier at line " << token.line << std::endl;
+    error("Expected identifier", token.line);
     return nullptr;
 }
 
@@ -203,7 +211,7 @@ std::unique_ptr<ASTNode> Parser::parsePrint()
     
     if (!match(TokenType::LPAREN))
     {
-        logger << "Error: Expected '(' after 'print' at line " << peek().line << std::endl;
+        error("Expected '(' after 'print'", peek().line);
         return nullptr;
     }
     
@@ -211,7 +219,7 @@ std::unique_ptr<ASTNode> Parser::parsePrint()
     
     if (!match(TokenType::RPAREN))
     {
-        logger << "Error: Expected ')' after expression at line " << peek().line << std::endl;
+        error("Expected ')' after expression", peek().line);
         return nullptr;
     }
     
@@ -226,7 +234,7 @@ std::unique_ptr<ASTNode> Parser::parseBlock()
 {
     if (!match(TokenType::LBRACE))
     {
-        logger << "Error: Expected '{' at line " << peek().line << std::endl;
+        error("Expected '{'", peek().line);
         return nullptr;
     }
     
@@ -248,7 +256,7 @@ std::unique_ptr<ASTNode> Parser::parseBlock()
     
     if (!match(TokenType::RBRACE))
     {
-        logger << "Error: Expected '}' at line " << peek().line << std::endl;
+        error("Expected '}'", peek().line);
         return nullptr;
     }
     
@@ -262,7 +270,7 @@ std::unique_ptr<ASTNode> Parser::parseIf()
     
     if (!match(TokenType::LPAREN))
     {
-        logger << "Error: Expected '(' after 'if' at line " << peek().line << std::endl;
+        error("Expected '(' after 'if'", peek().line);
         return nullptr;
     }
     
@@ -270,7 +278,7 @@ std::unique_ptr<ASTNode> Parser::parseIf()
     
     if (!match(TokenType::RPAREN))
     {
-        logger << "Error: Expected ')' after condition at line " << peek().line << std::endl;
+        error("Expected ')' after condition", peek().line);
         return nullptr;
     }
     
@@ -307,7 +315,7 @@ std::unique_ptr<ASTNode> Parser::parseWhile()
     
     if (!match(TokenType::LPAREN))
     {
-        logger << "Error: Expected '(' after 'while' at line " << peek().line << std::endl;
+        error("Expected '(' after 'while'", peek().line);
         return nullptr;
     }
     
@@ -315,7 +323,7 @@ std::unique_ptr<ASTNode> Parser::parseWhile()
     
     if (!match(TokenType::RPAREN))
     {
-        logger << "Error: Expected ')' after condition at line " << peek().line << std::endl;
+        error("Expected ')' after condition", peek().line);
         return nullptr;
     }
     
@@ -339,7 +347,7 @@ std::unique_ptr<ASTNode> Parser::parseFor()
     
     if (!match(TokenType::LPAREN))
     {
-        logger << "Error: Expected '(' after 'for' at line " << peek().line << std::endl;
+        error("Expected '(' after 'for'", peek().line);
         return nullptr;
     }
     
@@ -363,7 +371,7 @@ std::unique_ptr<ASTNode> Parser::parseFor()
     
     if (!match(TokenType::SEMICOLON))
     {
-        logger << "Error: Expected ';' after condition at line " << peek().line << std::endl;
+        error("Expected ';' after condition", peek().line);
         return nullptr;
     }
     
@@ -388,7 +396,7 @@ std::unique_ptr<ASTNode> Parser::parseFor()
     
     if (!match(TokenType::RPAREN))
     {
-        logger << "Error: Expected ')' after for clauses at line " << peek().line << std::endl;
+        error("Expected ')' after for clauses", peek().line);
         return nullptr;
     }
     
@@ -435,7 +443,7 @@ std::unique_ptr<ASTNode> Parser::parseStatement()
         return parseAssignment();
     }
     
-    logger << "Error: Expected statement at line " << token.line << std::endl;
+    error("Expected statement", token.line);
     return nullptr;
 }
 
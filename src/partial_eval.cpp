@@ -0,0 +1,295 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <unordered_map>
+#include "../include/optimizer.h"
+#include "../include/cfg.h"
+#include "../include/context.h"
+
+// TAC instruction with operands resolved to value slots and jumps to indices
+struct EvalInstruction
+{
+    TACOpcode opcode;
+    size_t result;
+    size_t arg1;
+    size_t arg2;
+    size_t target;
+};
+
+// Outcome of running the program at compile time
+struct EvalResult
+{
+    bool finished = false;          // Ran to the end of the program
+    size_t pc = 0;                  // Next instruction to execute if not finished
+    long steps = 0;                 // Instructions executed, not counting labels
+    std::vector<double> values;     // Value of every slot
+    std::vector<double> printed;    // Values printed so far
+    const char* stopReason = "";
+
+    // Last point outside of all loops, where the rest of the program may resume
+    size_t resumePc = 0;
+    long resumeSteps = 0;
+};
+
+// Interpreter over TAC with a fuel budget. Values are doubles computed
+// exactly as in the generated C, so printed results are identical.
+class PartialEvaluator
+{
+private:
+    std::vector<EvalInstruction> code;
+    std::vector<double> initialValues;      // Names start at 0, literals hold their value
+    std::vector<std::string> names;         // Name of every slot below names.size()
+    std::vector<char> resumable;            // Instruction lies outside every loop
+
+public:
+    PartialEvaluator(const std::vector<TACInstruction>& tac);
+
+    EvalResult run(long fuel, size_t maxPrints) const;
+    const std::vector<std::string>& getNames() const { return names; }
+};
+
+PartialEvaluator::PartialEvaluator(const std::vector<TACInstruction>& tac)
+{
+    std::unordered_map<std::string, size_t> slots;
+    std::unordered_map<std::string, size_t> literals;
+
+    // Names get the first slots so that the state is easy to read back
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        for (const std::string* operand : {&instr.result, &instr.arg1, &instr.arg2})
+        {
+            if (operand == &instr.result && !writesResult(instr.opcode))
+                continue;
+            if (!operand->empty() && !isNumericLiteral(*operand) && slots.emplace(*operand, names.size()).second)
+                names.push_back(*operand);
+        }
+    }
+    initialValues.assign(names.size() + 1, 0.0);
+    size_t unused = names.size();     // Read for missing operands
+
+    auto slotOf = [&](const std::string& operand) -> size_t {
+        if (operand.empty())
+            return unused;
+        if (!isNumericLiteral(operand))
+            return slots[operand];
+        auto it = literals.find(operand);
+        if (it != literals.end())
+            return it->second;
+        size_t slot = initialValues.size();
+        initialValues.push_back(std::strtod(operand.c_str(), nullptr));
+        literals[operand] = slot;
+        return slot;
+    };
+
+    std::unordered_map<std::string, size_t> labels;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        if (tac[i].opcode == TACOpcode::LABEL)
+            labels[tac[i].result] = i;
+    }
+
+    for (const auto& instr : tac)
+    {
+        EvalInstruction eval{instr.opcode, 0, 0, 0, tac.size()};
+        if (instr.opcode == TACOpcode::GOTO || instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+        {
+            auto it = labels.find(instr.result);
+            if (it != labels.end())
+                eval.target = it->second;
+        }
+        else if (writesResult(instr.opcode))
+        {
+            eval.result = slotOf(instr.result);
+        }
+        if (instr.opcode != TACOpcode::LABEL && instr.opcode != TACOpcode::GOTO)
+        {
+            eval.arg1 = slotOf(instr.arg1);
+            eval.arg2 = slotOf(instr.arg2);
+        }
+        code.push_back(eval);
+    }
+
+    // The program may only resume where no loop can jump back over the resume point
+    ControlFlowGraph cfg(tac);
+    std::vector<char> inLoop(cfg.getBlocks().size(), 0);
+    for (const auto& loop : cfg.findLoops())
+    {
+        for (int block : loop.blocks)
+            inLoop[block] = 1;
+    }
+    for (const auto& block : cfg.getBlocks())
+        resumable.insert(resumable.end(), block.instructions.size(), !inLoop[block.id]);
+}
+
+EvalResult PartialEvaluator::run(long fuel, size_t maxPrints) const
+{
+    EvalResult state;
+    state.values = initialValues;
+    std::vector<double>& v = state.values;
+
+    size_t pc = 0;
+    while (pc < code.size())
+    {
+        if (resumable[pc])
+        {
+            state.resumePc = pc;
+            state.resumeSteps = state.steps;
+        }
+        if (state.steps >= fuel)
+        {
+            state.stopReason = "fuel exhausted";
+            break;
+        }
+
+        const EvalInstruction& instr = code[pc];
+        double a = v[instr.arg1];
+        double b = v[instr.arg2];
+        double r = 0.0;
+        size_t next = pc + 1;
+
+        switch (instr.opcode)
+        {
+            case TACOpcode::ADD: r = a + b; break;
+            case TACOpcode::SUB: r = a - b; break;
+            case TACOpcode::MUL: r = a * b; break;
+            case TACOpcode::DIV: r = a / b; break;
+            case TACOpcode::ASSIGN: r = a; break;
+            case TACOpcode::LT: r = a < b; break;
+            case TACOpcode::GT: r = a > b; break;
+            case TACOpcode::LE: r = a <= b; break;
+            case TACOpcode::GE: r = a >= b; break;
+            case TACOpcode::EQ: r = a == b; break;
+            case TACOpcode::NE: r = a != b; break;
+            case TACOpcode::AND: r = a && b; break;
+            case TACOpcode::OR: r = a || b; break;
+            case TACOpcode::NOT: r = !a; break;
+            case TACOpcode::LABEL: break;
+            case TACOpcode::GOTO: next = instr.target; break;
+            case TACOpcode::IF_FALSE: if (!a) next = instr.target; break;
+            case TACOpcode::IF_TRUE: if (a) next = instr.target; break;
+            case TACOpcode::PRINT: r = a; break;
+        }
+
+        // Infinities and NaN have no literal form in TAC, so they end the
+        // part of the program that can be replaced by its results
+        if (writesResult(instr.opcode) || instr.opcode == TACOpcode::PRINT)
+        {
+            if (!std::isfinite(r))
+            {
+                state.stopReason = "non-finite value";
+                break;
+            }
+        }
+        if (instr.opcode == TACOpcode::PRINT)
+        {
+            if (state.printed.size() >= maxPrints)
+            {
+                state.stopReason = "print limit reached";
+                break;
+            }
+            state.printed.push_back(r);
+        }
+        else if (writesResult(instr.opcode))
+        {
+            v[instr.result] = r;
+        }
+
+        if (instr.opcode != TACOpcode::LABEL)
+            state.steps++;
+        pc = next;
+    }
+
+    state.finished = pc >= code.size();
+    state.pc = pc;
+    return state;
+}
+
+// Number of leading instructions that only print or assign literals, as left
+// by an earlier partial evaluation
+static size_t evaluatedPrefix(const std::vector<TACInstruction>& tac)
+{
+    size_t i = 0;
+    while (i < tac.size() && (tac[i].opcode == TACOpcode::PRINT || tac[i].opcode == TACOpcode::ASSIGN) &&
+           isNumericLiteral(tac[i].arg1))
+        i++;
+    if (i < tac.size() && tac[i].opcode == TACOpcode::GOTO)
+        i++;
+    return i;
+}
+
+// Run the program at compile time. If it finishes within the fuel budget it
+// is replaced by prints of its results; otherwise the part before the last
+// point outside of all loops is replaced by its prints and the values of all
+// names at that point, followed by a jump into the unchanged program.
+int partiallyEvaluate(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context)
+{
+    if (options.partialEvalFuel <= 0 || tac.empty())
+        return 0;
+
+    PartialEvaluator evaluator(tac);
+    EvalResult state = evaluator.run(options.partialEvalFuel, options.maxResidualPrints);
+    long totalSteps = state.steps;
+
+    // Evaluation is deterministic: replay up to the resume point for its state
+    if (!state.finished && state.resumeSteps < state.steps)
+    {
+        const char* reason = state.stopReason;
+        state = evaluator.run(state.resumeSteps, options.maxResidualPrints);
+        state.stopReason = reason;
+    }
+
+    if (state.steps <= static_cast<long>(evaluatedPrefix(tac)))
+    {
+        if (options.logReport)
+            context.logger << "Partial evaluation: nothing to specialize (" << state.stopReason << " after "
+                           << totalSteps << " steps)" << std::endl;
+        return 0;
+    }
+
+    std::vector<TACInstruction> residual;
+    for (double value : state.printed)
+        residual.push_back(TACInstruction(TACOpcode::PRINT, "", formatNumericLiteral(value)));
+
+    size_t assigned = 0;
+    if (!state.finished)
+    {
+        // Names hold 0 unless set; -0 is set explicitly
+        const auto& names = evaluator.getNames();
+        for (size_t slot = 0; slot < names.size(); slot++)
+        {
+            double value = state.values[slot];
+            if (value != 0.0 || std::signbit(value))
+            {
+                residual.push_back(TACInstruction(TACOpcode::ASSIGN, names[slot], formatNumericLiteral(value)));
+                assigned++;
+            }
+        }
+
+        TACNameAllocator allocator(tac);
+        std::string resume = allocator.newLabel();
+        residual.push_back(TACInstruction(TACOpcode::GOTO, resume));
+        residual.insert(residual.end(), tac.begin(), tac.begin() + state.pc);
+        residual.push_back(TACInstruction(TACOpcode::LABEL, resume));
+        residual.insert(residual.end(), tac.begin() + state.pc, tac.end());
+    }
+
+    if (options.logReport)
+    {
+        if (state.finished)
+            context.logger << "Partial evaluation: program finished after " << state.steps << " steps, "
+                           << state.printed.size() << " values printed (" << tac.size() << " -> "
+                           << residual.size() << " instructions)" << std::endl;
+        else
+            context.logger << "Partial evaluation: " << state.stopReason << " after " << totalSteps << " steps; "
+                           << state.steps << " steps specialized, " << state.printed.size() << " values printed, "
+                           << assigned << " names set, resuming at instruction " << state.pc << std::endl;
+    }
+
+    tac.swap(residual);
+    return static_cast<int>(std::min<long>(state.steps, INT_MAX));
+}
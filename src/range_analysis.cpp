@@ -0,0 +1,740 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include <sstream>
+#include "../include/range.h"
+#include "../include/context.h"
+
+static const double infinity = std::numeric_limits<double>::infinity();
+static const double maxExactInteger = 9007199254740992.0;     // 2^53
+static const int maxConstantWidenings = 8;
+
+// Bounds of inexact arithmetic move outward by one unit in the last place
+static double roundDown(double value, bool exact)
+{
+    if (std::isnan(value))
+        return -infinity;
+    return exact ? value : std::nextafter(value, -infinity);
+}
+
+static double roundUp(double value, bool exact)
+{
+    if (std::isnan(value))
+        return infinity;
+    return exact ? value : std::nextafter(value, infinity);
+}
+
+// Check if a bound was computed without rounding (error-free transformations)
+static bool isExactOperation(TACOpcode opcode, double x, double y, double result)
+{
+    if (!std::isfinite(result))
+        return std::isinf(x) || std::isinf(y);
+    if (result != 0.0 && std::fabs(result) < 1e-290)
+        return false;
+
+    switch (opcode)
+    {
+        case TACOpcode::ADD:
+        case TACOpcode::SUB:
+        {
+            double other = (opcode == TACOpcode::ADD) ? y : -y;
+            double otherPart = result - x;
+            double xPart = result - otherPart;
+            return (x - xPart) + (other - otherPart) == 0.0;
+        }
+        case TACOpcode::MUL:
+            return std::fma(x, y, -result) == 0.0;
+        case TACOpcode::DIV:
+            return std::fma(result, y, -x) == 0.0;
+        default:
+            return false;
+    }
+}
+
+// A negative result so small that it may round to -0
+static bool mayUnderflowToNegZero(double lo, double hi)
+{
+    return lo < 0.0 && hi > -std::numeric_limits<double>::denorm_min();
+}
+
+ValueRange::ValueRange() : lo(0.0), hi(0.0), integral(true), mayBeNaN(false), mayBeNegZero(false) {}
+
+ValueRange::ValueRange(double low, double high, bool isIntegral)
+    : lo(low), hi(high), integral(isIntegral), mayBeNaN(false), mayBeNegZero(false)
+{
+    if (!std::isfinite(lo) || !std::isfinite(hi))
+        integral = false;
+}
+
+ValueRange ValueRange::constant(double value)
+{
+    ValueRange range(value, value, std::isfinite(value) && std::floor(value) == value);
+    range.mayBeNaN = std::isnan(value);
+    range.mayBeNegZero = (value == 0.0 && std::signbit(value));
+    if (range.mayBeNaN)
+    {
+        range.lo = -infinity;
+        range.hi = infinity;
+    }
+    return range;
+}
+
+ValueRange ValueRange::unknown()
+{
+    ValueRange range(-infinity, infinity, false);
+    range.mayBeNaN = true;
+    range.mayBeNegZero = true;
+    return range;
+}
+
+// Result of a comparison or logical operator: 0 or 1
+ValueRange ValueRange::boolean(bool canBeTrue, bool canBeFalse)
+{
+    if (!canBeTrue && !canBeFalse)
+        return ValueRange(0.0, 1.0, true);
+    return ValueRange(canBeFalse ? 0.0 : 1.0, canBeTrue ? 1.0 : 0.0, true);
+}
+
+bool ValueRange::isExactInteger() const
+{
+    return integral && !mayBeNaN && !mayBeNegZero && lo >= -maxExactInteger && hi <= maxExactInteger;
+}
+
+ValueRange ValueRange::join(const ValueRange& other) const
+{
+    ValueRange range(std::min(lo, other.lo), std::max(hi, other.hi), integral && other.integral);
+    range.mayBeNaN = mayBeNaN || other.mayBeNaN;
+    range.mayBeNegZero = mayBeNegZero || other.mayBeNegZero;
+    return range;
+}
+
+bool ValueRange::operator==(const ValueRange& other) const
+{
+    return lo == other.lo && hi == other.hi && integral == other.integral &&
+           mayBeNaN == other.mayBeNaN && mayBeNegZero == other.mayBeNegZero;
+}
+
+std::string ValueRange::toString() const
+{
+    std::ostringstream oss;
+    if (isConstant())
+        oss << formatNumericLiteral(lo);
+    else
+        oss << "[" << formatNumericLiteral(lo) << ", " << formatNumericLiteral(hi) << "]";
+    if (integral)
+        oss << " integer";
+    if (mayBeNaN)
+        oss << " or NaN";
+    if (mayBeNegZero)
+        oss << " or -0";
+    return oss.str();
+}
+
+// Bounds of an operator applied to every pair of interval end points
+static ValueRange arithmeticRange(TACOpcode opcode, const ValueRange& a, const ValueRange& b)
+{
+    double lo = infinity;
+    double hi = -infinity;
+
+    auto addBound = [&](double x, double y, bool lower, bool upper) {
+        double value = 0.0;
+        switch (opcode)
+        {
+            case TACOpcode::ADD: value = x + y; break;
+            case TACOpcode::SUB: value = x - y; break;
+            case TACOpcode::MUL: value = x * y; break;
+            default: value = x / y; break;
+        }
+        // 0 * inf only occurs at the end points; the NaN is flagged by the caller
+        if (std::isnan(value))
+            value = 0.0;
+        bool exact = isExactOperation(opcode, x, y, value);
+        if (lower)
+            lo = std::min(lo, roundDown(value, exact));
+        if (upper)
+            hi = std::max(hi, roundUp(value, exact));
+    };
+
+    switch (opcode)
+    {
+        case TACOpcode::ADD:
+            addBound(a.lo, b.lo, true, false);
+            addBound(a.hi, b.hi, false, true);
+            break;
+        case TACOpcode::SUB:
+            addBound(a.lo, b.hi, true, false);
+            addBound(a.hi, b.lo, false, true);
+            break;
+        default:
+            addBound(a.lo, b.lo, true, true);
+            addBound(a.lo, b.hi, true, true);
+            addBound(a.hi, b.lo, true, true);
+            addBound(a.hi, b.hi, true, true);
+            break;
+    }
+
+    return ValueRange(lo, hi, a.integral && b.integral && opcode != TACOpcode::DIV);
+}
+
+// Range of the value an instruction computes from the ranges of its operands
+ValueRange RangeAnalysis::evaluate(const TACInstruction& instr, const ValueRange& a, const ValueRange& b) const
+{
+    switch (instr.opcode)
+    {
+        case TACOpcode::ASSIGN:
+            return a;
+
+        case TACOpcode::ADD:
+        {
+            ValueRange range = arithmeticRange(instr.opcode, a, b);
+            range.mayBeNaN = a.mayBeNaN || b.mayBeNaN || (a.hi == infinity && b.lo == -infinity) ||
+                             (a.lo == -infinity && b.hi == infinity);
+            range.mayBeNegZero = a.mayBeNegZero && b.mayBeNegZero;
+            return range;
+        }
+
+        case TACOpcode::SUB:
+        {
+            ValueRange range = arithmeticRange(instr.opcode, a, b);
+            range.mayBeNaN = a.mayBeNaN || b.mayBeNaN || (a.hi == infinity && b.hi == infinity) ||
+                             (a.lo == -infinity && b.lo == -infinity);
+            range.mayBeNegZero = a.mayBeNegZero && b.mayBeZero();
+            return range;
+        }
+
+        case TACOpcode::MUL:
+        {
+            ValueRange range = arithmeticRange(instr.opcode, a, b);
+            bool aInfinite = std::isinf(a.lo) || std::isinf(a.hi);
+            bool bInfinite = std::isinf(b.lo) || std::isinf(b.hi);
+            range.mayBeNaN = a.mayBeNaN || b.mayBeNaN || (a.mayBeZero() && bInfinite) || (b.mayBeZero() && aInfinite);
+            range.mayBeNegZero = (a.mayBeNegZero && b.hi > 0.0) || (b.mayBeNegZero && a.hi > 0.0) ||
+                                 (a.mayBeZero() && b.lo < 0.0) || (b.mayBeZero() && a.lo < 0.0) ||
+                                 (!range.integral && mayUnderflowToNegZero(range.lo, range.hi));
+            return range;
+        }
+
+        case TACOpcode::DIV:
+        {
+            bool aInfinite = std::isinf(a.lo) || std::isinf(a.hi);
+            bool bInfinite = std::isinf(b.lo) || std::isinf(b.hi);
+            if (b.mayBeZero() || (aInfinite && bInfinite))
+                return ValueRange::unknown();
+            ValueRange range = arithmeticRange(instr.opcode, a, b);
+            range.mayBeNaN = a.mayBeNaN || b.mayBeNaN;
+            range.mayBeNegZero = (a.mayBeNegZero && b.hi > 0.0) || (a.mayBeZero() && b.lo < 0.0) ||
+                                 mayUnderflowToNegZero(range.lo, range.hi);
+            return range;
+        }
+
+        case TACOpcode::LT:
+            return ValueRange::boolean(a.lo < b.hi, a.hi >= b.lo || a.mayBeNaN || b.mayBeNaN);
+        case TACOpcode::LE:
+            return ValueRange::boolean(a.lo <= b.hi, a.hi > b.lo || a.mayBeNaN || b.mayBeNaN);
+        case TACOpcode::GT:
+            return ValueRange::boolean(a.hi > b.lo, a.lo <= b.hi || a.mayBeNaN || b.mayBeNaN);
+        case TACOpcode::GE:
+            return ValueRange::boolean(a.hi >= b.lo, a.lo < b.hi || a.mayBeNaN || b.mayBeNaN);
+
+        case TACOpcode::EQ:
+        case TACOpcode::NE:
+        {
+            bool canBeEqual = a.lo <= b.hi && b.lo <= a.hi;
+            bool alwaysEqual = a.isConstant() && b.isConstant() && a.lo == b.lo;
+            if (instr.opcode == TACOpcode::EQ)
+                return ValueRange::boolean(canBeEqual, !alwaysEqual);
+            return ValueRange::boolean(!alwaysEqual, canBeEqual);
+        }
+
+        case TACOpcode::AND:
+            return ValueRange::boolean(a.mayBeNonZero() && b.mayBeNonZero(), a.mayBeZero() || b.mayBeZero());
+        case TACOpcode::OR:
+            return ValueRange::boolean(a.mayBeNonZero() || b.mayBeNonZero(), a.mayBeZero() && b.mayBeZero());
+        case TACOpcode::NOT:
+            return ValueRange::boolean(a.mayBeZero(), a.mayBeNonZero());
+
+        default:
+            return ValueRange::unknown();
+    }
+}
+
+// Range of an operand: literals are exact, names never assigned hold 0
+ValueRange RangeAnalysis::lookup(const State& state, const std::string& operand) const
+{
+    if (operand.empty())
+        return ValueRange();
+    if (isNumericLiteral(operand))
+        return ValueRange::constant(std::strtod(operand.c_str(), nullptr));
+
+    auto it = state.find(operand);
+    return it != state.end() ? it->second : ValueRange();
+}
+
+// Drop NaN and tighten integer bounds after a range was narrowed by a comparison
+static bool normalizeRefined(ValueRange& range)
+{
+    range.mayBeNaN = false;
+    if (range.integral)
+    {
+        range.lo = std::ceil(range.lo);
+        range.hi = std::floor(range.hi);
+    }
+    if (!range.mayBeZero())
+        range.mayBeNegZero = false;
+    return range.lo <= range.hi;
+}
+
+// Narrow a and b so that "a rel b" holds; false if it never can
+static bool applyRelation(TACOpcode relation, ValueRange& a, ValueRange& b)
+{
+    ValueRange left = a;
+    ValueRange right = b;
+
+    switch (relation)
+    {
+        case TACOpcode::GT:
+            return applyRelation(TACOpcode::LT, b, a);
+        case TACOpcode::GE:
+            return applyRelation(TACOpcode::LE, b, a);
+        case TACOpcode::LT:
+            a.hi = std::min(a.hi, (left.integral && std::isfinite(right.hi)) ? std::ceil(right.hi) - 1.0 : right.hi);
+            b.lo = std::max(b.lo, (right.integral && std::isfinite(left.lo)) ? std::floor(left.lo) + 1.0 : left.lo);
+            break;
+        case TACOpcode::LE:
+            a.hi = std::min(a.hi, right.hi);
+            b.lo = std::max(b.lo, left.lo);
+            break;
+        case TACOpcode::EQ:
+            a.lo = b.lo = std::max(left.lo, right.lo);
+            a.hi = b.hi = std::min(left.hi, right.hi);
+            a.integral = b.integral = (left.integral || right.integral) && std::isfinite(a.lo) && std::isfinite(a.hi);
+            break;
+        default:
+            break;
+    }
+
+    bool feasibleA = normalizeRefined(a);
+    bool feasibleB = normalizeRefined(b);
+    return feasibleA && feasibleB;
+}
+
+// Names holding the same value as an operand at the end of a block: the
+// operand itself and names it was copied to since it was last assigned
+static std::vector<std::string> copiesAtEnd(const std::vector<TACInstruction>& instructions, const std::string& operand)
+{
+    std::vector<std::string> copies;
+    if (isNumericLiteral(operand))
+        return copies;
+    copies.push_back(operand);
+
+    for (const auto& instr : instructions)
+    {
+        if (!writesResult(instr.opcode))
+            continue;
+        if (instr.result == operand)
+        {
+            copies.resize(1);
+            continue;
+        }
+        copies.erase(std::remove(copies.begin() + 1, copies.end(), instr.result), copies.end());
+        if (instr.opcode == TACOpcode::ASSIGN && instr.arg1 == operand)
+            copies.push_back(instr.result);
+    }
+    return copies;
+}
+
+// State along one edge of the block's final jump: the comparison deciding the
+// branch narrows its operands. Returns false if the edge can never be taken.
+bool RangeAnalysis::refine(const BasicBlock& block, const State& exitState, bool taken, State& edgeState) const
+{
+    // Names only used inside their block need not flow further
+    edgeState.clear();
+    for (const auto& entry : exitState)
+    {
+        if (crossBlockNames.find(entry.first) != crossBlockNames.end())
+            edgeState.insert(entry);
+    }
+
+    const TACInstruction* term = block.terminator();
+    if (!term || term->opcode == TACOpcode::GOTO)
+        return true;
+
+    bool conditionHolds = (term->opcode == TACOpcode::IF_TRUE) == taken;
+    const std::string& condition = term->arg1;
+
+    ValueRange value = lookup(exitState, condition);
+    if (conditionHolds ? !value.mayBeNonZero() : !value.mayBeZero())
+        return false;
+    if (isNumericLiteral(condition))
+        return true;
+
+    if (!conditionHolds)
+    {
+        value = ValueRange(0.0, 0.0, true);
+        value.mayBeNegZero = lookup(exitState, condition).mayBeNegZero;
+    }
+    else if (value.integral && value.lo >= 0.0 && value.hi <= 1.0)
+    {
+        value = ValueRange(1.0, 1.0, true);
+    }
+    if (crossBlockNames.count(condition))
+        edgeState[condition] = value;
+
+    // Find the comparison that computed the condition, with operands unchanged since
+    const auto& instructions = block.instructions;
+    size_t def = instructions.size() - 1;
+    while (def > 0 && instructions[def - 1].result != condition)
+        def--;
+    if (def == 0)
+        return true;
+    const TACInstruction& compare = instructions[--def];
+    if (compare.opcode < TACOpcode::LT || compare.opcode > TACOpcode::NE ||
+        compare.arg1 == condition || compare.arg2 == condition)
+        return true;
+    for (size_t i = def + 1; i + 1 < instructions.size(); i++)
+    {
+        if (writesResult(instructions[i].opcode) &&
+            (instructions[i].result == compare.arg1 || instructions[i].result == compare.arg2 ||
+             instructions[i].result == condition))
+            return true;
+    }
+
+    ValueRange a = lookup(exitState, compare.arg1);
+    ValueRange b = lookup(exitState, compare.arg2);
+
+    // Relation that holds on this edge; a false comparison says nothing if NaN is possible
+    TACOpcode relation = compare.opcode;
+    if (!conditionHolds)
+    {
+        bool unordered = a.mayBeNaN || b.mayBeNaN;
+        switch (compare.opcode)
+        {
+            case TACOpcode::LT: relation = TACOpcode::GE; break;
+            case TACOpcode::LE: relation = TACOpcode::GT; break;
+            case TACOpcode::GT: relation = TACOpcode::LE; break;
+            case TACOpcode::GE: relation = TACOpcode::LT; break;
+            case TACOpcode::NE: relation = TACOpcode::EQ; unordered = false; break;
+            default: return true;
+        }
+        if (unordered)
+            return true;
+    }
+    else if (compare.opcode == TACOpcode::NE)
+    {
+        return true;
+    }
+
+    if (!applyRelation(relation, a, b))
+        return false;
+    for (const std::string& name : copiesAtEnd(instructions, compare.arg1))
+    {
+        if (crossBlockNames.count(name))
+            edgeState[name] = a;
+    }
+    for (const std::string& name : copiesAtEnd(instructions, compare.arg2))
+    {
+        if (crossBlockNames.count(name))
+            edgeState[name] = b;
+    }
+    return true;
+}
+
+// Run the instructions of a block over a state, optionally recording ranges
+void RangeAnalysis::transfer(int block, State& state, bool record)
+{
+    const auto& instructions = cfg.getBlocks()[block].instructions;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        const TACInstruction& instr = instructions[i];
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+        {
+            if (record)
+                reached[blockStart[block] + i] = 1;
+            continue;
+        }
+
+        ValueRange a = lookup(state, instr.arg1);
+        ValueRange b = lookup(state, instr.arg2);
+        ValueRange result = writesResult(instr.opcode) ? evaluate(instr, a, b) : ValueRange();
+
+        if (record)
+        {
+            ranges[blockStart[block] + i] = InstructionRanges{a, b, result};
+            reached[blockStart[block] + i] = 1;
+        }
+        if (writesResult(instr.opcode))
+            state[instr.result] = result;
+    }
+
+}
+
+// Move a bound that keeps growing to the next widening point
+ValueRange RangeAnalysis::widen(const ValueRange& previous, const ValueRange& next, Widening widening) const
+{
+    static const std::vector<double> limits = {-maxExactInteger, maxExactInteger};
+    const std::vector<double>& points = (widening == Widening::CONSTANTS) ? thresholds : limits;
+
+    ValueRange range = next;
+    if (widening == Widening::NONE)
+        return range;
+    if (next.lo < previous.lo)
+    {
+        auto it = std::upper_bound(points.begin(), points.end(), next.lo);
+        range.lo = (it == points.begin()) ? -infinity : *(it - 1);
+    }
+    if (next.hi > previous.hi)
+    {
+        auto it = std::lower_bound(points.begin(), points.end(), next.hi);
+        range.hi = (it == points.end()) ? infinity : *it;
+    }
+    if (!std::isfinite(range.lo) || !std::isfinite(range.hi))
+        range.integral = false;
+    return range;
+}
+
+// Join an incoming state into a block entry state; true if it changed
+bool RangeAnalysis::mergeInto(State& target, const State& incoming, Widening widening) const
+{
+    bool changed = false;
+
+    auto mergeName = [&](const std::string& name) {
+        ValueRange previous = lookup(target, name);
+        ValueRange merged = previous.join(lookup(incoming, name));
+        merged = widen(previous, merged, widening);
+        if (merged != previous)
+        {
+            target[name] = merged;
+            changed = true;
+        }
+    };
+
+    for (const auto& entry : incoming)
+        mergeName(entry.first);
+    // Names assigned only on earlier paths are still 0 on this one
+    for (auto& entry : target)
+    {
+        if (incoming.find(entry.first) == incoming.end())
+        {
+            ValueRange merged = entry.second.join(ValueRange());
+            merged = widen(entry.second, merged, widening);
+            if (merged != entry.second)
+            {
+                entry.second = merged;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+// Block holding the instruction at an index
+int RangeAnalysis::blockOf(size_t index) const
+{
+    auto it = std::upper_bound(blockStart.begin(), blockStart.end(), index);
+    return static_cast<int>(it - blockStart.begin()) - 1;
+}
+
+bool RangeAnalysis::canBranch(size_t index) const
+{
+    return reached[index] && takenFeasible[blockOf(index)];
+}
+
+bool RangeAnalysis::canFallThrough(size_t index) const
+{
+    return reached[index] && fallThroughFeasible[blockOf(index)];
+}
+
+RangeAnalysis::RangeAnalysis(const std::vector<TACInstruction>& tac)
+    : cfg(tac), ranges(tac.size()), reached(tac.size(), 0)
+{
+    auto& blocks = cfg.getBlocks();
+    size_t count = blocks.size();
+    blockReached.assign(count, 0);
+    entryStates.assign(count, State());
+    takenFeasible.assign(count, 0);
+    fallThroughFeasible.assign(count, 0);
+    if (count == 0)
+        return;
+
+    size_t start = 0;
+    for (const auto& block : blocks)
+    {
+        blockStart.push_back(start);
+        start += block.instructions.size();
+    }
+
+    // Names read before being written in some block, and the widening points
+    std::set<double> points = {-maxExactInteger, -1.0, 0.0, 1.0, maxExactInteger};
+    for (const auto& block : blocks)
+    {
+        std::unordered_set<std::string> written;
+        for (const auto& instr : block.instructions)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            for (const std::string* operand : {&instr.arg1, &instr.arg2})
+            {
+                if (operand->empty())
+                    continue;
+                if (isNumericLiteral(*operand))
+                {
+                    double value = std::strtod(operand->c_str(), nullptr);
+                    if (std::isfinite(value))
+                        points.insert({value - 1.0, value, value + 1.0});
+                }
+                else if (written.find(*operand) == written.end())
+                {
+                    crossBlockNames.insert(*operand);
+                }
+            }
+            if (writesResult(instr.opcode))
+                written.insert(instr.result);
+        }
+    }
+    thresholds.assign(points.begin(), points.end());
+
+    std::vector<int> order = cfg.reversePostorder();
+    std::vector<int> rpoNumber(count, -1);
+    for (size_t i = 0; i < order.size(); i++)
+        rpoNumber[order[i]] = static_cast<int>(i);
+
+    // Successor edges of a block as (target, taken) pairs
+    auto edgesOf = [&](int b) {
+        std::vector<std::pair<int, bool>> edges;
+        const TACInstruction* term = blocks[b].terminator();
+        int next = (static_cast<size_t>(b) + 1 < count) ? b + 1 : -1;
+        if (!term)
+        {
+            if (next >= 0)
+                edges.push_back({next, false});
+        }
+        else
+        {
+            int target = cfg.blockForLabel(term->result);
+            if (target >= 0)
+                edges.push_back({target, true});
+            if (term->opcode != TACOpcode::GOTO && next >= 0)
+                edges.push_back({next, false});
+        }
+        return edges;
+    };
+
+    // Ascending iteration in reverse postorder, widening along retreating edges
+    std::vector<int> backMerges(count, 0);
+    std::set<int> worklist;
+    blockReached[0] = 1;
+    worklist.insert(0);
+    while (!worklist.empty())
+    {
+        int b = order[*worklist.begin()];
+        worklist.erase(worklist.begin());
+
+        State state = entryStates[b];
+        transfer(b, state, false);
+
+        for (const auto& edge : edgesOf(b))
+        {
+            State edgeState;
+            if (!refine(blocks[b], state, edge.second, edgeState))
+                continue;
+
+            int succ = edge.first;
+            bool retreating = rpoNumber[succ] <= rpoNumber[b];
+            // A few plain joins, then the constants of the program, then the limits
+            Widening widening = Widening::NONE;
+            if (retreating && ++backMerges[succ] > 2)
+                widening = (backMerges[succ] > 2 + maxConstantWidenings) ? Widening::LIMITS : Widening::CONSTANTS;
+            if (!blockReached[succ])
+            {
+                entryStates[succ] = edgeState;
+                blockReached[succ] = 1;
+                worklist.insert(rpoNumber[succ]);
+            }
+            else if (mergeInto(entryStates[succ], edgeState, widening))
+            {
+                worklist.insert(rpoNumber[succ]);
+            }
+        }
+    }
+
+    // Descending iterations recover bounds lost to widening
+    for (int sweep = 0; sweep < 2; sweep++)
+    {
+        std::vector<State> next(count);
+        std::vector<char> nextReached(count, 0);
+        nextReached[0] = 1;     // The entry state (every name 0) joins whatever reaches block 0
+        for (int b : order)
+        {
+            if (!blockReached[b])
+                continue;
+            State state = entryStates[b];
+            transfer(b, state, false);
+            for (const auto& edge : edgesOf(b))
+            {
+                State edgeState;
+                if (!refine(blocks[b], state, edge.second, edgeState))
+                    continue;
+                if (!nextReached[edge.first])
+                    next[edge.first] = edgeState;
+                else
+                    mergeInto(next[edge.first], edgeState, Widening::NONE);
+                nextReached[edge.first] = 1;
+            }
+        }
+        entryStates.swap(next);
+        blockReached.swap(nextReached);
+    }
+
+    // Record the final ranges and which branch edges can be taken
+    for (int b : order)
+    {
+        if (!blockReached[b])
+            continue;
+        State state = entryStates[b];
+        transfer(b, state, true);
+        State edgeState;
+        takenFeasible[b] = refine(blocks[b], state, true, edgeState);
+        fallThroughFeasible[b] = refine(blocks[b], state, false, edgeState);
+    }
+}
+
+// Log each instruction with the ranges of its named operands and its result
+void RangeAnalysis::print(const std::vector<TACInstruction>& tac, CompilationContext& context) const
+{
+    context.logger << "=== VALUE RANGES ===" << std::endl;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+        context.logger << (i + 1) << ": " << instr.toString();
+
+        if (!reached[i])
+        {
+            context.logger << "    (unreachable)" << std::endl;
+            continue;
+        }
+
+        std::string facts;
+        if (!isControlFlow(instr.opcode) || instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+        {
+            if (!instr.arg1.empty() && !isNumericLiteral(instr.arg1))
+                facts += instr.arg1 + ": " + ranges[i].arg1.toString();
+            if (!instr.arg2.empty() && !isNumericLiteral(instr.arg2) && instr.arg2 != instr.arg1)
+                facts += (facts.empty() ? "" : ", ") + instr.arg2 + ": " + ranges[i].arg2.toString();
+        }
+        if (writesResult(instr.opcode))
+            facts += (facts.empty() ? "" : " ") + std::string("=> ") + ranges[i].result.toString();
+        if (instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+        {
+            if (!canBranch(i))
+                facts += " (never jumps)";
+            else if (!canFallThrough(i))
+                facts += " (always jumps)";
+        }
+
+        if (!facts.empty())
+            context.logger << "    " << facts;
+        context.logger << std::endl;
+    }
+}
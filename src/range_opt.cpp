@@ -0,0 +1,96 @@
+#include <iostream>
+#include "../include/optimizer.h"
+#include "../include/range.h"
+#include "../include/context.h"
+
+// The single value a range describes; a zero that may be either +0 or -0 is not one
+static bool singleValue(const ValueRange& range, double& value)
+{
+    if (!range.isConstant() || (range.lo == 0.0 && range.mayBeNegZero))
+        return false;
+    value = range.lo;
+    return true;
+}
+
+// Use the value ranges of the program to drop branches that are never taken,
+// turn branches that are always taken into gotos, and replace names and
+// results that can only hold one value by that literal. Division by a name
+// known to be a constant thereby becomes division by a literal, which
+// algebraic simplification can turn into an exact multiplication.
+int simplifyWithRanges(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                       CompilationContext& context)
+{
+    RangeAnalysis ranges(tac);
+    int removedBranches = 0;
+    int fixedBranches = 0;
+    int replacedOperands = 0;
+    int foldedInstructions = 0;
+
+    std::vector<TACInstruction> result;
+    result.reserve(tac.size());
+
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        TACInstruction instr = tac[i];
+
+        // Unreachable code is left to CFG simplification
+        if (!ranges.isReachable(i) || instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+        {
+            result.push_back(instr);
+            continue;
+        }
+
+        if (instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+        {
+            if (!ranges.canBranch(i))
+            {
+                removedBranches++;
+                continue;
+            }
+            if (!ranges.canFallThrough(i))
+            {
+                result.push_back(TACInstruction(TACOpcode::GOTO, instr.result));
+                fixedBranches++;
+                continue;
+            }
+            result.push_back(instr);
+            continue;
+        }
+
+        const InstructionRanges& facts = ranges.at(i);
+        double value = 0.0;
+
+        if (writesResult(instr.opcode) && singleValue(facts.result, value) &&
+            !(instr.opcode == TACOpcode::ASSIGN && isNumericLiteral(instr.arg1)))
+        {
+            result.push_back(TACInstruction(TACOpcode::ASSIGN, instr.result, formatNumericLiteral(value)));
+            foldedInstructions++;
+            continue;
+        }
+
+        if (!instr.arg1.empty() && !isNumericLiteral(instr.arg1) && singleValue(facts.arg1, value))
+        {
+            instr.arg1 = formatNumericLiteral(value);
+            replacedOperands++;
+        }
+        if (!instr.arg2.empty() && !isNumericLiteral(instr.arg2) && singleValue(facts.arg2, value))
+        {
+            instr.arg2 = formatNumericLiteral(value);
+            replacedOperands++;
+        }
+        result.push_back(instr);
+    }
+
+    tac.swap(result);
+
+    int changes = removedBranches + fixedBranches + replacedOperands + foldedInstructions;
+    if (options.logReport && changes > 0)
+    {
+        context.logger << "Range simplification: " << removedBranches << " branches never taken removed, "
+                       << fixedBranches << " branches always taken made unconditional, "
+                       << foldedInstructions << " results and " << replacedOperands << " operands replaced by constants"
+                       << std::endl;
+    }
+
+    return changes;
+}
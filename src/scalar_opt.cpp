@@ -0,0 +1,141 @@
+#include <iostream>
+#include <unordered_map>
+#include "../include/optimizer.h"
+#include "../include/context.h"
+
+// Forget every definition
+void LocalDefinitions::clear()
+{
+    definitions.clear();
+    readers.clear();
+}
+
+// A name was assigned: its own definition and every definition reading it are stale
+void LocalDefinitions::kill(const std::string& name)
+{
+    definitions.erase(name);
+
+    auto it = readers.find(name);
+    if (it == readers.end())
+        return;
+
+    for (const auto& reader : it->second)
+    {
+        auto def = definitions.find(reader);
+        if (def != definitions.end() && (def->second.arg1 == name || def->second.arg2 == name))
+            definitions.erase(def);
+    }
+    readers.erase(it);
+}
+
+// Track the value an instruction assigns
+void LocalDefinitions::record(const TACInstruction& instr)
+{
+    if (!writesResult(instr.opcode))
+        return;
+
+    kill(instr.result);
+
+    // "x = x + 1" does not describe the new x in terms of itself
+    if (instr.arg1 == instr.result || instr.arg2 == instr.result)
+        return;
+
+    definitions.emplace(instr.result, instr);
+    if (!instr.arg1.empty() && !isNumericLiteral(instr.arg1))
+        readers[instr.arg1].push_back(instr.result);
+    if (!instr.arg2.empty() && !isNumericLiteral(instr.arg2))
+        readers[instr.arg2].push_back(instr.result);
+}
+
+// Definition of a name, if still valid
+const TACInstruction* LocalDefinitions::find(const std::string& name) const
+{
+    auto it = definitions.find(name);
+    return it != definitions.end() ? &it->second : nullptr;
+}
+
+// Replace uses of copied names within a basic block: after "a = b", reads of
+// a become reads of b until either is assigned again
+int propagateCopies(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                    CompilationContext& context)
+{
+    LocalDefinitions defs;
+    int replaced = 0;
+
+    auto substitute = [&](std::string& operand) {
+        if (operand.empty() || isNumericLiteral(operand))
+            return;
+        const TACInstruction* def = defs.find(operand);
+        if (def && def->opcode == TACOpcode::ASSIGN)
+        {
+            operand = def->arg1;
+            replaced++;
+        }
+    };
+
+    for (auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL)
+        {
+            defs.clear();
+            continue;
+        }
+
+        if (instr.opcode != TACOpcode::GOTO)
+        {
+            substitute(instr.arg1);
+            substitute(instr.arg2);
+        }
+
+        if (instr.opcode == TACOpcode::GOTO || instr.opcode == TACOpcode::IF_FALSE || instr.opcode == TACOpcode::IF_TRUE)
+            defs.clear();
+        else
+            defs.record(instr);
+    }
+
+    if (options.logReport && replaced > 0)
+        context.logger << "Copy propagation: " << replaced << " operands replaced" << std::endl;
+
+    return replaced;
+}
+
+// Remove assignments to temporaries that are never read. Expressions have no
+// side effects, so any such assignment can go.
+int eliminateDeadCode(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                      CompilationContext& context)
+{
+    int removed = 0;
+
+    while (true)
+    {
+        std::unordered_map<std::string, int> uses;
+        for (const auto& instr : tac)
+        {
+            if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+                continue;
+            if (!instr.arg1.empty())
+                uses[instr.arg1]++;
+            if (!instr.arg2.empty())
+                uses[instr.arg2]++;
+        }
+
+        std::vector<TACInstruction> live;
+        live.reserve(tac.size());
+        for (const auto& instr : tac)
+        {
+            if (writesResult(instr.opcode) && isTemporary(instr.result) && uses.find(instr.result) == uses.end())
+                continue;
+            live.push_back(instr);
+        }
+
+        if (live.size() == tac.size())
+            break;
+        removed += static_cast<int>(tac.size() - live.size());
+        tac.swap(live);
+    }
+
+    if (options.logReport && removed > 0)
+        context.logger << "Dead code elimination: " << removed << " instructions removed" << std::endl;
+
+    return removed;
+}
@@ -0,0 +1,272 @@
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/tac_file.h"
+#include "../include/files.h"
+
+static const char tacFileMagic[4] = {'T', 'A', 'C', 'B'};
+static const uint32_t tacFileVersion = 1;
+
+static size_t align8(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+// Offsets of the sections after the header
+struct TACFileLayout
+{
+    size_t constants;
+    size_t symbols;
+    size_t instructions;
+    size_t strings;
+    size_t end;
+
+    explicit TACFileLayout(const TACFileHeader& header)
+    {
+        constants = align8(sizeof(TACFileHeader));
+        symbols = align8(constants + size_t(header.constantCount) * sizeof(TACFileConstant));
+        instructions = align8(symbols + size_t(header.symbolCount) * sizeof(TACFileSymbol));
+        strings = align8(instructions + size_t(header.instructionCount) * sizeof(TACFileInstruction));
+        end = strings + header.stringBytes;
+    }
+};
+
+TACFile::TACFile()
+    : mapping(nullptr), mappingSize(0), header(nullptr), constants(nullptr), symbols(nullptr),
+      instructions(nullptr), strings(nullptr)
+{
+}
+
+TACFile::~TACFile()
+{
+    close();
+}
+
+void TACFile::close()
+{
+    if (mapping)
+        munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+}
+
+bool TACFile::save(const std::vector<TACInstruction>& tac, const std::string& filename, std::string& error)
+{
+    std::vector<TACFileConstant> constantTable;
+    std::vector<TACFileSymbol> symbolTable;
+    std::vector<TACFileInstruction> code;
+    std::string stringTable;
+    std::unordered_map<std::string, uint32_t> indices;     // Operand text to reference
+
+    auto reference = [&](const std::string& operand) -> uint32_t {
+        if (operand.empty())
+            return noOperand;
+        auto found = indices.find(operand);
+        if (found != indices.end())
+            return found->second;
+        uint32_t text = static_cast<uint32_t>(stringTable.size());
+        uint32_t length = static_cast<uint32_t>(operand.size());
+        stringTable += operand;
+        stringTable += '\0';
+        uint32_t index;
+        if (isNumericLiteral(operand))
+        {
+            index = static_cast<uint32_t>(constantTable.size()) | constantOperand;
+            constantTable.push_back({std::strtod(operand.c_str(), nullptr), text, length});
+        }
+        else
+        {
+            index = static_cast<uint32_t>(symbolTable.size());
+            symbolTable.push_back({text, length});
+        }
+        indices[operand] = index;
+        return index;
+    };
+
+    code.reserve(tac.size());
+    for (const auto& instr : tac)
+    {
+        code.push_back({static_cast<uint32_t>(instr.opcode), reference(instr.result), reference(instr.arg1),
+                        reference(instr.arg2)});
+    }
+    if (symbolTable.size() >= constantOperand || constantTable.size() >= constantOperand ||
+        stringTable.size() > UINT32_MAX)
+    {
+        error = "program too large for a TAC file";
+        return false;
+    }
+
+    TACFileHeader fileHeader;
+    std::memcpy(fileHeader.magic, tacFileMagic, sizeof(fileHeader.magic));
+    fileHeader.version = tacFileVersion;
+    fileHeader.instructionCount = static_cast<uint32_t>(code.size());
+    fileHeader.symbolCount = static_cast<uint32_t>(symbolTable.size());
+    fileHeader.constantCount = static_cast<uint32_t>(constantTable.size());
+    fileHeader.stringBytes = static_cast<uint32_t>(stringTable.size());
+    TACFileLayout layout(fileHeader);
+
+    // Built in memory so the padding between sections is zero
+    std::string data(layout.end, '\0');
+    std::memcpy(&data[0], &fileHeader, sizeof(fileHeader));
+    std::memcpy(&data[layout.constants], constantTable.data(), constantTable.size() * sizeof(TACFileConstant));
+    std::memcpy(&data[layout.symbols], symbolTable.data(), symbolTable.size() * sizeof(TACFileSymbol));
+    std::memcpy(&data[layout.instructions], code.data(), code.size() * sizeof(TACFileInstruction));
+    std::memcpy(&data[layout.strings], stringTable.data(), stringTable.size());
+
+    if (!replaceFile(filename, data, false))
+    {
+        error = "could not write " + filename;
+        return false;
+    }
+    return true;
+}
+
+bool TACFile::open(const std::string& filename, std::string& error)
+{
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "could not open " + filename;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TACFileHeader))
+    {
+        ::close(fd);
+        error = filename + " is not a TAC file";
+        return false;
+    }
+    mappingSize = static_cast<size_t>(info.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        error = "could not map " + filename;
+        return false;
+    }
+
+    header = static_cast<const TACFileHeader*>(mapping);
+    if (std::memcmp(header->magic, tacFileMagic, sizeof(header->magic)) != 0)
+    {
+        close();
+        error = filename + " is not a TAC file";
+        return false;
+    }
+    if (header->version != tacFileVersion)
+    {
+        error = "unsupported TAC file version " + std::to_string(header->version);
+        close();
+        return false;
+    }
+    TACFileLayout layout(*header);
+    if (layout.end != mappingSize)
+    {
+        close();
+        error = filename + " is truncated or has trailing data";
+        return false;
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    constants = reinterpret_cast<const TACFileConstant*>(base + layout.constants);
+    symbols = reinterpret_cast<const TACFileSymbol*>(base + layout.symbols);
+    instructions = reinterpret_cast<const TACFileInstruction*>(base + layout.instructions);
+    strings = base + layout.strings;
+    if (!validate(error))
+    {
+        error = filename + ": " + error;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Every string ends inside the string table, every operand names an entry
+bool TACFile::validate(std::string& error) const
+{
+    auto validText = [&](uint32_t text, uint32_t length) {
+        return size_t(text) + length < header->stringBytes && strings[text + length] == '\0';
+    };
+    for (uint32_t i = 0; i < header->constantCount; i++)
+    {
+        if (!validText(constants[i].text, constants[i].length))
+        {
+            error = "constant " + std::to_string(i) + " has a bad spelling";
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->symbolCount; i++)
+    {
+        if (!validText(symbols[i].text, symbols[i].length))
+        {
+            error = "symbol " + std::to_string(i) + " has a bad name";
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->instructionCount; i++)
+    {
+        const TACFileInstruction& instr = instructions[i];
+        if (instr.opcode > static_cast<uint32_t>(TACOpcode::PRINT))
+        {
+            error = "instruction " + std::to_string(i) + " has an unknown opcode";
+            return false;
+        }
+        for (uint32_t operand : {instr.result, instr.arg1, instr.arg2})
+        {
+            bool valid = operand == noOperand ||
+                         ((operand & constantOperand) ? (operand & ~constantOperand) < header->constantCount
+                                                      : operand < header->symbolCount);
+            if (!valid)
+            {
+                error = "instruction " + std::to_string(i) + " has an operand out of range";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const char* TACFile::operandText(uint32_t operand) const
+{
+    if (operand == noOperand)
+        return "";
+    if (operand & constantOperand)
+        return strings + constants[operand & ~constantOperand].text;
+    return strings + symbols[operand].text;
+}
+
+std::vector<TACInstruction> TACFile::toTAC() const
+{
+    // Each distinct operand is made a string once
+    std::vector<std::string> symbolNames(getSymbolCount());
+    for (size_t i = 0; i < symbolNames.size(); i++)
+        symbolNames[i].assign(strings + symbols[i].text, symbols[i].length);
+    std::vector<std::string> constantTexts(getConstantCount());
+    for (size_t i = 0; i < constantTexts.size(); i++)
+        constantTexts[i].assign(strings + constants[i].text, constants[i].length);
+    const std::string none;
+
+    auto operand = [&](uint32_t reference) -> const std::string& {
+        if (reference == noOperand)
+            return none;
+        if (reference & constantOperand)
+            return constantTexts[reference & ~constantOperand];
+        return symbolNames[reference];
+    };
+
+    std::vector<TACInstruction> tac;
+    tac.reserve(getInstructionCount());
+    for (size_t i = 0; i < getInstructionCount(); i++)
+    {
+        const TACFileInstruction& instr = instructions[i];
+        tac.emplace_back(static_cast<TACOpcode>(instr.opcode), operand(instr.result), operand(instr.arg1),
+                         operand(instr.arg2));
+    }
+    return tac;
+}
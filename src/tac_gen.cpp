@@ -1,8 +1,12 @@
 #include <iostream>
 #include <sstream>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include "../include/tac.h"
 #include "../include/parser.h"
-#include "../include/logger.h"
+#include "../include/context.h"
 
 // Convert TAC instruction to string
 std::string TACInstruction::toString() const
@@ -62,6 +66,9 @@ std::string TACInstruction::toString() const
         case TACOpcode::IF_FALSE:
             oss << "if !" << arg1 << " goto " << result;
             break;
+        case TACOpcode::IF_TRUE:
+            oss << "if " << arg1 << " goto " << result;
+            break;
         case TACOpcode::PRINT:
             oss << "print " << arg1;
             break;
@@ -72,8 +79,66 @@ std::string TACInstruction::toString() const
     return oss.str();
 }
 
+// Check if operand is a numeric literal (optionally negative)
+bool isNumericLiteral(const std::string& operand)
+{
+    if (operand.empty())
+        return false;
+    if (isdigit(operand[0]))
+        return true;
+    return operand[0] == '-' && operand.length() > 1 && isdigit(operand[1]);
+}
+
+// Check if operand is a compiler-generated temporary (t0, t1, ...)
+bool isTemporary(const std::string& operand)
+{
+    if (operand.length() < 2 || operand[0] != 't')
+        return false;
+    for (size_t i = 1; i < operand.length(); i++)
+    {
+        if (!isdigit(operand[i]))
+            return false;
+    }
+    return true;
+}
+
+// Check if opcode is a label or a jump
+bool isControlFlow(TACOpcode opcode)
+{
+    return opcode == TACOpcode::LABEL || opcode == TACOpcode::GOTO ||
+           opcode == TACOpcode::IF_FALSE || opcode == TACOpcode::IF_TRUE;
+}
+
+// Check if opcode assigns a value to its result operand
+bool writesResult(TACOpcode opcode)
+{
+    return !isControlFlow(opcode) && opcode != TACOpcode::PRINT;
+}
+
+// Shortest literal that reads back as exactly the same finite double
+std::string formatNumericLiteral(double value)
+{
+    char buffer[32];
+
+    // Integers are written out in full rather than with an exponent
+    if (value == static_cast<double>(static_cast<long long>(value)) && value > -1e17 && value < 1e17 &&
+        !(value == 0.0 && std::signbit(value)))
+    {
+        snprintf(buffer, sizeof(buffer), "%.0f", value);
+        return buffer;
+    }
+
+    for (int precision = 1; precision <= 17; precision++)
+    {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (strtod(buffer, nullptr) == value)
+            break;
+    }
+    return buffer;
+}
+
 // Constructor
-TACGenerator::TACGenerator() : tempCounter(0), labelCounter(0) {}
+TACGenerator::TACGenerator(CompilationContext& context) : context(context), tempCounter(0), labelCounter(0) {}
 
 // Generate new temporary variable
 std::string TACGenerator::newTemp()
@@ -337,25 +402,32 @@ void TACGenerator::generateStatement(const ASTNode* node)
 
 // Generate TAC from AST
 std::vector<TACInstruction> TACGenerator::generate(const std::vector<std::unique_ptr<ASTNode>>& ast)
+{
+    return generate(ast, 0, ast.size());
+}
+
+// Lower statements [first, first + count) as a program of their own
+std::vector<TACInstruction> TACGenerator::generate(const std::vector<std::unique_ptr<ASTNode>>& ast,
+                                                   size_t first, size_t count)
 {
     instructions.clear();
     tempCounter = 0;
     labelCounter = 0;
     
-    for (const auto& statement : ast)
+    for (size_t i = first; i < first + count; i++)
     {
-        generateStatement(statement.get());
+        generateStatement(ast[i].get());
     }
     
     return instructions;
 }
 
 // Print TAC
-void TACGenerator::printTAC(const std::vector<TACInstruction>& tac, bool toConsole)
+void TACGenerator::printTAC(const std::vector<TACInstruction>& tac, bool toConsole, const std::string& title)
 {
     if (toConsole)
     {
-        std::cout << "=== THREE-ADDRESS CODE ===" << std::endl;
+        std::cout << "=== " << title << " ===" << std::endl;
         int line = 1;
         for (const auto& instr : tac)
         {
@@ -364,11 +436,11 @@ void TACGenerator::printTAC(const std::vector<TACInstruction>& tac, bool toConso
     }
     else
     {
-        logger << "=== THREE-ADDRESS CODE ===" << std::endl;
+        context.logger << "=== " << title << " ===" << std::endl;
         int line = 1;
         for (const auto& instr : tac)
         {
-            logger << line++ << ": " << instr.toString() << std::endl;
+            context.logger << line++ << ": " << instr.toString() << std::endl;
         }
     }
 }
@@ -0,0 +1,274 @@
+#include "../include/taco.h"
+#include "../include/asmgen.h"
+#include "../include/elf.h"
+#include "../include/interpreter.h"
+#include "../include/tiered.h"
+
+TacoCompiler::TacoCompiler(CompilationContext& context, const CompileOptions& options)
+    : context(context), options(options) {}
+
+bool TacoCompiler::validate(std::string& error) const
+{
+    if (options.passList.empty())
+        return true;
+    TACOptimizer pipelineCheck(context);
+    return pipelineCheck.setPipeline(options.passList, error);
+}
+
+std::vector<Token> TacoCompiler::tokenize(const std::string& source, std::vector<std::string>& errors) const
+{
+    StageTimer timer(context.logger, "Lexical Analysis");
+    size_t first = errors.size();
+    std::vector<Token> tokens = lexing(source, errors);
+    for (size_t i = first; i < errors.size(); i++)
+        context.logger << "Error: " << errors[i] << std::endl;
+    return tokens;
+}
+
+std::vector<std::unique_ptr<ASTNode>> TacoCompiler::parse(const std::vector<Token>& tokens,
+                                                          std::vector<std::string>& errors) const
+{
+    StageTimer timer(context.logger, "Syntax Analysis (Parsing)");
+    Parser parser(tokens, context);
+    std::vector<std::unique_ptr<ASTNode>> ast = parser.parse();
+    errors.insert(errors.end(), parser.getErrors().begin(), parser.getErrors().end());
+    return ast;
+}
+
+std::vector<TACInstruction> TacoCompiler::generateTAC(const std::vector<std::unique_ptr<ASTNode>>& ast) const
+{
+    StageTimer timer(context.logger, "TAC Generation");
+    TACGenerator generator(context);
+    return generator.generate(ast);
+}
+
+bool TacoCompiler::optimize(std::vector<TACInstruction>& tac, std::string& error) const
+{
+    if (!optimizes())
+        return true;
+    StageTimer timer(context.logger, "TAC Optimization");
+    TACOptimizer optimizer(context, options.optimization);
+    optimizer.setLevel(options.optimizationLevel);
+    if (!options.passList.empty() && !optimizer.setPipeline(options.passList, error))
+        return false;
+    optimizer.optimize(tac);
+    return true;
+}
+
+bool TacoCompiler::compile(const std::string& source, std::vector<TACInstruction>& tac,
+                           std::vector<std::string>& errors) const
+{
+    std::vector<std::unique_ptr<ASTNode>> ast = parse(tokenize(source, errors), errors);
+    if (!errors.empty())
+        return false;
+    tac = generateTAC(ast);
+    std::string error;
+    if (!optimize(tac, error))
+    {
+        errors.push_back(error + " in the pass list");
+        return false;
+    }
+    return true;
+}
+
+void TacoCompiler::configure(CCodeGenerator& codeGen) const
+{
+    codeGen.setIntegerTyping(typesIntegers());
+    codeGen.setStructured(options.structuredC);
+    codeGen.setExpressionFolding(options.foldC);
+}
+
+// Log what the C generator made of the program (--log opt)
+void TacoCompiler::reportC(const CCodeGenerator& codeGen) const
+{
+    if (!options.optimization.logReport)
+        return;
+    Logger& logger = context.logger;
+    if (typesIntegers())
+    {
+        logger << "Type inference: " << codeGen.getIntegerNameCount() << " of " << codeGen.getNameCount()
+               << " variables declared as int64_t" << std::endl;
+    }
+    logger << "Control flow: " << codeGen.getLoopCount() << " loops, " << codeGen.getIfCount()
+           << " if statements, " << codeGen.getGotoCount() << " gotos" << std::endl;
+    logger << "Expressions: " << codeGen.getFoldedCount() << " instructions folded, "
+           << codeGen.getTemporaryCount() << " temporaries declared" << std::endl;
+}
+
+std::string TacoCompiler::generateC(const std::vector<TACInstruction>& tac) const
+{
+    StageTimer timer(context.logger, "C Code Generation");
+    CCodeGenerator codeGen;
+    configure(codeGen);
+    std::string cCode;
+    {
+        CodeWriter out(cCode);
+        codeGen.generate(tac, out);
+    }
+    reportC(codeGen);
+    return cCode;
+}
+
+bool TacoCompiler::generateC(const std::vector<TACInstruction>& tac, CodeWriter& out) const
+{
+    StageTimer timer(context.logger, "C Code Generation");
+    CCodeGenerator codeGen;
+    configure(codeGen);
+    codeGen.generate(tac, out);
+    reportC(codeGen);
+    return out.flush();
+}
+
+std::vector<std::string> TacoCompiler::generateCShards(const std::vector<TACInstruction>& tac, size_t count) const
+{
+    StageTimer timer(context.logger, "C Code Generation");
+    CCodeGenerator codeGen;
+    configure(codeGen);
+    std::vector<std::string> units = codeGen.generateShards(tac, count);
+    if (options.optimization.logReport)
+    {
+        context.logger << "Shards: " << units.size() << " translation units, " << codeGen.getFunctionCount()
+                       << " functions, " << codeGen.getSharedNameCount() << " shared names" << std::endl;
+    }
+    return units;
+}
+
+std::string TacoCompiler::generateAssembly(const std::vector<TACInstruction>& tac) const
+{
+    StageTimer timer(context.logger, "Assembly Generation");
+    AsmCodeGenerator asmGen;
+    std::string asmCode = asmGen.generate(tac);
+    if (options.optimization.logReport)
+    {
+        context.logger << "Register allocation: " << asmGen.getRegisterNameCount() << " of " << asmGen.getNameCount()
+                       << " names in SSE registers" << std::endl;
+    }
+    return asmCode;
+}
+
+bool TacoCompiler::generateExecutable(const std::vector<TACInstruction>& tac, std::vector<uint8_t>& image,
+                                      std::string& error) const
+{
+    StageTimer timer(context.logger, "ELF Generation");
+    ELFWriter writer;
+    if (!writer.build(tac, image, error))
+        return false;
+    context.logger << "ELF: " << writer.getTextSize() << " bytes of text (" << writer.getProgramSize()
+                   << " program, " << writer.getRuntimeSize() << " runtime), " << writer.getDataSize()
+                   << " bytes of data, " << writer.getBssSize() << " bytes of bss" << std::endl;
+    return true;
+}
+
+BytecodeProgram TacoCompiler::generateBytecode(const std::vector<TACInstruction>& tac) const
+{
+    StageTimer timer(context.logger, "Bytecode Generation");
+    BytecodeProgram program = BytecodeProgram::compile(tac);
+    context.logger << "Bytecode: " << program.getInstructionCount() << " instructions ("
+                   << program.getSuperinstructionCount() << " superinstructions), " << program.getRegisterCount()
+                   << " registers, " << program.getConstantCount() << " constants" << std::endl;
+    return program;
+}
+
+bool TacoCompiler::generateMachineCode(const std::vector<TACInstruction>& tac, JITCompiler& jit,
+                                       std::string& error) const
+{
+    StageTimer timer(context.logger, "JIT Compilation");
+    if (!jit.compile(tac, error))
+        return false;
+    context.logger << "JIT: " << jit.getCodeSize() << " bytes of machine code, " << jit.getSlotCount()
+                   << " value slots, " << jit.getFusedBranchCount() << " fused compare-branches" << std::endl;
+    return true;
+}
+
+void TacoCompiler::run(const std::vector<TACInstruction>& tac, FILE* out) const
+{
+    TACInterpreter interpreter(tac);
+    {
+        StageTimer timer(context.logger, "Interpretation");
+        interpreter.run(out);
+    }
+    context.logger << "Interpreted " << interpreter.getInstructionCount() << " instructions over "
+                   << interpreter.getSlotCount() << " value slots (" << interpreter.getNameCount() << " names)"
+                   << std::endl;
+}
+
+void TacoCompiler::runMachineCode(JITCompiler& jit, FILE* out) const
+{
+    StageTimer timer(context.logger, "Execution");
+    jit.run(out);
+}
+
+bool TacoCompiler::runTiered(const std::vector<TACInstruction>& tac, uint64_t threshold, FILE* out,
+                             std::string& error) const
+{
+    TieredExecutor executor(tac, threshold);
+    {
+        StageTimer timer(context.logger, "Tiered Execution");
+        if (!executor.run(out, error))
+            return false;
+    }
+    context.logger << "Tiered: " << executor.getCompiledLoopCount() << " of " << executor.getLoopCount()
+                   << " loops compiled (" << executor.getCodeSize() << " bytes in "
+                   << executor.getCompileMilliseconds() << " ms), " << executor.getTransferCount()
+                   << " entries into machine code" << std::endl;
+    return true;
+}
+
+// Generate the C program straight into gcc's stdin, without a C file
+bool TacoCompiler::compileC(const std::vector<TACInstruction>& tac, const std::string& executable) const
+{
+    CCodeGenerator codeGen;
+    configure(codeGen);
+    bool streamed = false;
+    {
+        StageTimer timer(context.logger, "C Code Generation");
+        int compilerInput = codeGen.startCompiler(executable);
+        if (compilerInput >= 0)
+        {
+            CodeWriter out(compilerInput);
+            codeGen.generate(tac, out);
+            streamed = out.flush();
+        }
+        reportC(codeGen);
+    }
+
+    // gcc has the whole program once its stdin is closed
+    StageTimer timer(context.logger, "C to Executable Compilation");
+    return codeGen.finishCompiler() && streamed;
+}
+
+bool TacoCompiler::compileC(const std::string& cCode, const std::string& executable) const
+{
+    StageTimer timer(context.logger, "C to Executable Compilation");
+    CCodeGenerator codeGen;
+    int compilerInput = codeGen.startCompiler(executable);
+    bool streamed = false;
+    if (compilerInput >= 0)
+    {
+        CodeWriter out(compilerInput);
+        out << cCode;
+        streamed = out.flush();
+    }
+    return codeGen.finishCompiler() && streamed;
+}
+
+bool TacoCompiler::compileCFile(const std::string& cFile, const std::string& executable) const
+{
+    StageTimer timer(context.logger, "C to Executable Compilation");
+    CCodeGenerator codeGen;
+    return codeGen.compileToExecutable(cFile, executable);
+}
+
+bool TacoCompiler::compileCFiles(const std::vector<std::string>& cFiles, const std::string& executable) const
+{
+    StageTimer timer(context.logger, "C to Executable Compilation");
+    CCodeGenerator codeGen;
+    return codeGen.compileShardsToExecutable(cFiles, executable);
+}
+
+bool TacoCompiler::assemble(const std::string& asmFile, const std::string& executable) const
+{
+    StageTimer timer(context.logger, "Assembling and Linking");
+    AsmCodeGenerator asmGen;
+    return asmGen.assembleToExecutable(asmFile, executable);
+}
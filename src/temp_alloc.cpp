@@ -0,0 +1,141 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <queue>
+#include "../include/optimizer.h"
+#include "../include/cfg.h"
+#include "../include/types.h"
+#include "../include/context.h"
+
+// Lifetime of a temporary in linear order. Instruction i reads at position 2i
+// and writes at 2i + 1, so a temporary last read by an instruction can share
+// a slot with the one it defines.
+struct LiveInterval
+{
+    size_t temp;
+    size_t start;
+    size_t end;
+};
+
+// Map temporaries onto a small set of reusable slots. Liveness over the CFG
+// gives each temporary a live interval; a linear scan then hands out slots,
+// reusing those whose temporary is dead. Integer and double temporaries get
+// separate slots so that slots keep the type inferred for their temporaries.
+int allocateTemporaries(std::vector<TACInstruction>& tac, const OptimizationOptions& options,
+                        CompilationContext& context)
+{
+    ControlFlowGraph cfg(tac);
+    const auto& blocks = cfg.getBlocks();
+    TemporaryLiveness liveness(cfg);
+    size_t tempCount = liveness.getTemporaryCount();
+    if (tempCount == 0)
+        return 0;
+    size_t words = (liveness.getGlobalCount() + 63) / 64;
+
+    // Live intervals: the hull of every position where a temporary is live
+    std::vector<LiveInterval> intervals(tempCount);
+    for (size_t t = 0; t < tempCount; t++)
+        intervals[t] = LiveInterval{t, SIZE_MAX, 0};
+
+    auto extend = [&](size_t t, size_t position) {
+        intervals[t].start = std::min(intervals[t].start, position);
+        intervals[t].end = std::max(intervals[t].end, position);
+    };
+
+    size_t index = 0;
+    for (const auto& block : blocks)
+    {
+        size_t first = index;
+        size_t last = index + block.instructions.size() - 1;
+        for (size_t w = 0; w < words; w++)
+        {
+            for (uint64_t bits = liveness.liveInSet(block.id)[w]; bits; bits &= bits - 1)
+                extend(64 * w + __builtin_ctzll(bits), 2 * first);
+            for (uint64_t bits = liveness.liveOutSet(block.id)[w]; bits; bits &= bits - 1)
+                extend(64 * w + __builtin_ctzll(bits), 2 * last + 1);
+        }
+        for (const auto& instr : block.instructions)
+        {
+            if (instr.opcode != TACOpcode::LABEL && instr.opcode != TACOpcode::GOTO)
+            {
+                for (const std::string* name : {&instr.arg1, &instr.arg2})
+                {
+                    if (isTemporary(*name))
+                        extend(liveness.indexOf(*name), 2 * index);
+                }
+                if (writesResult(instr.opcode) && isTemporary(instr.result))
+                    extend(liveness.indexOf(instr.result), 2 * index + 1);
+            }
+            index++;
+        }
+    }
+
+    // A temporary live on entry may be read before it is written and must
+    // keep its initial 0, so it gets a slot of its own
+    TemporaryLiveness::TempSet pinned = blocks.empty() ? TemporaryLiveness::TempSet(words, 0) : liveness.liveInSet(0);
+
+    TypeInfo types = inferTypes(tac);
+    std::sort(intervals.begin(), intervals.end(), [](const LiveInterval& a, const LiveInterval& b) {
+        return a.start < b.start || (a.start == b.start && a.temp < b.temp);
+    });
+
+    // Linear scan: active intervals ordered by end, free slots per type
+    typedef std::pair<size_t, size_t> ActiveSlot;     // (end, slot)
+    std::priority_queue<ActiveSlot, std::vector<ActiveSlot>, std::greater<ActiveSlot>> active;
+    std::vector<char> slotIsInteger;
+    std::vector<size_t> freeSlots[2];
+    std::vector<size_t> slotOf(tempCount);
+
+    for (const auto& interval : intervals)
+    {
+        while (!active.empty() && active.top().first < interval.start)
+        {
+            size_t slot = active.top().second;
+            freeSlots[slotIsInteger[slot] ? 1 : 0].push_back(slot);
+            active.pop();
+        }
+
+        bool integer = types.integerNames.count(liveness.temporary(interval.temp)) > 0;
+        std::vector<size_t>& pool = freeSlots[integer ? 1 : 0];
+        size_t slot;
+        if (!pool.empty() && !TemporaryLiveness::contains(pinned, interval.temp))
+        {
+            slot = pool.back();
+            pool.pop_back();
+        }
+        else
+        {
+            slot = slotIsInteger.size();
+            slotIsInteger.push_back(integer);
+        }
+        slotOf[interval.temp] = slot;
+
+        // Pinned slots are never handed out again
+        if (!TemporaryLiveness::contains(pinned, interval.temp))
+            active.push({interval.end, slot});
+    }
+
+    // Rename temporaries to their slots
+    auto rename = [&](std::string& name) {
+        if (isTemporary(name))
+            name = "t" + std::to_string(slotOf[liveness.indexOf(name)]);
+    };
+    for (auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        rename(instr.result);
+        rename(instr.arg1);
+        rename(instr.arg2);
+    }
+
+    size_t slots = slotIsInteger.size();
+    if (options.logReport)
+    {
+        size_t integerSlots = std::count(slotIsInteger.begin(), slotIsInteger.end(), 1);
+        context.logger << "Temporary allocation: " << tempCount << " temporaries -> " << slots << " slots ("
+                       << integerSlots << " integer, " << (slots - integerSlots) << " double)" << std::endl;
+    }
+
+    return static_cast<int>(tempCount - slots);
+}
@@ -0,0 +1,57 @@
+#include <chrono>
+#include "../include/tiered.h"
+
+// Back edges are only counted when hot loops can be compiled
+TieredExecutor::TieredExecutor(const std::vector<TACInstruction>& tac, uint64_t hotThreshold)
+    : tac(tac), interpreter(tac, JITCompiler::isSupported() ? hotThreshold : 0),
+      codeSize(0), transfers(0), compileMilliseconds(0)
+{
+    compiledLoops.resize(interpreter.getLoops().size());
+}
+
+size_t TieredExecutor::getCompiledLoopCount() const
+{
+    size_t count = 0;
+    for (const auto& loop : compiledLoops)
+    {
+        if (loop)
+            count++;
+    }
+    return count;
+}
+
+bool TieredExecutor::run(FILE* out, std::string& error)
+{
+    std::vector<double> values = interpreter.getLayout().getInitialValues();
+    PrintBuffer output(out);
+
+    size_t index = 0;
+    while (index < tac.size())
+    {
+        int hotLoop;
+        index = interpreter.resume(values, output, index, hotLoop);
+        if (hotLoop < 0)
+            break;
+
+        std::unique_ptr<JITCompiler>& compiled = compiledLoops[hotLoop];
+        if (!compiled)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            const TACInterpreter::LoopRegion& region = interpreter.getLoops()[hotLoop];
+            compiled.reset(new JITCompiler());
+            if (!compiled->compileRegion(tac, region.begin, region.header, region.end, interpreter.getLayout(), error))
+            {
+                compiled.reset();
+                return false;
+            }
+            codeSize += compiled->getCodeSize();
+            auto end = std::chrono::high_resolution_clock::now();
+            compileMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+        // Continue at the loop header in machine code
+        transfers++;
+        index = compiled->execute(values, output);
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+#include <cstdlib>
+#include "../include/types.h"
+#include "../include/range.h"
+
+bool TypeInfo::isInteger(const std::string& operand) const
+{
+    if (isNumericLiteral(operand))
+        return ValueRange::constant(std::strtod(operand.c_str(), nullptr)).isExactInteger();
+    return integerNames.find(operand) != integerNames.end();
+}
+
+// A name is an integer when all of its reachable definitions produce exact
+// integers; it starts out as 0, which is one
+TypeInfo inferTypes(const std::vector<TACInstruction>& tac)
+{
+    TypeInfo types;
+    RangeAnalysis ranges(tac);
+    types.integerResults.assign(tac.size(), 0);
+
+    std::unordered_set<std::string> doubleNames;
+    for (size_t i = 0; i < tac.size(); i++)
+    {
+        const TACInstruction& instr = tac[i];
+        if (!writesResult(instr.opcode))
+            continue;
+
+        // Unreachable code never runs, so it cannot store a non-integer
+        bool integer = !ranges.isReachable(i) || ranges.at(i).result.isExactInteger();
+        types.integerResults[i] = integer;
+        if (integer)
+            types.integerNames.insert(instr.result);
+        else
+            doubleNames.insert(instr.result);
+    }
+
+    for (const auto& name : doubleNames)
+        types.integerNames.erase(name);
+
+    // Names that are only read hold 0 throughout
+    for (const auto& instr : tac)
+    {
+        if (instr.opcode == TACOpcode::LABEL || instr.opcode == TACOpcode::GOTO)
+            continue;
+        for (const std::string* operand : {&instr.arg1, &instr.arg2})
+        {
+            if (!operand->empty() && !isNumericLiteral(*operand) && doubleNames.find(*operand) == doubleNames.end())
+                types.integerNames.insert(*operand);
+        }
+    }
+
+    return types;
+}
@@ -0,0 +1,120 @@
+#include "../include/bytecode.h"
+#include "../include/interpreter.h"
+
+// Bytecode instruction prepared for dispatch
+struct DispatchInstruction
+{
+    const void* handler;    // Handler address (threaded dispatch only)
+    BytecodeOp op;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+// Virtual machine loop over a validated program. Handler addresses are
+// filled in on entry, since labels as values are local to this function.
+static void execute(std::vector<DispatchInstruction>& code, double* R, const double* K, PrintBuffer& output)
+{
+#if TACO_THREADED_DISPATCH
+    static const void* const handlers[] = {
+#define TACO_BYTECODE_HANDLER(name, a, b, c) &&op_##name,
+        TACO_BYTECODE_OPERATIONS(TACO_BYTECODE_HANDLER)
+#undef TACO_BYTECODE_HANDLER
+    };
+    for (auto& instr : code)
+        instr.handler = handlers[static_cast<uint32_t>(instr.op)];
+#define HANDLER(name) op_##name
+#define DISPATCH() goto *ip->handler
+#else
+#define HANDLER(name) case BytecodeOp::name
+#define DISPATCH() goto dispatch
+#endif
+#define NEXT() do { ++ip; DISPATCH(); } while (0)
+#define JUMP_IF(condition) do { ip = (condition) ? start + ip->c : ip + 1; DISPATCH(); } while (0)
+
+    const DispatchInstruction* start = code.data();
+    const DispatchInstruction* ip = start;
+
+#if TACO_THREADED_DISPATCH
+    DISPATCH();
+#else
+dispatch:
+    switch (ip->op)
+    {
+#endif
+    HANDLER(HALT): return;
+    HANDLER(MOV): R[ip->a] = R[ip->b]; NEXT();
+    HANDLER(LOADK): R[ip->a] = K[ip->b]; NEXT();
+    HANDLER(ADD): R[ip->a] = R[ip->b] + R[ip->c]; NEXT();
+    HANDLER(ADDK): R[ip->a] = R[ip->b] + K[ip->c]; NEXT();
+    HANDLER(SUB): R[ip->a] = R[ip->b] - R[ip->c]; NEXT();
+    HANDLER(SUBK): R[ip->a] = R[ip->b] - K[ip->c]; NEXT();
+    HANDLER(KSUB): R[ip->a] = K[ip->c] - R[ip->b]; NEXT();
+    HANDLER(MUL): R[ip->a] = R[ip->b] * R[ip->c]; NEXT();
+    HANDLER(MULK): R[ip->a] = R[ip->b] * K[ip->c]; NEXT();
+    HANDLER(DIV): R[ip->a] = R[ip->b] / R[ip->c]; NEXT();
+    HANDLER(DIVK): R[ip->a] = R[ip->b] / K[ip->c]; NEXT();
+    HANDLER(KDIV): R[ip->a] = K[ip->c] / R[ip->b]; NEXT();
+    HANDLER(LT): R[ip->a] = R[ip->b] < R[ip->c]; NEXT();
+    HANDLER(LTK): R[ip->a] = R[ip->b] < K[ip->c]; NEXT();
+    HANDLER(LE): R[ip->a] = R[ip->b] <= R[ip->c]; NEXT();
+    HANDLER(LEK): R[ip->a] = R[ip->b] <= K[ip->c]; NEXT();
+    HANDLER(GT): R[ip->a] = R[ip->b] > R[ip->c]; NEXT();
+    HANDLER(GTK): R[ip->a] = R[ip->b] > K[ip->c]; NEXT();
+    HANDLER(GE): R[ip->a] = R[ip->b] >= R[ip->c]; NEXT();
+    HANDLER(GEK): R[ip->a] = R[ip->b] >= K[ip->c]; NEXT();
+    HANDLER(EQ): R[ip->a] = R[ip->b] == R[ip->c]; NEXT();
+    HANDLER(EQK): R[ip->a] = R[ip->b] == K[ip->c]; NEXT();
+    HANDLER(NE): R[ip->a] = R[ip->b] != R[ip->c]; NEXT();
+    HANDLER(NEK): R[ip->a] = R[ip->b] != K[ip->c]; NEXT();
+    HANDLER(AND): R[ip->a] = R[ip->b] && R[ip->c]; NEXT();
+    HANDLER(OR): R[ip->a] = R[ip->b] || R[ip->c]; NEXT();
+    HANDLER(NOT): R[ip->a] = !R[ip->b]; NEXT();
+    HANDLER(JMP): ip = start + ip->c; DISPATCH();
+    HANDLER(JT): JUMP_IF(R[ip->a]);
+    HANDLER(JF): JUMP_IF(!R[ip->a]);
+    HANDLER(JLT): JUMP_IF(R[ip->a] < R[ip->b]);
+    HANDLER(JLTK): JUMP_IF(R[ip->a] < K[ip->b]);
+    HANDLER(JLE): JUMP_IF(R[ip->a] <= R[ip->b]);
+    HANDLER(JLEK): JUMP_IF(R[ip->a] <= K[ip->b]);
+    HANDLER(JGT): JUMP_IF(R[ip->a] > R[ip->b]);
+    HANDLER(JGTK): JUMP_IF(R[ip->a] > K[ip->b]);
+    HANDLER(JGE): JUMP_IF(R[ip->a] >= R[ip->b]);
+    HANDLER(JGEK): JUMP_IF(R[ip->a] >= K[ip->b]);
+    HANDLER(JEQ): JUMP_IF(R[ip->a] == R[ip->b]);
+    HANDLER(JEQK): JUMP_IF(R[ip->a] == K[ip->b]);
+    HANDLER(JNE): JUMP_IF(R[ip->a] != R[ip->b]);
+    HANDLER(JNEK): JUMP_IF(R[ip->a] != K[ip->b]);
+    HANDLER(JNLT): JUMP_IF(!(R[ip->a] < R[ip->b]));
+    HANDLER(JNLTK): JUMP_IF(!(R[ip->a] < K[ip->b]));
+    HANDLER(JNLE): JUMP_IF(!(R[ip->a] <= R[ip->b]));
+    HANDLER(JNLEK): JUMP_IF(!(R[ip->a] <= K[ip->b]));
+    HANDLER(JNGT): JUMP_IF(!(R[ip->a] > R[ip->b]));
+    HANDLER(JNGTK): JUMP_IF(!(R[ip->a] > K[ip->b]));
+    HANDLER(JNGE): JUMP_IF(!(R[ip->a] >= R[ip->b]));
+    HANDLER(JNGEK): JUMP_IF(!(R[ip->a] >= K[ip->b]));
+    HANDLER(PRINT): output.print(R[ip->a]); NEXT();
+    HANDLER(PRINTK): output.print(K[ip->a]); NEXT();
+#if !TACO_THREADED_DISPATCH
+    case BytecodeOp::COUNT: return;
+    }
+#endif
+
+#undef HANDLER
+#undef DISPATCH
+#undef NEXT
+#undef JUMP_IF
+}
+
+// Run the program from a fresh register file
+void BytecodeProgram::run(FILE* out) const
+{
+    std::vector<DispatchInstruction> prepared;
+    prepared.reserve(code.size());
+    for (const auto& instr : code)
+        prepared.push_back(DispatchInstruction{nullptr, instr.op, instr.a, instr.b, instr.c});
+
+    std::vector<double> registers(size_t(registerCount) + 1, 0.0);
+    PrintBuffer output(out);
+    execute(prepared, registers.data(), constants.data(), output);
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Regression check: an executable fetched from the cache is a hard link to the
+# cache entry, so a later build to the same path must replace the file rather
+# than write through it and change the entry.
+# Usage: tests/cache_link.sh
+
+cd "$(dirname "$0")/.." || exit 1
+TACO=./taco
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+[ -x "$TACO" ] || make -s || exit 1
+
+echo "print(1);" > "$WORK/a.taco"
+echo "print(42);" > "$WORK/b.taco"
+CACHE="--backend=c --cache-dir=$WORK/cache"
+
+# A miss fills the cache, the second build of a is a hit linked to p2
+$TACO $CACHE "$WORK/a.taco" -o "$WORK/p1" > /dev/null || exit 1
+$TACO $CACHE "$WORK/a.taco" -o "$WORK/p2" > /dev/null || exit 1
+# Every backend that writes an executable or a program file overwrites p2
+for backend in "--backend=elf" "--backend=asm" "--backend=c" "--emit-tbc=$WORK/p2" "--emit-tac=$WORK/p2"; do
+    $TACO $backend "$WORK/b.taco" -o "$WORK/p2" > /dev/null 2>&1
+    $TACO $CACHE "$WORK/a.taco" -o "$WORK/p3" > /dev/null || exit 1
+    if [ "$("$WORK/p3")" != "1" ]; then
+        echo "FAIL: building to a cache hit's output with $backend changed the cache entry"
+        exit 1
+    fi
+    # Link p2 to the entry again for the next backend
+    $TACO $CACHE "$WORK/a.taco" -o "$WORK/p2" > /dev/null || exit 1
+done
+echo "PASS: cache entries survive builds to linked outputs"